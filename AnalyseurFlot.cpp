@@ -0,0 +1,477 @@
+#include "AnalyseurFlot.h"
+#include "SymboleValue.h"
+#include "Optimiseur.h"
+#include <algorithm>
+#include <climits>
+
+const unsigned int AnalyseurFlot::IMBRICATION_MAX = 5;
+
+AnalyseurFlot::AnalyseurFlot(Arene & arene, const TableSymboles & table, TableExpressions & expressions)
+: m_arene(arene), m_table(table), m_expressions(expressions), m_reecrire(false), m_essais(0), m_imbrication(0),
+  m_indefinies(), m_signalees(), m_sures(table.getTaille(), nullptr) {
+}
+
+vector<const SymboleValue*> AnalyseurFlot::lecturesIndefinies(Noeud* racine) {
+  m_reecrire = false;
+  Etat etat = etatInitial();
+  instruction(racine, etat);
+  return m_indefinies;
+}
+
+Noeud* AnalyseurFlot::rendreSur(Noeud* racine) {
+  m_reecrire = true;
+  Etat etat = etatInitial();
+  Noeud* resultat = instruction(racine, etat);
+  m_reecrire = false;
+  return resultat;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Etats
+////////////////////////////////////////////////////////////////////////////////
+
+bool AnalyseurFlot::Etat::operator==(const Etat & autre) const {
+  if (accessible != autre.accessible || definies != autre.definies || peutEtre != autre.peutEtre) return false;
+  for (unsigned int i = 0; i < valeurs.size(); i++)
+    if (valeurs[i].min != autre.valeurs[i].min || valeurs[i].max != autre.valeurs[i].max) return false;
+  return true;
+}
+
+AnalyseurFlot::Etat AnalyseurFlot::etatInitial() const {
+  unsigned int taille = m_table.getTaille();
+  return Etat{true, vector<bool>(taille, false), vector<bool>(taille, false), vector<Intervalle>(taille, Intervalle{0, 0})};
+}
+
+void AnalyseurFlot::joindre(Etat & etat, const Etat & autre) {
+  if (!autre.accessible) return;
+  if (!etat.accessible) {
+    etat = autre;
+    return;
+  }
+  for (unsigned int i = 0; i < etat.definies.size(); i++) {
+    if (autre.peutEtre[i] && etat.peutEtre[i]) {
+      etat.valeurs[i].min = min(etat.valeurs[i].min, autre.valeurs[i].min);
+      etat.valeurs[i].max = max(etat.valeurs[i].max, autre.valeurs[i].max);
+    } else if (autre.peutEtre[i]) etat.valeurs[i] = autre.valeurs[i];
+    etat.definies[i] = etat.definies[i] && autre.definies[i];
+    etat.peutEtre[i] = etat.peutEtre[i] || autre.peutEtre[i];
+  }
+}
+
+void AnalyseurFlot::elargir(Etat & etat, const Etat & precedent) {
+  if (!etat.accessible || !precedent.accessible) return;
+  for (unsigned int i = 0; i < etat.valeurs.size(); i++) {
+    if (!etat.peutEtre[i] || !precedent.peutEtre[i]) continue;
+    if (etat.valeurs[i].min < precedent.valeurs[i].min) etat.valeurs[i].min = INT_MIN;
+    if (etat.valeurs[i].max > precedent.valeurs[i].max) etat.valeurs[i].max = INT_MAX;
+  }
+}
+
+const SymboleValue* AnalyseurFlot::variableLue(const Noeud* noeud) const {
+  if (noeud->getGenre() == N_VARIABLESURE) noeud = ((const NoeudVariableSure*) noeud)->getVariable();
+  if (noeud->getGenre() != N_SYMBOLEVALUE) return nullptr;
+  const SymboleValue* variable = (const SymboleValue*) noeud;
+  if (*variable != J_VARIABLE || variable->getNumero() >= m_table.getTaille()) return nullptr;
+  return variable;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Intervalles et conditions
+////////////////////////////////////////////////////////////////////////////////
+
+static Jeton contraire(Jeton comparaison) { // non (a comparaison b)
+  switch (comparaison) {
+    case J_EGAL:          return J_DIFFERENT;
+    case J_DIFFERENT:     return J_EGAL;
+    case J_INFERIEUR:     return J_SUPERIEUREGAL;
+    case J_INFERIEUREGAL: return J_SUPERIEUR;
+    case J_SUPERIEUR:     return J_INFERIEUREGAL;
+    default:              return J_INFERIEUR;
+  }
+}
+
+static Jeton inverse(Jeton comparaison) { // a comparaison b équivaut à b inverse(comparaison) a
+  switch (comparaison) {
+    case J_INFERIEUR:     return J_SUPERIEUR;
+    case J_INFERIEUREGAL: return J_SUPERIEUREGAL;
+    case J_SUPERIEUR:     return J_INFERIEUR;
+    case J_SUPERIEUREGAL: return J_INFERIEUREGAL;
+    default:              return comparaison;
+  }
+}
+
+static bool estComparaison(Jeton operateur) {
+  return operateur == J_EGAL || operateur == J_DIFFERENT || operateur == J_INFERIEUR || operateur == J_INFERIEUREGAL
+          || operateur == J_SUPERIEUR || operateur == J_SUPERIEUREGAL;
+}
+
+AnalyseurFlot::Intervalle AnalyseurFlot::intervalle(const Noeud* expression, const Etat & etat) const {
+  static const Intervalle TOUT = { INT_MIN, INT_MAX };
+  // un calcul qui peut déborder "boucle" : son résultat peut alors tout valoir
+  auto borner = [](long long min, long long max) {
+    return min < INT_MIN || max > INT_MAX ? TOUT : Intervalle{(int) min, (int) max};
+  };
+  int valeur;
+  if (Optimiseur::estConstante(expression, valeur)) return Intervalle{valeur, valeur};
+  const SymboleValue* variable = variableLue(expression);
+  if (variable != nullptr) return etat.valeurs[variable->getNumero()];
+  switch (expression->getGenre()) {
+    case N_INVARIANT:
+      return intervalle(((const NoeudInvariant*) expression)->getExpression(), etat);
+    case N_OPERATEURUNAIRE: {
+      const NoeudOperateurUnaire* operation = (const NoeudOperateurUnaire*) expression;
+      Intervalle o = intervalle(operation->getOperande(), etat);
+      if (operation->getOperateur() == J_MOINS) return borner(-(long long) o.max, -(long long) o.min);
+      if (o.min > 0 || o.max < 0) return Intervalle{0, 0};
+      return o.min == 0 && o.max == 0 ? Intervalle{1, 1} : Intervalle{0, 1};
+    }
+    case N_OPERATEURBINAIRE: case N_DIVISIONSURE: {
+      const NoeudOperateurBinaire* operation = (const NoeudOperateurBinaire*) expression;
+      Intervalle g = intervalle(operation->getOperandeGauche(), etat);
+      Intervalle d = intervalle(operation->getOperandeDroit(), etat);
+      long long produits[4];
+      switch (operation->getOperateur()) {
+        case J_PLUS:  return borner((long long) g.min + d.min, (long long) g.max + d.max);
+        case J_MOINS: return borner((long long) g.min - d.max, (long long) g.max - d.min);
+        case J_MULTIPLICATION:
+          produits[0] = (long long) g.min * d.min; produits[1] = (long long) g.min * d.max;
+          produits[2] = (long long) g.max * d.min; produits[3] = (long long) g.max * d.max;
+          return borner(*min_element(produits, produits + 4), *max_element(produits, produits + 4));
+        case J_DIVISION: // d de signe constant : le quotient varie dans le même sens entre les bornes
+          if (d.min <= 0 && d.max >= 0) return TOUT;
+          produits[0] = (long long) g.min / d.min; produits[1] = (long long) g.min / d.max;
+          produits[2] = (long long) g.max / d.min; produits[3] = (long long) g.max / d.max;
+          return borner(*min_element(produits, produits + 4), *max_element(produits, produits + 4));
+        default: // comparaisons, et, ou
+          return Intervalle{0, 1};
+      }
+    }
+    default:
+      return TOUT;
+  }
+}
+
+void AnalyseurFlot::restreindre(const Noeud* variable, Jeton comparaison, Intervalle autre, Etat & etat) const {
+  unsigned int i = ((const SymboleValue*) variable)->getNumero();
+  if (!etat.accessible || !etat.peutEtre[i]) return; // sinon la lecture de la variable a déjà levé son exception
+  long long min = etat.valeurs[i].min, max = etat.valeurs[i].max;
+  switch (comparaison) {
+    case J_EGAL:
+      min = std::max(min, (long long) autre.min);
+      max = std::min(max, (long long) autre.max);
+      break;
+    case J_DIFFERENT: // seule une valeur au bord de l'intervalle peut en être ôtée
+      if (autre.min == autre.max && min == autre.min) min++;
+      if (autre.min == autre.max && max == autre.max) max--;
+      break;
+    case J_INFERIEUR:      max = std::min(max, (long long) autre.max - 1); break;
+    case J_INFERIEUREGAL:  max = std::min(max, (long long) autre.max); break;
+    case J_SUPERIEUR:      min = std::max(min, (long long) autre.min + 1); break;
+    case J_SUPERIEUREGAL:  min = std::max(min, (long long) autre.min); break;
+    default:               break;
+  }
+  if (min > max) etat.accessible = false; // la condition ne peut pas avoir cette valeur
+  else etat.valeurs[i] = Intervalle{(int) min, (int) max};
+}
+
+void AnalyseurFlot::restreindre(const Noeud* condition, bool vraie, Etat & etat) const {
+  if (!etat.accessible) return;
+  int valeur;
+  if (Optimiseur::estConstante(condition, valeur)) {
+    if ((valeur != 0) != vraie) etat.accessible = false;
+    return;
+  }
+  const SymboleValue* variable = variableLue(condition);
+  if (variable != nullptr) {
+    restreindre(variable, vraie ? J_DIFFERENT : J_EGAL, Intervalle{0, 0}, etat);
+    return;
+  }
+  if (condition->getGenre() == N_OPERATEURUNAIRE) {
+    const NoeudOperateurUnaire* operation = (const NoeudOperateurUnaire*) condition;
+    if (operation->getOperateur() == J_NON) restreindre(operation->getOperande(), !vraie, etat);
+    return;
+  }
+  if (condition->getGenre() != N_OPERATEURBINAIRE) return;
+  const NoeudOperateurBinaire* operation = (const NoeudOperateurBinaire*) condition;
+  const Noeud* g = operation->getOperandeGauche();
+  const Noeud* d = operation->getOperandeDroit();
+  Jeton operateur = operation->getOperateur();
+  if ((operateur == J_ET && vraie) || (operateur == J_OU && !vraie)) { // les deux opérandes ont été évalués
+    restreindre(g, vraie, etat);
+    marquerLues(d, etat);
+    restreindre(d, vraie, etat);
+  } else if (estComparaison(operateur)) {
+    Jeton comparaison = vraie ? operateur : contraire(operateur);
+    Intervalle ig = intervalle(g, etat), id = intervalle(d, etat);
+    if (variableLue(g) != nullptr) restreindre(variableLue(g), comparaison, id, etat);
+    if (variableLue(d) != nullptr) restreindre(variableLue(d), inverse(comparaison), ig, etat);
+  }
+}
+
+void AnalyseurFlot::marquerLues(const Noeud* expression, Etat & etat) const {
+  const SymboleValue* variable = variableLue(expression);
+  if (variable != nullptr) {
+    if (!etat.peutEtre[variable->getNumero()]) etat.accessible = false; // la lecture lève toujours son exception
+    else etat.definies[variable->getNumero()] = true;
+  } else if (expression->getGenre() == N_OPERATEURBINAIRE || expression->getGenre() == N_DIVISIONSURE) {
+    const NoeudOperateurBinaire* operation = (const NoeudOperateurBinaire*) expression;
+    marquerLues(operation->getOperandeGauche(), etat);
+    if (operation->getOperateur() != J_ET && operation->getOperateur() != J_OU) marquerLues(operation->getOperandeDroit(), etat);
+  } else if (expression->getGenre() == N_OPERATEURUNAIRE)
+    marquerLues(((const NoeudOperateurUnaire*) expression)->getOperande(), etat);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Expressions
+////////////////////////////////////////////////////////////////////////////////
+
+Noeud* AnalyseurFlot::expression(Noeud* noeud, Etat & etat) {
+  bool reecrire = m_reecrire && m_essais == 0;
+  switch (noeud->getGenre()) {
+    case N_SYMBOLEVALUE: {
+      const SymboleValue* variable = variableLue(noeud);
+      if (variable == nullptr || !etat.accessible) return noeud;
+      unsigned int i = variable->getNumero();
+      if (etat.definies[i]) {
+        if (!reecrire) return noeud;
+        if (m_sures[i] == nullptr) m_sures[i] = m_arene.creer<NoeudVariableSure>(noeud);
+        return m_sures[i];
+      }
+      if (!etat.peutEtre[i]) { // certainement indéfinie : cette lecture lève toujours son exception
+        if (m_essais == 0 && m_signalees.insert(noeud).second) m_indefinies.push_back(variable);
+        etat.accessible = false;
+        return noeud;
+      }
+      etat.definies[i] = true; // la suite n'est exécutée que si la lecture n'a pas levé d'exception
+      return noeud;
+    }
+    case N_OPERATEURBINAIRE: {
+      NoeudOperateurBinaire* operation = (NoeudOperateurBinaire*) noeud;
+      Jeton operateur = operation->getOperateur();
+      Noeud* g = expression(operation->getOperandeGauche(), etat);
+      Noeud* d;
+      if (operateur == J_ET || operateur == J_OU) { // l'opérande droit n'est évalué que si le gauche ne suffit pas :
+        Etat droit = etat;                           //  ses lectures ne rendent rien certainement défini après
+        restreindre(operation->getOperandeGauche(), operateur == J_ET, droit);
+        d = expression(operation->getOperandeDroit(), droit);
+      } else d = expression(operation->getOperandeDroit(), etat);
+      bool sure = false;
+      if (operateur == J_DIVISION && etat.accessible) {
+        Intervalle diviseur = intervalle(operation->getOperandeDroit(), etat);
+        sure = diviseur.min > 0 || diviseur.max < 0;
+        const SymboleValue* variable = variableLue(operation->getOperandeDroit());
+        if (variable != nullptr) restreindre(variable, J_DIFFERENT, Intervalle{0, 0}, etat); // sinon l'exception est levée
+      }
+      if (!reecrire) return noeud;
+      if (sure) return m_arene.creer<NoeudDivisionSure>(g, d);
+      if (g == operation->getOperandeGauche() && d == operation->getOperandeDroit()) return noeud;
+      return m_expressions.operation(operateur, g, d);
+    }
+    case N_OPERATEURUNAIRE: {
+      NoeudOperateurUnaire* operation = (NoeudOperateurUnaire*) noeud;
+      Noeud* o = expression(operation->getOperande(), etat);
+      if (o == operation->getOperande()) return noeud;
+      return m_expressions.operation(operation->getOperateur(), o);
+    }
+    case N_INVARIANT: {
+      // l'expression est calculée ici ou l'a été plus tôt, et ses variables n'ont pas changé depuis (invariant d'une
+      //  boucle, ou expression répétée dans une instruction) : après, ses lectures ont eu lieu sans exception
+      NoeudInvariant* invariant = (NoeudInvariant*) noeud;
+      Noeud* e = expression(invariant->getExpression(), etat);
+      if (e == invariant->getExpression()) return noeud;
+      return m_expressions.invariant(invariant->getTemporaire(), e);
+    }
+    default: // entiers, constantes, chaînes, temporaires
+      return noeud;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Instructions
+////////////////////////////////////////////////////////////////////////////////
+
+Noeud* AnalyseurFlot::boucle(Noeud* boucle, Noeud* condition, bool continuer, Noeud* & sequence, Noeud* & increment,
+                             Etat & etat) {
+  // l'état au début de chaque tour (avant la condition) réunit l'état avant la boucle et ceux à la fin des tours
+  Etat tete = etat;
+  m_imbrication++;
+  if (m_imbrication > IMBRICATION_MAX) { // trop de boucles imbriquées : pas d'essais, les variables modifiées peuvent tout valoir
+    set<const Noeud*> ecrites;
+    Optimiseur::variablesEcrites(boucle, ecrites);
+    for (const Noeud* ecrite : ecrites) {
+      const SymboleValue* variable = variableLue(ecrite);
+      if (variable == nullptr || !tete.accessible) continue;
+      tete.peutEtre[variable->getNumero()] = true;
+      tete.valeurs[variable->getNumero()] = Intervalle{INT_MIN, INT_MAX};
+    }
+  } else {
+    m_essais++;
+    for (;;) {
+      Etat tour = tete;
+      expression(condition, tour);
+      restreindre(condition, continuer, tour);
+      instruction(sequence, tour);
+      if (increment != nullptr) instruction(increment, tour);
+      Etat suivant = tete;
+      joindre(suivant, tour);
+      elargir(suivant, tete);
+      if (suivant == tete) break;
+      tete = suivant;
+    }
+    m_essais--;
+  }
+  // le point fixe atteint, un dernier tour réécrit la boucle et signale ses lectures indéfinies
+  Noeud* resultat = expression(condition, tete);
+  Etat corps = tete;
+  restreindre(condition, continuer, corps);
+  sequence = instruction(sequence, corps);
+  if (increment != nullptr) increment = instruction(increment, corps);
+  restreindre(condition, !continuer, tete);
+  etat = tete;
+  m_imbrication--;
+  return resultat;
+}
+
+Noeud* AnalyseurFlot::instruction(Noeud* noeud, Etat & etat) {
+  switch (noeud->getGenre()) {
+    case N_SEQINST: {
+      const vector<Noeud*> & instructions = ((NoeudSeqInst*) noeud)->getInstructions();
+      vector<Noeud*> sures;
+      bool change = false;
+      for (Noeud* i : instructions) {
+        sures.push_back(instruction(i, etat));
+        change = change || sures.back() != i;
+      }
+      if (!change) return noeud;
+      NoeudSeqInst* sequence = m_arene.creer<NoeudSeqInst>();
+      for (Noeud* i : sures) sequence->ajoute(i);
+      return sequence;
+    }
+    case N_AFFECTATION: {
+      NoeudAffectation* affectation = (NoeudAffectation*) noeud;
+      Intervalle valeur = intervalle(affectation->getExpression(), etat);
+      Noeud* e = expression(affectation->getExpression(), etat);
+      const SymboleValue* variable = variableLue(affectation->getVariable());
+      if (variable != nullptr && etat.accessible) {
+        etat.definies[variable->getNumero()] = true;
+        etat.peutEtre[variable->getNumero()] = true;
+        etat.valeurs[variable->getNumero()] = valeur;
+      }
+      if (e == affectation->getExpression()) return noeud;
+      return m_arene.creer<NoeudAffectation>(affectation->getVariable(), e);
+    }
+    case N_SI: { // après le si : ce qui est vrai après la séquence, ou quand la condition est fausse
+      NoeudInstSi* si = (NoeudInstSi*) noeud;
+      Noeud* c = expression(si->getCondition(), etat);
+      Etat alors = etat;
+      restreindre(si->getCondition(), true, alors);
+      Noeud* s = instruction(si->getSequence(), alors);
+      restreindre(si->getCondition(), false, etat);
+      joindre(etat, alors);
+      if (c == si->getCondition() && s == si->getSequence()) return noeud;
+      return m_arene.creer<NoeudInstSi>(c, s);
+    }
+    case N_SIRICHE: { // chaque condition n'est évaluée que si les précédentes sont fausses
+      NoeudInstSiRiche* siRiche = (NoeudInstSiRiche*) noeud;
+      const vector<Noeud*> & conditions = siRiche->getConditions();
+      const vector<Noeud*> & sequences = siRiche->getSequences();
+      vector<Noeud*> cs, ss;
+      Etat apres = etat;
+      apres.accessible = false;
+      bool sinon = false, change = false;
+      for (unsigned int i = 0; i < conditions.size(); i++) {
+        Etat branche;
+        if (conditions[i] == nullptr) {
+          sinon = true;
+          cs.push_back(nullptr);
+          branche = etat;
+        } else {
+          cs.push_back(expression(conditions[i], etat));
+          branche = etat;
+          restreindre(conditions[i], true, branche);
+          restreindre(conditions[i], false, etat);
+        }
+        ss.push_back(instruction(sequences[i], branche));
+        joindre(apres, branche);
+        change = change || cs.back() != conditions[i] || ss.back() != sequences[i];
+      }
+      if (!sinon) joindre(apres, etat);
+      etat = apres;
+      if (!change) return noeud;
+      return m_arene.creer<NoeudInstSiRiche>(cs, ss);
+    }
+    case N_AIGUILLAGE: { // la variable reste lue par l'aiguillage lui-même ; chaque séquence sait sa valeur
+      NoeudInstAiguillage* aiguillage = (NoeudInstAiguillage*) noeud;
+      const vector<int> & valeurs = aiguillage->getValeurs();
+      const vector<Noeud*> & sequences = aiguillage->getSequences();
+      expression(aiguillage->getVariable(), etat);
+      Etat apres = etat, autre = etat;
+      apres.accessible = false;
+      vector<Noeud*> ss;
+      bool change = false;
+      for (unsigned int i = 0; i < sequences.size(); i++) {
+        Etat branche = etat;
+        if (aiguillage->choisir(valeurs[i]) != i) branche.accessible = false; // valeur en double : jamais choisie
+        else restreindre(aiguillage->getVariable(), J_EGAL, Intervalle{valeurs[i], valeurs[i]}, branche);
+        restreindre(aiguillage->getVariable(), J_DIFFERENT, Intervalle{valeurs[i], valeurs[i]}, autre);
+        ss.push_back(instruction(sequences[i], branche));
+        joindre(apres, branche);
+        change = change || ss.back() != sequences[i];
+      }
+      Noeud* sinon = aiguillage->getSinon() == nullptr ? nullptr : instruction(aiguillage->getSinon(), autre);
+      joindre(apres, autre);
+      etat = apres;
+      if (!change && sinon == aiguillage->getSinon()) return noeud;
+      return m_arene.creer<NoeudInstAiguillage>(aiguillage->getVariable(), valeurs, ss, sinon);
+    }
+    case N_TANTQUE: {
+      NoeudInstTantQue* tantQue = (NoeudInstTantQue*) noeud;
+      Noeud* s = tantQue->getSequence();
+      Noeud* increment = nullptr;
+      Noeud* c = boucle(noeud, tantQue->getCondition(), true, s, increment, etat);
+      if (c == tantQue->getCondition() && s == tantQue->getSequence()) return noeud;
+      return m_arene.creer<NoeudInstTantQue>(c, s);
+    }
+    case N_REPETER: { // comme NoeudInstRepeter : tant que la condition est fausse
+      NoeudInstRepeter* repeter = (NoeudInstRepeter*) noeud;
+      Noeud* s = repeter->getSequence();
+      Noeud* increment = nullptr;
+      Noeud* c = boucle(noeud, repeter->getCondition(), false, s, increment, etat);
+      if (c == repeter->getCondition() && s == repeter->getSequence()) return noeud;
+      return m_arene.creer<NoeudInstRepeter>(s, c);
+    }
+    case N_POUR: {
+      NoeudInstPour* pour = (NoeudInstPour*) noeud;
+      Noeud* a1 = pour->getAffectation1() == nullptr ? nullptr : instruction(pour->getAffectation1(), etat);
+      Noeud* s = pour->getSequence();
+      Noeud* a2 = pour->getAffectation2();
+      Noeud* c = boucle(noeud, pour->getCondition(), true, s, a2, etat);
+      if (a1 == pour->getAffectation1() && c == pour->getCondition() && s == pour->getSequence()
+          && a2 == pour->getAffectation2()) return noeud;
+      return m_arene.creer<NoeudInstPour>(c, s, a1, a2);
+    }
+    case N_ECRIRE: {
+      const vector<Noeud*> & parametres = ((NoeudInstEcrire*) noeud)->getParametres();
+      vector<Noeud*> ps;
+      bool change = false;
+      for (Noeud* parametre : parametres) {
+        ps.push_back(parametre->getGenre() == N_CHAINE ? parametre : expression(parametre, etat));
+        change = change || ps.back() != parametre;
+      }
+      if (!change) return noeud;
+      return m_arene.creer<NoeudInstEcrire>(ps);
+    }
+    case N_LIRE: // les variables lues sont ensuite définies, et peuvent tout valoir
+      for (Noeud* v : ((NoeudInstLire*) noeud)->getVariables()) {
+        const SymboleValue* variable = variableLue(v);
+        if (variable != nullptr && etat.accessible) {
+          etat.definies[variable->getNumero()] = true;
+          etat.peutEtre[variable->getNumero()] = true;
+          etat.valeurs[variable->getNumero()] = Intervalle{INT_MIN, INT_MAX};
+        }
+      }
+      return noeud;
+    default: // oublis des invariants
+      return noeud;
+  }
+}
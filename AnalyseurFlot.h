@@ -0,0 +1,87 @@
+#ifndef ANALYSEURFLOT_H
+#define ANALYSEURFLOT_H
+
+// Analyseur de flot : analyse de flot de données sur l'arbre abstrait. Elle calcule, en chaque point du
+// programme et pour chaque variable :
+//  - si elle est certainement définie (affectée ou lue par lire, ou déjà évaluée sans exception, sur tous les
+//    chemins qui y mènent) ;
+//  - si elle est peut-être définie (sur au moins un chemin) : sinon, la lire lève toujours IndefiniException ;
+//  - l'intervalle de ses valeurs possibles, resserré par les conditions des si et des boucles
+//    (dans pour (i = 1; i <= 10; i = i + 1), i est entre 1 et 10 dans la séquence).
+// Les deux branches d'un si sont réunies après lui ; une boucle est analysée jusqu'à un point fixe, atteint
+// en élargissant à l'infini les bornes qui augmentent encore d'un tour à l'autre.
+// Elle sert à :
+//  - signaler à l'analyse syntaxique les variables lues là où elles sont certainement indéfinies ;
+//  - remplacer les lectures de variables certainement définies par des NoeudVariableSure, et les divisions
+//    dont le diviseur ne peut pas valoir 0 par des NoeudDivisionSure : ils ne font plus les tests à l'exécution.
+// Comme l'optimiseur, elle ne modifie aucun noeud : elle construit ceux qui changent dans l'arène (ses opérations
+// dans la table des expressions).
+
+#include <set>
+#include <vector>
+using namespace std;
+
+#include "ArbreAbstrait.h"
+#include "Arene.h"
+#include "TableSymboles.h"
+#include "TableExpressions.h"
+
+class AnalyseurFlot {
+public:
+    AnalyseurFlot(Arene & arene, const TableSymboles & table, TableExpressions & expressions);
+    // Construit un analyseur pour les programmes dont la table est table, qui alloue ses noeuds dans arene
+    //  (ses opérations dans expressions)
+
+    vector<const SymboleValue*> lecturesIndefinies(Noeud* racine);
+    // Variables lues dans l'arbre racine là où elles sont certainement indéfinies (chacune une fois)
+    Noeud* rendreSur(Noeud* racine);
+    // Renvoie l'arbre équivalent à racine où les lectures et les divisions sûres ne font plus de test
+
+private:
+    struct Intervalle { int min, max; }; // Valeurs possibles d'une variable ou d'une expression
+
+    struct Etat { // Ce que l'on sait en un point du programme, pour chaque emplacement de la table
+        bool               accessible; // Faux si aucune exécution n'atteint ce point
+        vector<bool>       definies;   // Vrai si la variable est certainement définie
+        vector<bool>       peutEtre;   // Vrai si la variable est peut-être définie
+        vector<Intervalle> valeurs;    // Valeurs possibles de la variable quand elle est définie
+        bool operator==(const Etat & autre) const;
+    };
+
+    Noeud* instruction(Noeud* noeud, Etat & etat);
+    // Analyse l'instruction noeud à partir de etat (avant noeud), mis à jour pour après noeud ;
+    //  renvoie l'instruction rendue sûre (noeud lui-même si rien ne change ou si on ne réécrit pas)
+    Noeud* expression(Noeud* noeud, Etat & etat);
+    // Idem pour l'évaluation de l'expression noeud : ses lectures rendent ses variables certainement définies
+    Noeud* boucle(Noeud* boucle, Noeud* condition, bool continuer, Noeud* & sequence, Noeud* & increment, Etat & etat);
+    // Analyse une boucle : tant que condition vaut continuer, sequence puis increment (peut être nullptr) ;
+    //  sequence et increment reçoivent leurs versions sûres, la condition sûre est renvoyée
+    Intervalle intervalle(const Noeud* expression, const Etat & etat) const; // Valeurs possibles de expression
+    void restreindre(const Noeud* condition, bool vraie, Etat & etat) const;
+    // Restreint etat aux exécutions où condition (déjà évaluée) vaut vraie
+    void restreindre(const Noeud* variable, Jeton comparaison, Intervalle autre, Etat & etat) const;
+    // Idem pour variable comparaison autre (variable < autre, ...), où autre est l'intervalle de l'autre opérande
+    void marquerLues(const Noeud* expression, Etat & etat) const;
+    // Rend certainement définies les variables que l'évaluation de expression lit forcément
+    Etat etatInitial() const; // Au début du programme : rien n'est défini
+    static void joindre(Etat & etat, const Etat & autre);     // etat devient ce qui est vrai dans etat ou dans autre
+    static void elargir(Etat & etat, const Etat & precedent); // Pousse à l'infini les bornes qui ont grandi depuis precedent
+    const SymboleValue* variableLue(const Noeud* noeud) const;
+    // Variable de la table (pas un entier, ni une temporaire) que lit noeud, variable ou NoeudVariableSure ; nullptr sinon
+
+    static const unsigned int IMBRICATION_MAX; // Dans plus d'autant de boucles imbriquées, le point fixe n'est plus
+                                               //  cherché tour après tour : les variables modifiées peuvent tout valoir
+
+    Arene &                     m_arene;
+    const TableSymboles &       m_table;
+    TableExpressions &          m_expressions;
+    bool                        m_reecrire;    // Vrai si les noeuds sûrs sont construits (rendreSur)
+    unsigned int                m_essais;      // Nombre de tours d'essai en cours (recherches de point fixe) :
+                                               //  pendant un essai, on ne réécrit rien et on ne signale rien
+    unsigned int                m_imbrication; // Nombre de boucles en cours d'analyse
+    vector<const SymboleValue*> m_indefinies;  // Les variables lues certainement indéfinies
+    set<const Noeud*>           m_signalees;   // Les mêmes, pour ne les signaler qu'une fois
+    vector<Noeud*>              m_sures;       // Le NoeudVariableSure de chaque emplacement (nullptr s'il n'y en a pas encore)
+};
+
+#endif /* ANALYSEURFLOT_H */
@@ -3,6 +3,8 @@
 #include "Symbole.h"
 #include "SymboleValue.h"
 #include "Exceptions.h"
+#include "Sortie.h"
+#include "Entree.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // NoeudSeqInst
@@ -39,32 +41,42 @@ int NoeudAffectation::executer() {
 // NoeudOperateurBinaire
 ////////////////////////////////////////////////////////////////////////////////
 
-NoeudOperateurBinaire::NoeudOperateurBinaire(Symbole operateur, Noeud* operandeGauche, Noeud* operandeDroit)
+NoeudOperateurBinaire::NoeudOperateurBinaire(Jeton operateur, Noeud* operandeGauche, Noeud* operandeDroit)
 : m_operateur(operateur), m_operandeGauche(operandeGauche), m_operandeDroit(operandeDroit) {
 }
 
-int NoeudOperateurBinaire::executer() {
-  int og, od, valeur;
-  if (m_operandeGauche != nullptr) og = m_operandeGauche->executer(); // On évalue l'opérande gauche
-  if (m_operandeDroit != nullptr) od = m_operandeDroit->executer(); // On évalue l'opérande droit
-  // Et on combine les deux opérandes en fonctions de l'opérateur
-  if (this->m_operateur == "+") valeur = (og + od);
-  else if (this->m_operateur == "-") valeur = (og - od);
-  else if (this->m_operateur == "*") valeur = (og * od);
-  else if (this->m_operateur == "==") valeur = (og == od);
-  else if (this->m_operateur == "!=") valeur = (og != od);
-  else if (this->m_operateur == "<") valeur = (og < od);
-  else if (this->m_operateur == ">") valeur = (og > od);
-  else if (this->m_operateur == "<=") valeur = (og <= od);
-  else if (this->m_operateur == ">=") valeur = (og >= od);
-  else if (this->m_operateur == "et") valeur = (og && od);
-  else if (this->m_operateur == "ou") valeur = (og || od);
-  else if (this->m_operateur == "non") valeur = (!og);
-  else if (this->m_operateur == "/") {
-    if (od == 0) throw DivParZeroException();
-    valeur = og / od;
+NoeudOperateurBinaire* NoeudOperateurBinaire::creer(Arene & arene, Jeton operateur, Noeud* og, Noeud* od) {
+  switch (operateur) {
+    case J_PLUS:           return arene.creer<NoeudOperation<Addition> >(og, od);
+    case J_MOINS:          return arene.creer<NoeudOperation<Soustraction> >(og, od);
+    case J_MULTIPLICATION: return arene.creer<NoeudOperation<Multiplication> >(og, od);
+    case J_DIVISION:       return arene.creer<NoeudOperation<Division> >(og, od);
+    case J_EGAL:           return arene.creer<NoeudOperation<Egal> >(og, od);
+    case J_DIFFERENT:      return arene.creer<NoeudOperation<Different> >(og, od);
+    case J_INFERIEUR:      return arene.creer<NoeudOperation<Inferieur> >(og, od);
+    case J_INFERIEUREGAL:  return arene.creer<NoeudOperation<InferieurEgal> >(og, od);
+    case J_SUPERIEUR:      return arene.creer<NoeudOperation<Superieur> >(og, od);
+    case J_SUPERIEUREGAL:  return arene.creer<NoeudOperation<SuperieurEgal> >(og, od);
+    case J_ET:             return arene.creer<NoeudOperation<Et> >(og, od);
+    case J_OU:             return arene.creer<NoeudOperation<Ou> >(og, od);
+    default:               throw OperationInterditeException(); // pas un opérateur binaire
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// NoeudOperateurUnaire
+////////////////////////////////////////////////////////////////////////////////
+
+NoeudOperateurUnaire::NoeudOperateurUnaire(Jeton operateur, Noeud* operande)
+: m_operateur(operateur), m_operande(operande) {
+}
+
+NoeudOperateurUnaire* NoeudOperateurUnaire::creer(Arene & arene, Jeton operateur, Noeud* operande) {
+  switch (operateur) {
+    case J_MOINS: return arene.creer<NoeudOperationUnaire<Oppose> >(operande);
+    case J_NON:   return arene.creer<NoeudOperationUnaire<Negation> >(operande);
+    default:      throw OperationInterditeException(); // pas un opérateur unaire
   }
-  return valeur; // On retourne la valeur calculée
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -119,11 +131,11 @@ int NoeudInstSiRiche::executer() {
                             //boolean pour sortir de la boucle
     bool sortie = false;
     while(i<m_conditions.size() && !sortie){    // Tant qu'il reste des conditions et qu'aucune n'a était réaliser faire
-        if(m_conditions.at(i) == m_sequences.at(i)){ // si la condition vaut NULL alors c'est un sinon donc faire puis sortir de la boucle
+        if(m_conditions.at(i) == nullptr){ // si la condition vaut NULL alors c'est un sinon donc faire puis sortir de la boucle
             m_sequences.at(i)->executer();
             sortie = true;
         }
-        if(m_conditions.at(i)->executer()) {         // si la condition est vrai alors faire puis sortir de la boucle
+        else if(m_conditions.at(i)->executer()) {    // si la condition est vrai alors faire puis sortir de la boucle
             m_sequences.at(i)->executer();
             sortie = true;
         }
@@ -133,6 +145,52 @@ int NoeudInstSiRiche::executer() {
     return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// NoeudInstAiguillage
+////////////////////////////////////////////////////////////////////////////////
+
+const unsigned int NoeudInstAiguillage::AUCUNE;
+const unsigned int NoeudInstAiguillage::VALEURS_MIN;
+
+// Hachage d'une valeur pour l'index de l'aiguillage
+static inline unsigned int hacher(int valeur) {
+  return IndexChaines::hacher((const char*) &valeur, sizeof(valeur));
+}
+
+NoeudInstAiguillage::NoeudInstAiguillage(Noeud* variable, vector<int> valeurs, vector<Noeud*> sequences, Noeud* sinon)
+: m_variable(variable), m_valeurs(valeurs), m_sequences(sequences), m_sinon(sinon),
+  m_minimum(valeurs[0]), m_maximum(valeurs[0]), m_table(), m_index() {
+  for (unsigned int i = 0; i < m_valeurs.size(); i++) {
+    if (m_valeurs[i] < m_minimum) m_minimum = m_valeurs[i];
+    if (m_valeurs[i] > m_maximum) m_maximum = m_valeurs[i];
+  }
+  // une table si elle a au plus deux cases par valeur, un index de hachage sinon
+  if ((long long) m_maximum - m_minimum < 2 * (long long) m_valeurs.size()) {
+    m_table.assign((long long) m_maximum - m_minimum + 1, AUCUNE);
+    for (unsigned int i = 0; i < m_valeurs.size(); i++)
+      if (m_table[(unsigned int) m_valeurs[i] - (unsigned int) m_minimum] == AUCUNE)
+        m_table[(unsigned int) m_valeurs[i] - (unsigned int) m_minimum] = i;
+  } else {
+    for (unsigned int i = 0; i < m_valeurs.size(); i++)
+      if (choisir(m_valeurs[i]) == AUCUNE) m_index.inserer(hacher(m_valeurs[i]), i);
+  }
+}
+
+unsigned int NoeudInstAiguillage::choisir(int valeur) const {
+  if (estDense()) {
+    unsigned int indice = (unsigned int) valeur - (unsigned int) m_minimum; // hors de la table si valeur < m_minimum
+    return indice < m_table.size() ? m_table[indice] : AUCUNE;
+  }
+  return m_index.chercher(hacher(valeur), [&](unsigned int rang) { return m_valeurs[rang] == valeur; });
+}
+
+int NoeudInstAiguillage::executer() {
+  unsigned int rang = choisir(m_variable->executer());
+  if (rang != AUCUNE) m_sequences[rang]->executer();
+  else if (m_sinon != nullptr) m_sinon->executer();
+  return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //NoeudInstPour
 ////////////////////////////////////////////////////////////////////////////////
@@ -146,6 +204,7 @@ int NoeudInstPour::executer() {
     for(m_affectation1 != NULL ? m_affectation1->executer() : 0;m_condition->executer();m_affectation2 != NULL ? m_affectation2->executer() : 0){
         m_sequence->executer();
     }
+    return 0; // La valeur renvoyée ne représente rien !
 }
 
 //////////////////////////////////////////////////////////////////
@@ -158,30 +217,84 @@ NoeudInstLire::NoeudInstLire(vector<Noeud*> variables)
 
 int NoeudInstLire::executer() {
     for (int i=0; i<m_variables.size(); i++) {
-        cout << ((SymboleValue*) m_variables[i])->getValeur() << endl;
+        ((SymboleValue*) m_variables[i])->setValeur(Entree::lire());
     }
     return 0;
 }
+////////////////////////////////////////////////////////////////////////////////
+// NoeudConstante
+////////////////////////////////////////////////////////////////////////////////
+
+NoeudConstante::NoeudConstante(int valeur)
+: m_valeur(valeur) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// NoeudVariableSure
+////////////////////////////////////////////////////////////////////////////////
+
+NoeudVariableSure::NoeudVariableSure(Noeud* variable)
+: m_variable(variable) {
+}
+
+int NoeudVariableSure::executer() {
+  return ((SymboleValue*) m_variable)->getValeur(); // définie : pas de test
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// NoeudChaine
+////////////////////////////////////////////////////////////////////////////////
+
+NoeudChaine::NoeudChaine(const string & chaine)
+: m_chaine(chaine) {
+}
+
+int NoeudChaine::executer() {
+  throw OperationInterditeException();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //NoeudInstEcrire
 ////////////////////////////////////////////////////////////////////////////////
 
 NoeudInstEcrire::NoeudInstEcrire(vector<Noeud*> s)
-:m_s(s){
-    
+:m_s(s), m_chaines(){
+    for (unsigned int i = 0; i < m_s.size(); i++) // les chaînes sont reconnues une fois pour toutes
+        m_chaines.push_back(m_s[i]->getGenre() == N_CHAINE ? &((NoeudChaine*) m_s[i])->getChaine() : nullptr);
 }
 int NoeudInstEcrire::executer() {
     for(unsigned i = 0;i<m_s.size();i++){
-        Noeud* p = m_s.at(i);
-        if(typeid(*p)==typeid(SymboleValue) && *((SymboleValue*)p)== "<CHAINE>"){
-            cout << ((SymboleValue*)p)->getChaine()  << endl;
-        }else{
-            cout << p->executer() << endl;
-        } 
+        if (m_chaines[i] != nullptr) Sortie::ecrire(*m_chaines[i]);
+        else Sortie::ecrire(m_s[i]->executer());
     }
+    return 0;
+}
 
 
-    return 0;
+
+////////////////////////////////////////////////////////////////////////////////
+// NoeudInvariant
+////////////////////////////////////////////////////////////////////////////////
+
+NoeudInvariant::NoeudInvariant(Noeud* temporaire, Noeud* expression)
+: m_temporaire(temporaire), m_expression(expression) {
 }
 
+int NoeudInvariant::executer() {
+  SymboleValue* temporaire = (SymboleValue*) m_temporaire;
+  if (!temporaire->estDefini()) temporaire->setValeur(m_expression->executer()); // premier calcul depuis l'oubli
+  return temporaire->getValeur();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// NoeudInstOublier
+////////////////////////////////////////////////////////////////////////////////
 
+NoeudInstOublier::NoeudInstOublier(vector<Noeud*> temporaires)
+: m_temporaires(temporaires) {
+}
+
+int NoeudInstOublier::executer() {
+  for (unsigned int i = 0; i < m_temporaires.size(); i++) ((SymboleValue*) m_temporaires[i])->oublier();
+  return 0;
+}
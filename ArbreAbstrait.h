@@ -11,6 +11,15 @@ using namespace std;
 
 #include "Symbole.h"
 #include "Exceptions.h"
+#include "Arene.h"
+#include "IndexChaines.h"
+
+////////////////////////////////////////////////////////////////////////////////
+enum GenreNoeud { // Genre de chaque classe concrète de noeud, pour parcourir l'arbre sans connaître ses classes
+  N_SEQINST, N_AFFECTATION, N_OPERATEURBINAIRE, N_OPERATEURUNAIRE, N_SI, N_REPETER, N_TANTQUE, N_SIRICHE, N_POUR,
+  N_LIRE, N_ECRIRE, N_CHAINE, N_SYMBOLEVALUE, N_CONSTANTE, N_INVARIANT, N_OUBLIER,
+  N_AIGUILLAGE, N_VARIABLESURE, N_DIVISIONSURE
+};
 
 ////////////////////////////////////////////////////////////////////////////////
 class Noeud {
@@ -18,6 +27,7 @@ class Noeud {
 // Remarque : la classe ne contient aucun constructeur
   public:
     virtual int  executer() =0 ; // Méthode pure (non implémentée) qui rend la classe abstraite
+    virtual GenreNoeud getGenre() const =0; // Genre du noeud (la classe concrète correspondante)
     virtual void ajoute(Noeud* instruction) { throw OperationInterditeException(); }
     virtual ~Noeud() {} // Présence d'un destructeur virtuel conseillée dans les classes abstraites
 };
@@ -31,6 +41,8 @@ class NoeudSeqInst : public Noeud {
     ~NoeudSeqInst() {} // A cause du destructeur virtuel de la classe Noeud
     int executer();    // Exécute chaque instruction de la séquence
     void ajoute(Noeud* instruction);  // Ajoute une instruction à la séquence
+    GenreNoeud getGenre() const { return N_SEQINST; }
+    inline const vector<Noeud *> & getInstructions() const { return m_instructions; } // accesseur
 
   private:
     vector<Noeud *> m_instructions; // pour stocker les instructions de la séquence
@@ -44,6 +56,9 @@ class NoeudAffectation : public Noeud {
      NoeudAffectation(Noeud* variable, Noeud* expression); // construit une affectation
     ~NoeudAffectation() {} // A cause du destructeur virtuel de la classe Noeud
     int executer();        // Exécute (évalue) l'expression et affecte sa valeur à la variable
+    GenreNoeud getGenre() const { return N_AFFECTATION; }
+    inline Noeud* getVariable() const   { return m_variable;   } // accesseur
+    inline Noeud* getExpression() const { return m_expression; } // accesseur
 
   private:
     Noeud* m_variable;
@@ -52,20 +67,107 @@ class NoeudAffectation : public Noeud {
 
 ////////////////////////////////////////////////////////////////////////////////
 class NoeudOperateurBinaire : public Noeud {
-// Classe pour représenter un noeud "opération binaire" composé d'un opérateur
-//  et de 2 fils : l'opérande gauche et l'opérande droit
+// Classe abstraite pour représenter un noeud "opération binaire" composé d'un opérateur
+//  et de 2 fils : l'opérande gauche et l'opérande droit.
+// Chaque opérateur a sa propre classe concrète NoeudOperation<Operation> (voir plus bas) :
+//  l'opérateur est choisi une fois pour toutes à l'analyse, pas à chaque exécution
   public:
-    NoeudOperateurBinaire(Symbole operateur, Noeud* operandeGauche, Noeud* operandeDroit);
+    NoeudOperateurBinaire(Jeton operateur, Noeud* operandeGauche, Noeud* operandeDroit);
     // Construit une opération binaire : operandeGauche operateur OperandeDroit
    ~NoeudOperateurBinaire() {} // A cause du destructeur virtuel de la classe Noeud
-    int executer();            // Exécute (évalue) l'opération binaire)
+    GenreNoeud getGenre() const { return N_OPERATEURBINAIRE; }
+    inline Jeton  getOperateur() const      { return m_operateur;       } // accesseur
+    inline Noeud* getOperandeGauche() const { return m_operandeGauche;  } // accesseur
+    inline Noeud* getOperandeDroit() const  { return m_operandeDroit;   } // accesseur
 
-  private:
-    Symbole m_operateur;
+    static NoeudOperateurBinaire* creer(Arene & arene, Jeton operateur, Noeud* operandeGauche, Noeud* operandeDroit);
+    // Construit dans arene le noeud de la classe concrète qui correspond à operateur (+, -, *, /, ==, ..., et, ou)
+
+  protected:
+    Jeton   m_operateur;
     Noeud*  m_operandeGauche;
     Noeud*  m_operandeDroit;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+class NoeudOperateurUnaire : public Noeud {
+// Classe abstraite pour représenter un noeud "opération unaire" (- ou non) et son opérande
+  public:
+    NoeudOperateurUnaire(Jeton operateur, Noeud* operande);
+   ~NoeudOperateurUnaire() {} // A cause du destructeur virtuel de la classe Noeud
+    GenreNoeud getGenre() const { return N_OPERATEURUNAIRE; }
+    inline Jeton  getOperateur() const { return m_operateur; } // accesseur (J_MOINS ou J_NON)
+    inline Noeud* getOperande() const  { return m_operande;  } // accesseur
+
+    static NoeudOperateurUnaire* creer(Arene & arene, Jeton operateur, Noeud* operande);
+    // Construit dans arene le noeud de la classe concrète qui correspond à operateur (- ou non)
+
+  protected:
+    Jeton   m_operateur;
+    Noeud*  m_operande;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Les opérations : chacune donne son jeton et calcule son résultat à partir de ses opérandes.
+// et/ou n'évaluent leur opérande droit que si le gauche ne suffit pas à donner le résultat (voir plus bas) ;
+// leur calculer() ne sert qu'à calculer d'avance deux opérandes constants.
+
+struct Addition       { static const Jeton JETON = J_PLUS;           static inline int calculer(int g, int d) { return g + d;  } };
+struct Soustraction   { static const Jeton JETON = J_MOINS;          static inline int calculer(int g, int d) { return g - d;  } };
+struct Multiplication { static const Jeton JETON = J_MULTIPLICATION; static inline int calculer(int g, int d) { return g * d;  } };
+struct Division       { static const Jeton JETON = J_DIVISION;
+                        static inline int calculer(int g, int d) { if (d == 0) throw DivParZeroException(); return g / d; } };
+struct DivisionSure   { static const Jeton JETON = J_DIVISION;       static inline int calculer(int g, int d) { return g / d;  } };
+struct Egal           { static const Jeton JETON = J_EGAL;           static inline int calculer(int g, int d) { return g == d; } };
+struct Different      { static const Jeton JETON = J_DIFFERENT;      static inline int calculer(int g, int d) { return g != d; } };
+struct Inferieur      { static const Jeton JETON = J_INFERIEUR;      static inline int calculer(int g, int d) { return g < d;  } };
+struct InferieurEgal  { static const Jeton JETON = J_INFERIEUREGAL;  static inline int calculer(int g, int d) { return g <= d; } };
+struct Superieur      { static const Jeton JETON = J_SUPERIEUR;      static inline int calculer(int g, int d) { return g > d;  } };
+struct SuperieurEgal  { static const Jeton JETON = J_SUPERIEUREGAL;  static inline int calculer(int g, int d) { return g >= d; } };
+struct Et             { static const Jeton JETON = J_ET;             static inline int calculer(int g, int d) { return g && d; } };
+struct Ou             { static const Jeton JETON = J_OU;             static inline int calculer(int g, int d) { return g || d; } };
+struct Oppose         { static const Jeton JETON = J_MOINS;          static inline int calculer(int x) { return -x; } };
+struct Negation       { static const Jeton JETON = J_NON;            static inline int calculer(int x) { return !x; } };
+
+template <class Operation>
+class NoeudOperation : public NoeudOperateurBinaire {
+// Noeud d'une opération binaire donnée : son exécution est un calcul direct
+  public:
+    NoeudOperation(Noeud* operandeGauche, Noeud* operandeDroit)
+    : NoeudOperateurBinaire(Operation::JETON, operandeGauche, operandeDroit) {}
+    int executer() {
+      int og = m_operandeGauche->executer(); // On évalue l'opérande gauche
+      int od = m_operandeDroit->executer();  // puis l'opérande droit
+      return Operation::calculer(og, od);
+    }
+};
+
+// et, ou : évaluation paresseuse, l'opérande droit n'est pas évalué (ni ses exceptions levées)
+//  quand l'opérande gauche vaut 0 pour et, autre chose que 0 pour ou
+template <> inline int NoeudOperation<Et>::executer() {
+  return m_operandeGauche->executer() && m_operandeDroit->executer();
+}
+template <> inline int NoeudOperation<Ou>::executer() {
+  return m_operandeGauche->executer() || m_operandeDroit->executer();
+}
+
+class NoeudDivisionSure : public NoeudOperation<DivisionSure> {
+// Division dont le diviseur ne peut pas être nul (prouvé par l'analyse de flot, voir AnalyseurFlot.h) :
+//  elle ne le teste pas. Elle a son propre genre pour que chaque exécuteur la distingue de la division
+  public:
+    NoeudDivisionSure(Noeud* operandeGauche, Noeud* operandeDroit)
+    : NoeudOperation<DivisionSure>(operandeGauche, operandeDroit) {}
+    GenreNoeud getGenre() const { return N_DIVISIONSURE; }
+};
+
+template <class Operation>
+class NoeudOperationUnaire : public NoeudOperateurUnaire {
+// Noeud d'une opération unaire donnée
+  public:
+    NoeudOperationUnaire(Noeud* operande) : NoeudOperateurUnaire(Operation::JETON, operande) {}
+    int executer() { return Operation::calculer(m_operande->executer()); }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 class NoeudInstSi : public Noeud {
 // Classe pour représenter un noeud "instruction si"
@@ -75,6 +177,9 @@ class NoeudInstSi : public Noeud {
      // Construit une "instruction si" avec sa condition et sa séquence d'instruction
    ~NoeudInstSi() {} // A cause du destructeur virtuel de la classe Noeud
     int executer();  // Exécute l'instruction si : si condition vraie on exécute la séquence
+    GenreNoeud getGenre() const { return N_SI; }
+    inline Noeud* getCondition() const { return m_condition; } // accesseur
+    inline Noeud* getSequence() const  { return m_sequence;  } // accesseur
 
   private:
     Noeud*  m_condition;
@@ -89,6 +194,9 @@ public:
     // Construit une "instruction repeter" avec sa condition et sa séquence d'instruction    
     ~NoeudInstRepeter() {}
     int executer(); // Exécute l'instruction repeter : tant que condition fausse on exécute la séquence
+    GenreNoeud getGenre() const { return N_REPETER; }
+    inline Noeud* getSequence() const  { return m_sequence;  } // accesseur
+    inline Noeud* getCondition() const { return m_condition; } // accesseur
 private:
     Noeud* m_sequence;
     Noeud* m_condition;
@@ -102,6 +210,9 @@ class NoeudInstTantQue : public Noeud {
        // Construit une "instruction tanque" avec sa condition et sa séquence d'instruction
     ~NoeudInstTantQue() {} // A cause du destructeur virtuel de la classe Noeud
     int executer(); //Exécute l'instruction tantque : tant que la condition est vraie on exécute la séquence
+    GenreNoeud getGenre() const { return N_TANTQUE; }
+    inline Noeud* getCondition() const { return m_condition; } // accesseur
+    inline Noeud* getSequence() const  { return m_sequence;  } // accesseur
     
   private:
       Noeud* m_condition;
@@ -114,9 +225,12 @@ class NoeudInstSiRiche : public Noeud {
     
   public:
       NoeudInstSiRiche(vector<Noeud*>  conditions,vector<Noeud*>  sequences);
-        //Construit un tableau "instruction si"
+        //Construit un tableau "instruction si" ; la condition d'un sinon est nullptr
       ~NoeudInstSiRiche(){} // A cause du destructeur virtuel de la classe Noeud
-      int executer(); //Exécute l'instruction tantque : tant que la condition est vraie on exécute la séquence
+      int executer(); //Exécute la séquence de la première condition vraie (ou du sinon)
+      GenreNoeud getGenre() const { return N_SIRICHE; }
+      inline const vector<Noeud*> & getConditions() const { return m_conditions; } // accesseur
+      inline const vector<Noeud*> & getSequences() const  { return m_sequences;  } // accesseur
       
   private:
       vector<Noeud*>  m_conditions;
@@ -129,6 +243,11 @@ public:
     NoeudInstPour(Noeud* condition,Noeud* sequence,Noeud* affectation1,Noeud* affectation2);
     ~NoeudInstPour(){}
     int executer();
+    GenreNoeud getGenre() const { return N_POUR; }
+    inline Noeud* getCondition() const    { return m_condition;    } // accesseur
+    inline Noeud* getSequence() const     { return m_sequence;     } // accesseur
+    inline Noeud* getAffectation1() const { return m_affectation1; } // accesseur (peut être nullptr)
+    inline Noeud* getAffectation2() const { return m_affectation2; } // accesseur (peut être nullptr)
     
 private:
     Noeud* m_condition;
@@ -145,21 +264,139 @@ public:
     NoeudInstLire(vector<Noeud*> variables);
     // Construit une "instruction lire" avec sa liste de variables
     ~NoeudInstLire() {}
-    int executer(); //Exécute l'instruction lire : affiche la valeur de chaque variable de la liste
+    int executer(); //Exécute l'instruction lire : lit (voir Entree) la valeur de chaque variable de la liste
+    GenreNoeud getGenre() const { return N_LIRE; }
+    inline const vector<Noeud*> & getVariables() const { return m_variables; } // accesseur
 private:
     vector<Noeud*> m_variables;
 };
 
+///////////////////////////////////////////////////////////////////////
+class NoeudConstante : public Noeud {
+// Classe pour représenter une valeur entière calculée avant l'exécution (par l'optimiseur) :
+// contrairement aux entiers du programme, elle n'est pas dans la table des symboles
+public:
+    NoeudConstante(int valeur);
+    ~NoeudConstante() {}
+    int executer() { return m_valeur; } // Renvoie la valeur
+    GenreNoeud getGenre() const { return N_CONSTANTE; }
+    inline int getValeur() const { return m_valeur; } // accesseur
+
+private:
+    int m_valeur;
+};
+
+///////////////////////////////////////////////////////////////////////
+class NoeudVariableSure : public Noeud {
+// Classe pour représenter la lecture d'une variable certainement définie à cet endroit du programme
+// (prouvé par l'analyse de flot, voir AnalyseurFlot.h) : sa valeur est lue sans tester qu'elle est définie
+public:
+    NoeudVariableSure(Noeud* variable);
+    ~NoeudVariableSure() {}
+    int executer(); // Renvoie la valeur de la variable
+    GenreNoeud getGenre() const { return N_VARIABLESURE; }
+    inline Noeud* getVariable() const { return m_variable; } // accesseur (SymboleValue)
+
+private:
+    Noeud* m_variable;
+};
+
+///////////////////////////////////////////////////////////////////////
+class NoeudChaine : public Noeud {
+// Classe pour représenter une chaîne littérale (paramètre de ecrire) : elle n'a pas de valeur entière
+// et n'est pas dans la table des symboles
+public:
+    NoeudChaine(const string & chaine);
+    ~NoeudChaine() {}
+    int executer(); // Lève OperationInterditeException : une chaîne ne s'évalue pas
+    GenreNoeud getGenre() const { return N_CHAINE; }
+    inline const string & getChaine() const { return m_chaine; } // accesseur
+
+private:
+    string m_chaine; // La chaîne, guillemets compris
+};
+
 ///////////////////////////////////////////////////////////////////////
 class NoeudInstEcrire : public Noeud {
 public:
     NoeudInstEcrire(vector<Noeud*>s);
     ~NoeudInstEcrire(){}
     int executer();
+    GenreNoeud getGenre() const { return N_ECRIRE; }
+    inline const vector<Noeud*> & getParametres() const { return m_s; } // accesseur (chaînes et expressions)
     
 private:
     vector<Noeud*> m_s;
+    vector<const string*> m_chaines; // Le texte de chaque paramètre qui est une chaîne (nullptr pour une expression)
 };
 
 
+///////////////////////////////////////////////////////////////////////
+class NoeudInstAiguillage : public Noeud {
+// Classe pour représenter un "si ... sinonsi ..." dont les premières conditions comparent toutes la même
+// variable à une constante (v == constante) : la valeur de v désigne directement la séquence à exécuter,
+// sans tester les conditions une à une, par une table indexée par v quand les constantes sont assez
+// proches les unes des autres, sinon par un index de hachage. Le sinon est ce qui suit ces conditions.
+public:
+    NoeudInstAiguillage(Noeud* variable, vector<int> valeurs, vector<Noeud*> sequences, Noeud* sinon);
+    // sequences[i] est exécutée si variable vaut valeurs[i] (la première, pour une valeur en double) ;
+    //  sinon (peut être nullptr) est exécutée pour les autres valeurs
+    ~NoeudInstAiguillage() {}
+    int executer(); // Exécute la séquence choisie par la valeur de la variable (IndefiniException si elle est indéfinie)
+    GenreNoeud getGenre() const { return N_AIGUILLAGE; }
+    unsigned int choisir(int valeur) const; // Rang dans getSequences() de la séquence de valeur, AUCUNE pour le sinon
+    inline bool estDense() const { return !m_table.empty(); } // Vrai si le choix se fait par une table indexée par v
+    inline int getMinimum() const { return m_minimum; }       // Plus petite des valeurs
+    inline int getMaximum() const { return m_maximum; }       // Plus grande des valeurs
+    inline Noeud* getVariable() const { return m_variable; }  // accesseur
+    inline const vector<int> & getValeurs() const { return m_valeurs; }       // accesseur
+    inline const vector<Noeud*> & getSequences() const { return m_sequences; } // accesseur
+    inline Noeud* getSinon() const { return m_sinon; }        // accesseur (peut être nullptr)
+
+    static const unsigned int AUCUNE = IndexChaines::AUCUN;
+    static const unsigned int VALEURS_MIN = 4; // L'analyse ne construit un aiguillage qu'à partir d'autant de valeurs
+
+private:
+    Noeud*               m_variable;
+    vector<int>          m_valeurs;
+    vector<Noeud*>       m_sequences;
+    Noeud*               m_sinon;
+    int                  m_minimum;
+    int                  m_maximum;
+    vector<unsigned int> m_table; // Rang de la séquence de m_minimum + i, AUCUNE s'il n'y en a pas (vide si pas dense)
+    IndexChaines         m_index; // Rang de la séquence de chaque valeur (si pas dense)
+};
+
+///////////////////////////////////////////////////////////////////////
+class NoeudInvariant : public Noeud {
+// Classe pour représenter une expression qui ne change pas pendant une boucle (placée par l'optimiseur) :
+// elle n'est calculée que la première fois qu'elle est évaluée, sa valeur est ensuite gardée dans une
+// temporaire (voir TableSymboles::ajouteTemporaire), que NoeudInstOublier rend indéfinie à l'entrée de la boucle
+public:
+    NoeudInvariant(Noeud* temporaire, Noeud* expression);
+    ~NoeudInvariant() {}
+    int executer(); // Renvoie la valeur de la temporaire ; si elle est indéfinie, calcule d'abord l'expression
+    GenreNoeud getGenre() const { return N_INVARIANT; }
+    inline Noeud* getTemporaire() const { return m_temporaire; } // accesseur (SymboleValue)
+    inline Noeud* getExpression() const { return m_expression; } // accesseur
+
+private:
+    Noeud* m_temporaire;
+    Noeud* m_expression;
+};
+
+///////////////////////////////////////////////////////////////////////
+class NoeudInstOublier : public Noeud {
+// Classe pour représenter l'oubli des valeurs des invariants d'une boucle, juste avant elle :
+// ses variables sont sa liste de temporaires
+public:
+    NoeudInstOublier(vector<Noeud*> temporaires);
+    ~NoeudInstOublier() {}
+    int executer(); // Rend indéfinie chaque temporaire
+    GenreNoeud getGenre() const { return N_OUBLIER; }
+    inline const vector<Noeud*> & getTemporaires() const { return m_temporaires; } // accesseur
+private:
+    vector<Noeud*> m_temporaires;
+};
+
 #endif /* ARBREABSTRAIT_H */
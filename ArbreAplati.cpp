@@ -0,0 +1,248 @@
+#include "ArbreAplati.h"
+#include "Exceptions.h"
+#include "Sortie.h"
+#include "Entree.h"
+#include <iostream>
+
+ArbreAplati::ArbreAplati(const Noeud* racine, vector<Emplacement> & emplacements)
+: m_noeuds(), m_listes(), m_chaines(), m_aiguillages(), m_emplacements(emplacements) {
+  ajouter(racine);
+}
+
+void ArbreAplati::executer() {
+  executer(m_noeuds.size() - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Construction
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int ArbreAplati::ajouter(Genre genre, unsigned int a, unsigned int b, unsigned int c, unsigned int d,
+                                  unsigned char operateur) {
+  m_noeuds.push_back(NoeudAplati{genre, operateur, a, b, c, d});
+  return m_noeuds.size() - 1;
+}
+
+unsigned int ArbreAplati::ajouterListe(const vector<unsigned int> & elements) {
+  unsigned int debut = m_listes.size();
+  m_listes.insert(m_listes.end(), elements.begin(), elements.end());
+  return debut;
+}
+
+unsigned int ArbreAplati::emplacement(const Noeud* variable) {
+  return ((const SymboleValue*) variable)->getNumero();
+}
+
+unsigned int ArbreAplati::ajouter(const Noeud* noeud) {
+  // les fils sont ajoutés avant leur père
+  vector<unsigned int> fils;
+  switch (noeud->getGenre()) {
+    case N_SEQINST: {
+      const vector<Noeud*> & instructions = ((const NoeudSeqInst*) noeud)->getInstructions();
+      for (unsigned int i = 0; i < instructions.size(); i++) fils.push_back(ajouter(instructions[i]));
+      return ajouter(SEQUENCE, ajouterListe(fils), fils.size());
+    }
+    case N_AFFECTATION: {
+      const NoeudAffectation* affectation = (const NoeudAffectation*) noeud;
+      unsigned int expression = ajouter(affectation->getExpression());
+      return ajouter(AFFECTATION, emplacement(affectation->getVariable()), expression);
+    }
+    case N_SYMBOLEVALUE: {
+      const SymboleValue* symbole = (const SymboleValue*) noeud;
+      if (*symbole == "<ENTIER>") return ajouter(CONSTANTE, (unsigned int) symbole->getValeur());
+      return ajouter(VARIABLE, symbole->getNumero());
+    }
+    case N_VARIABLESURE:
+      return ajouter(VARIABLE_SURE, emplacement(((const NoeudVariableSure*) noeud)->getVariable()));
+    case N_CONSTANTE:
+      return ajouter(CONSTANTE, (unsigned int) ((const NoeudConstante*) noeud)->getValeur());
+    case N_OPERATEURBINAIRE: {
+      const NoeudOperateurBinaire* operation = (const NoeudOperateurBinaire*) noeud;
+      unsigned int gauche = ajouter(operation->getOperandeGauche());
+      unsigned int droit = ajouter(operation->getOperandeDroit());
+      return ajouter(OPERATION, gauche, droit, 0, 0, operation->getOperateur());
+    }
+    case N_DIVISIONSURE: {
+      const NoeudOperateurBinaire* operation = (const NoeudOperateurBinaire*) noeud;
+      unsigned int gauche = ajouter(operation->getOperandeGauche());
+      return ajouter(DIVISION_SURE, gauche, ajouter(operation->getOperandeDroit()));
+    }
+    case N_OPERATEURUNAIRE: {
+      const NoeudOperateurUnaire* operation = (const NoeudOperateurUnaire*) noeud;
+      return ajouter(OPERATION_UNAIRE, ajouter(operation->getOperande()), 0, 0, 0, operation->getOperateur());
+    }
+    case N_SI: {
+      const NoeudInstSi* si = (const NoeudInstSi*) noeud;
+      unsigned int condition = ajouter(si->getCondition());
+      return ajouter(SI, condition, ajouter(si->getSequence()));
+    }
+    case N_REPETER: {
+      const NoeudInstRepeter* repeter = (const NoeudInstRepeter*) noeud;
+      unsigned int sequence = ajouter(repeter->getSequence());
+      return ajouter(REPETER, sequence, ajouter(repeter->getCondition()));
+    }
+    case N_TANTQUE: {
+      const NoeudInstTantQue* tantQue = (const NoeudInstTantQue*) noeud;
+      unsigned int condition = ajouter(tantQue->getCondition());
+      return ajouter(TANTQUE, condition, ajouter(tantQue->getSequence()));
+    }
+    case N_SIRICHE: {
+      const NoeudInstSiRiche* siRiche = (const NoeudInstSiRiche*) noeud;
+      const vector<Noeud*> & conditions = siRiche->getConditions();
+      const vector<Noeud*> & sequences = siRiche->getSequences();
+      for (unsigned int i = 0; i < conditions.size(); i++) {
+        fils.push_back(conditions[i] == nullptr ? AUCUN : ajouter(conditions[i]));
+        fils.push_back(ajouter(sequences[i]));
+      }
+      return ajouter(SIRICHE, ajouterListe(fils), conditions.size());
+    }
+    case N_POUR: {
+      const NoeudInstPour* pour = (const NoeudInstPour*) noeud;
+      unsigned int affectation1 = pour->getAffectation1() == nullptr ? AUCUN : ajouter(pour->getAffectation1());
+      unsigned int condition = ajouter(pour->getCondition());
+      unsigned int affectation2 = pour->getAffectation2() == nullptr ? AUCUN : ajouter(pour->getAffectation2());
+      return ajouter(POUR, affectation1, condition, affectation2, ajouter(pour->getSequence()));
+    }
+    case N_LIRE: {
+      const vector<Noeud*> & variables = ((const NoeudInstLire*) noeud)->getVariables();
+      for (unsigned int i = 0; i < variables.size(); i++) fils.push_back(emplacement(variables[i]));
+      return ajouter(LIRE, ajouterListe(fils), fils.size());
+    }
+    case N_ECRIRE: {
+      const vector<Noeud*> & parametres = ((const NoeudInstEcrire*) noeud)->getParametres();
+      for (unsigned int i = 0; i < parametres.size(); i++) fils.push_back(ajouter(parametres[i]));
+      return ajouter(ECRIRE, ajouterListe(fils), fils.size());
+    }
+    case N_CHAINE:
+      m_chaines.push_back(((const NoeudChaine*) noeud)->getChaine());
+      return ajouter(CHAINE, m_chaines.size() - 1);
+    case N_AIGUILLAGE: {
+      const NoeudInstAiguillage* aiguillage = (const NoeudInstAiguillage*) noeud;
+      for (unsigned int i = 0; i < aiguillage->getSequences().size(); i++) fils.push_back(ajouter(aiguillage->getSequences()[i]));
+      fils.push_back(aiguillage->getSinon() == nullptr ? AUCUN : ajouter(aiguillage->getSinon()));
+      m_aiguillages.push_back(aiguillage);
+      return ajouter(AIGUILLAGE, emplacement(aiguillage->getVariable()), ajouterListe(fils), m_aiguillages.size() - 1,
+                     aiguillage->getSequences().size());
+    }
+    case N_INVARIANT: {
+      const NoeudInvariant* invariant = (const NoeudInvariant*) noeud;
+      return ajouter(INVARIANT, emplacement(invariant->getTemporaire()), ajouter(invariant->getExpression()));
+    }
+    case N_OUBLIER: {
+      const vector<Noeud*> & temporaires = ((const NoeudInstOublier*) noeud)->getTemporaires();
+      for (unsigned int i = 0; i < temporaires.size(); i++) fils.push_back(emplacement(temporaires[i]));
+      return ajouter(OUBLIER, ajouterListe(fils), fils.size());
+    }
+  }
+  throw OperationInterditeException(); // genre inconnu
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Exécution
+////////////////////////////////////////////////////////////////////////////////
+
+int ArbreAplati::executer(unsigned int i) {
+  const NoeudAplati & n = m_noeuds[i];
+  switch (n.genre) {
+    case SEQUENCE:
+      for (unsigned int j = n.a; j < n.a + n.b; j++) executer(m_listes[j]);
+      return 0;
+    case AFFECTATION: {
+      int valeur = executer(n.b);
+      m_emplacements[n.a] = Emplacement{valeur, true};
+      return 0;
+    }
+    case VARIABLE: {
+      const Emplacement & e = m_emplacements[n.a];
+      if (!e.defini) throw IndefiniException();
+      return e.valeur;
+    }
+    case VARIABLE_SURE:
+      return m_emplacements[n.a].valeur;
+    case CONSTANTE:
+      return (int) n.a;
+    case OPERATION: {
+      // comme NoeudOperateurBinaire : l'opérande droit de et/ou n'est évalué que si le gauche ne suffit pas
+      int og = executer(n.a);
+      if (n.operateur == J_ET && !og) return 0;
+      if (n.operateur == J_OU && og) return 1;
+      int od = executer(n.b);
+      switch (n.operateur) {
+        case J_PLUS:           return og + od;
+        case J_MOINS:          return og - od;
+        case J_MULTIPLICATION: return og * od;
+        case J_EGAL:           return og == od;
+        case J_DIFFERENT:      return og != od;
+        case J_INFERIEUR:      return og < od;
+        case J_SUPERIEUR:      return og > od;
+        case J_INFERIEUREGAL:  return og <= od;
+        case J_SUPERIEUREGAL:  return og >= od;
+        case J_ET:             return og && od;
+        case J_OU:             return og || od;
+        case J_DIVISION:
+          if (od == 0) throw DivParZeroException();
+          return og / od;
+      }
+      throw OperationInterditeException();
+    }
+    case DIVISION_SURE: {
+      int og = executer(n.a);
+      return og / executer(n.b);
+    }
+    case OPERATION_UNAIRE: {
+      int o = executer(n.a);
+      return (n.operateur == J_MOINS) ? -o : !o;
+    }
+    case SI:
+      if (executer(n.a)) executer(n.b);
+      return 0;
+    case REPETER:
+      while (!executer(n.b)) executer(n.a);
+      return 0;
+    case TANTQUE:
+      while (executer(n.a)) executer(n.b);
+      return 0;
+    case SIRICHE:
+      for (unsigned int j = n.a; j < n.a + 2 * n.b; j += 2) {
+        if (m_listes[j] == AUCUN || executer(m_listes[j])) {
+          executer(m_listes[j + 1]);
+          break;
+        }
+      }
+      return 0;
+    case POUR:
+      for (n.a != AUCUN ? executer(n.a) : 0; executer(n.b); n.c != AUCUN ? executer(n.c) : 0)
+        executer(n.d);
+      return 0;
+    case LIRE:
+      for (unsigned int j = n.a; j < n.a + n.b; j++) m_emplacements[m_listes[j]] = Emplacement{Entree::lire(), true};
+      return 0;
+    case ECRIRE:
+      for (unsigned int j = n.a; j < n.a + n.b; j++) {
+        const NoeudAplati & parametre = m_noeuds[m_listes[j]];
+        if (parametre.genre == CHAINE) Sortie::ecrire(m_chaines[parametre.a]);
+        else Sortie::ecrire(executer(m_listes[j]));
+      }
+      return 0;
+    case CHAINE:
+      throw OperationInterditeException();
+    case INVARIANT:
+      if (!m_emplacements[n.a].defini) { // premier calcul depuis l'oubli
+        int valeur = executer(n.b);
+        m_emplacements[n.a] = Emplacement{valeur, true};
+      }
+      return m_emplacements[n.a].valeur;
+    case OUBLIER:
+      for (unsigned int j = n.a; j < n.a + n.b; j++) m_emplacements[m_listes[j]].defini = false;
+      return 0;
+    case AIGUILLAGE: {
+      const Emplacement & e = m_emplacements[n.a];
+      if (!e.defini) throw IndefiniException();
+      unsigned int rang = m_aiguillages[n.c]->choisir(e.valeur);
+      if (rang == NoeudInstAiguillage::AUCUNE) rang = n.d; // le sinon
+      if (m_listes[n.b + rang] != AUCUN) executer(m_listes[n.b + rang]);
+      return 0;
+    }
+  }
+  return 0;
+}
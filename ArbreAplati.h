@@ -0,0 +1,74 @@
+#ifndef ARBREAPLATI_H
+#define ARBREAPLATI_H
+
+// Arbre abstrait aplati : une autre représentation de l'arbre abstrait, où tous les noeuds sont des
+// enregistrements de même taille rangés dans un seul tableau et désignent leurs fils par leur indice
+// dans ce tableau (les fils d'un noeud sont rangés avant lui, la racine est le dernier noeud).
+// Les variables y sont désignées par leur emplacement dans la table des symboles.
+// Il est exécuté par un seul switch, sans appel virtuel.
+
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "ArbreAbstrait.h"
+#include "SymboleValue.h"
+
+class ArbreAplati {
+public:
+    ArbreAplati(const Noeud* racine, vector<Emplacement> & emplacements);
+    // Construit l'arbre aplati équivalent à l'arbre de racine racine (non nul),
+    //  dont les variables ont leurs valeurs dans emplacements
+    void executer(); // Exécute l'arbre, comme racine->executer()
+
+    inline unsigned int getTaille() const { return m_noeuds.size(); } // Nombre de noeuds
+
+private:
+    static const unsigned int AUCUN = ~0u; // Indice d'un fils absent
+
+    enum Genre : unsigned char {
+        SEQUENCE,    // a : premier fils dans m_listes, b : nombre d'instructions
+        AFFECTATION, // a : emplacement de la variable, b : expression
+        VARIABLE,    // a : emplacement de la variable
+        CONSTANTE,   // a : valeur
+        OPERATION,   // operateur : jeton de l'opérateur binaire, a : opérande gauche, b : opérande droit
+        OPERATION_UNAIRE, // operateur : J_MOINS ou J_NON, a : opérande
+        SI,          // a : condition, b : séquence
+        REPETER,     // a : séquence, b : condition
+        TANTQUE,     // a : condition, b : séquence
+        SIRICHE,     // a : premier couple (condition, séquence) dans m_listes, b : nombre de couples ;
+                     //  la condition d'un sinon est AUCUN
+        POUR,        // a : première affectation (ou AUCUN), b : condition, c : seconde affectation (ou AUCUN), d : séquence
+        LIRE,        // a : premier emplacement dans m_listes, b : nombre de variables
+        ECRIRE,      // a : premier paramètre dans m_listes, b : nombre de paramètres
+        CHAINE,      // a : indice de la chaîne dans m_chaines
+        INVARIANT,   // a : emplacement de la temporaire, b : expression
+        OUBLIER,     // a : premier emplacement dans m_listes, b : nombre de temporaires
+        AIGUILLAGE,  // a : emplacement de la variable, b : premier fils dans m_listes (les d séquences puis le sinon,
+                     //  ou AUCUN), c : indice dans m_aiguillages du noeud qui choisit la séquence, d : nombre de séquences
+        VARIABLE_SURE, // a : emplacement de la variable, certainement définie
+        DIVISION_SURE  // a : opérande gauche, b : opérande droit, jamais nul
+    };
+
+    struct NoeudAplati { // 20 octets
+        Genre         genre;
+        unsigned char operateur;
+        unsigned int  a, b, c, d;
+    };
+
+    unsigned int ajouter(const Noeud* noeud); // Ajoute noeud et ses descendants, renvoie l'indice de noeud
+    unsigned int ajouter(Genre genre, unsigned int a = 0, unsigned int b = 0, unsigned int c = 0, unsigned int d = 0,
+                         unsigned char operateur = 0); // Ajoute un noeud, renvoie son indice
+    unsigned int ajouterListe(const vector<unsigned int> & elements); // Ajoute une liste, renvoie son début
+    static unsigned int emplacement(const Noeud* variable); // Emplacement d'une variable (SymboleValue)
+
+    int executer(unsigned int i); // Exécute le ième noeud
+
+    vector<NoeudAplati>  m_noeuds;       // Les noeuds
+    vector<unsigned int> m_listes;       // Les fils des noeuds qui en ont un nombre variable, à la suite
+    vector<string>       m_chaines;      // Les chaînes littérales
+    vector<const NoeudInstAiguillage*> m_aiguillages; // Les aiguillages de l'arbre (pour leur table ou leur index)
+    vector<Emplacement> & m_emplacements; // Les valeurs des variables
+};
+
+#endif /* ARBREAPLATI_H */
@@ -0,0 +1,51 @@
+#include "Arene.h"
+#include <cstdint>
+
+Arene::Arene(size_t tailleBloc)
+: m_tailleBloc(tailleBloc), m_blocs(), m_courant(nullptr), m_fin(nullptr), m_finaliseurs(nullptr),
+  m_octetsUtilises(0), m_octetsReserves(0) {
+}
+
+Arene::~Arene() {
+  for (Finaliseur* f = m_finaliseurs; f != nullptr; f = f->precedent) f->detruire(f->objet);
+  for (unsigned int i = 0; i < m_blocs.size(); i++) ::operator delete(m_blocs[i]);
+}
+
+void* Arene::allouer(size_t taille, size_t alignement) {
+  uintptr_t adresse = ((uintptr_t) m_courant + alignement - 1) & ~(uintptr_t) (alignement - 1);
+  if (m_courant == nullptr || adresse + taille > (uintptr_t) m_fin) { // pas la place : nouveau bloc
+    size_t tailleBloc = (taille + alignement > m_tailleBloc) ? taille + alignement : m_tailleBloc;
+    char* bloc = (char*) ::operator new(tailleBloc); // aligné pour tout type de base
+    m_blocs.push_back(bloc);
+    m_fin = bloc + tailleBloc;
+    m_octetsReserves += tailleBloc;
+    adresse = ((uintptr_t) bloc + alignement - 1) & ~(uintptr_t) (alignement - 1);
+  }
+  m_courant = (char*) (adresse + taille);
+  m_octetsUtilises += taille;
+  return (void*) adresse;
+}
+
+void Arene::ajouterFinaliseur(void* objet, void (*detruire)(void*)) {
+  Finaliseur* f = new (allouer(sizeof(Finaliseur), alignof(Finaliseur))) Finaliseur;
+  f->objet = objet;
+  f->detruire = detruire;
+  f->precedent = m_finaliseurs;
+  m_finaliseurs = f;
+}
+
+Arene::Marque Arene::marquer() const {
+  return Marque{ m_blocs.size(), m_courant, m_fin, m_finaliseurs, m_octetsUtilises, m_octetsReserves };
+}
+
+void Arene::revenir(const Marque & marque) {
+  for (; m_finaliseurs != marque.finaliseurs; m_finaliseurs = m_finaliseurs->precedent)
+    m_finaliseurs->detruire(m_finaliseurs->objet);
+  // les blocs alloués depuis la marque sont rendus ; le bloc courant de la marque resservira à partir de sa place libre
+  for (size_t i = marque.nombreBlocs; i < m_blocs.size(); i++) ::operator delete(m_blocs[i]);
+  m_blocs.resize(marque.nombreBlocs);
+  m_courant = marque.courant;
+  m_fin = marque.fin;
+  m_octetsUtilises = marque.octetsUtilises;
+  m_octetsReserves = marque.octetsReserves;
+}
@@ -0,0 +1,77 @@
+#ifndef ARENE_H
+#define ARENE_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <vector>
+using namespace std;
+
+// Arène : réserve de mémoire où les objets d'un même programme (noeuds de l'arbre abstrait,
+// symboles valués, ...) sont alloués les uns à la suite des autres, par blocs, sans passer par new.
+// Tous les objets de l'arène sont détruits d'un coup, dans l'ordre inverse de leur création,
+// quand l'arène elle-même est détruite : il ne faut donc jamais faire delete sur un de ces objets.
+
+class Arene {
+public:
+    Arene(size_t tailleBloc = 64 * 1024); // Construit une arène vide qui alloue par blocs de tailleBloc octets
+    ~Arene();                             // Détruit tous les objets de l'arène et rend ses blocs
+    Arene(const Arene &) = delete;        // les objets alloués appartiennent à l'arène : on ne la copie pas
+    Arene & operator=(const Arene &) = delete;
+
+    void* allouer(size_t taille, size_t alignement = alignof(max_align_t));
+    // Renvoie taille octets (non initialisés) alignés sur alignement, valables jusqu'à la destruction de l'arène
+
+    template <class T, class... Arguments>
+    T* creer(Arguments&&... arguments) {
+        T* objet = new (allouer(sizeof(T), alignof(T))) T(std::forward<Arguments>(arguments)...);
+        if (!is_trivially_destructible<T>::value) ajouterFinaliseur(objet, &detruire<T>);
+        return objet;
+    } // Construit un T dans l'arène ; son destructeur sera appelé à la destruction de l'arène
+
+    struct Marque {           // L'état de l'arène à un instant (voir marquer)
+        size_t      nombreBlocs;
+        char*       courant;
+        char*       fin;
+        void*       finaliseurs;    // Le dernier Finaliseur
+        size_t      octetsUtilises;
+        size_t      octetsReserves;
+    };
+    Marque marquer() const;   // Renvoie l'état actuel de l'arène
+    void revenir(const Marque & marque);
+    // Détruit les objets créés depuis marque (dans l'ordre inverse de leur création) et rend leur place :
+    //  l'arène est remise dans l'état de marque, les objets créés avant restent valables
+
+    inline size_t octetsUtilises() const {
+        return m_octetsUtilises;
+    } // Nombre d'octets alloués dans l'arène (objets et finaliseurs)
+
+    inline size_t octetsReserves() const {
+        return m_octetsReserves;
+    } // Nombre d'octets des blocs de l'arène
+
+private:
+    struct Finaliseur {       // Destruction à faire d'un objet de l'arène
+        void*       objet;
+        void      (*detruire)(void*);
+        Finaliseur* precedent; // Finaliseur de l'objet créé juste avant, nullptr pour le premier
+    };
+
+    template <class T>
+    static void detruire(void* objet) {
+        static_cast<T*>(objet)->~T();
+    }
+
+    void ajouterFinaliseur(void* objet, void (*detruire)(void*));
+
+    size_t         m_tailleBloc;
+    vector<char*>  m_blocs;          // Les blocs alloués, le dernier est le bloc courant
+    char*          m_courant;        // Premier octet libre du bloc courant
+    char*          m_fin;            // Fin du bloc courant
+    Finaliseur*    m_finaliseurs;    // Finaliseur du dernier objet créé
+    size_t         m_octetsUtilises;
+    size_t         m_octetsReserves;
+};
+
+#endif /* ARENE_H */
@@ -0,0 +1,197 @@
+#include "Balayeur.h"
+
+#if defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))
+#define BALAYEUR_X86
+#include <immintrin.h>
+#define CIBLE_AVX2 __attribute__((target("avx2")))
+#endif
+
+// Chaque classe de caractères ci-dessous dit quels caractères arrêtent le balayage :
+//  arret() pour un caractère, masque16()/masque32() pour 16/32 caractères à la fois
+//  (bit i du masque à 1 si le caractère p[i] arrête le balayage).
+// Les lettres et les chiffres sont ceux de isalpha()/isdigit() dans la locale "C" (ASCII).
+
+static inline bool estLettre(unsigned char c) {
+  return (unsigned char) ((c | 0x20) - 'a') < 26;
+}
+
+static inline bool estChiffre(unsigned char c) {
+  return (unsigned char) (c - '0') < 10;
+}
+
+#ifdef BALAYEUR_X86
+static inline __m128i egal16(__m128i v, char c) {
+  return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+static inline __m128i dansIntervalle16(__m128i v, char min, unsigned char etendue) {
+  // (v - min) <= etendue, en comparaison non signée
+  __m128i d = _mm_sub_epi8(v, _mm_set1_epi8(min));
+  return _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8((char) etendue)), d);
+}
+
+CIBLE_AVX2 static inline __m256i egal32(__m256i v, char c) {
+  return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+}
+
+CIBLE_AVX2 static inline __m256i dansIntervalle32(__m256i v, char min, unsigned char etendue) {
+  __m256i d = _mm256_sub_epi8(v, _mm256_set1_epi8(min));
+  return _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8((char) etendue)), d);
+}
+#endif
+
+struct ArretNonBlanc {
+  static inline bool arret(unsigned char c) {
+    return c != ' ' && c != '\t' && c != '\r' && c != '\n';
+  }
+#ifdef BALAYEUR_X86
+  static inline unsigned int masque16(const char* p) {
+    __m128i v = _mm_loadu_si128((const __m128i*) p);
+    __m128i blanc = _mm_or_si128(_mm_or_si128(egal16(v, ' '), egal16(v, '\t')),
+                                 _mm_or_si128(egal16(v, '\r'), egal16(v, '\n')));
+    return ~_mm_movemask_epi8(blanc) & 0xFFFF;
+  }
+  CIBLE_AVX2 static inline unsigned int masque32(const char* p) {
+    __m256i v = _mm256_loadu_si256((const __m256i*) p);
+    __m256i blanc = _mm256_or_si256(_mm256_or_si256(egal32(v, ' '), egal32(v, '\t')),
+                                    _mm256_or_si256(egal32(v, '\r'), egal32(v, '\n')));
+    return ~(unsigned int) _mm256_movemask_epi8(blanc);
+  }
+#endif
+};
+
+struct ArretFinLigne {
+  static inline bool arret(unsigned char c) {
+    return c == '\r' || c == '\n' || c == 0xFF;
+  }
+#ifdef BALAYEUR_X86
+  static inline unsigned int masque16(const char* p) {
+    __m128i v = _mm_loadu_si128((const __m128i*) p);
+    return _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(egal16(v, '\r'), egal16(v, '\n')), egal16(v, (char) 0xFF)));
+  }
+  CIBLE_AVX2 static inline unsigned int masque32(const char* p) {
+    __m256i v = _mm256_loadu_si256((const __m256i*) p);
+    return _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(egal32(v, '\r'), egal32(v, '\n')), egal32(v, (char) 0xFF)));
+  }
+#endif
+};
+
+struct ArretFinChaine {
+  static inline bool arret(unsigned char c) {
+    return c == '"' || c == '\n' || c == 0xFF;
+  }
+#ifdef BALAYEUR_X86
+  static inline unsigned int masque16(const char* p) {
+    __m128i v = _mm_loadu_si128((const __m128i*) p);
+    return _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(egal16(v, '"'), egal16(v, '\n')), egal16(v, (char) 0xFF)));
+  }
+  CIBLE_AVX2 static inline unsigned int masque32(const char* p) {
+    __m256i v = _mm256_loadu_si256((const __m256i*) p);
+    return _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(egal32(v, '"'), egal32(v, '\n')), egal32(v, (char) 0xFF)));
+  }
+#endif
+};
+
+struct ArretNonChiffre {
+  static inline bool arret(unsigned char c) {
+    return !estChiffre(c);
+  }
+#ifdef BALAYEUR_X86
+  static inline unsigned int masque16(const char* p) {
+    __m128i v = _mm_loadu_si128((const __m128i*) p);
+    return ~_mm_movemask_epi8(dansIntervalle16(v, '0', 9)) & 0xFFFF;
+  }
+  CIBLE_AVX2 static inline unsigned int masque32(const char* p) {
+    __m256i v = _mm256_loadu_si256((const __m256i*) p);
+    return ~(unsigned int) _mm256_movemask_epi8(dansIntervalle32(v, '0', 9));
+  }
+#endif
+};
+
+struct ArretNonMot {
+  static inline bool arret(unsigned char c) {
+    return !estLettre(c) && !estChiffre(c) && c != '_';
+  }
+#ifdef BALAYEUR_X86
+  static inline unsigned int masque16(const char* p) {
+    __m128i v = _mm_loadu_si128((const __m128i*) p);
+    __m128i lettre = dansIntervalle16(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 25);
+    __m128i mot = _mm_or_si128(_mm_or_si128(lettre, dansIntervalle16(v, '0', 9)), egal16(v, '_'));
+    return ~_mm_movemask_epi8(mot) & 0xFFFF;
+  }
+  CIBLE_AVX2 static inline unsigned int masque32(const char* p) {
+    __m256i v = _mm256_loadu_si256((const __m256i*) p);
+    __m256i lettre = dansIntervalle32(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 25);
+    __m256i mot = _mm256_or_si256(_mm256_or_si256(lettre, dansIntervalle32(v, '0', 9)), egal32(v, '_'));
+    return ~(unsigned int) _mm256_movemask_epi8(mot);
+  }
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Les trois versions de chaque noyau
+////////////////////////////////////////////////////////////////////////////////
+
+template <class Classe>
+static const char* balayerScalaire(const char* debut, const char* fin) {
+  while (debut < fin && !Classe::arret((unsigned char) *debut)) debut++;
+  return debut;
+}
+
+#ifdef BALAYEUR_X86
+template <class Classe>
+static const char* balayerSse2(const char* debut, const char* fin) {
+  // on ne lit jamais au delà de fin : les derniers caractères sont examinés un par un
+  while (fin - debut >= 16) {
+    unsigned int masque = Classe::masque16(debut);
+    if (masque != 0) return debut + __builtin_ctz(masque);
+    debut += 16;
+  }
+  return balayerScalaire<Classe>(debut, fin);
+}
+
+template <class Classe>
+CIBLE_AVX2 static const char* balayerAvx2(const char* debut, const char* fin) {
+  while (fin - debut >= 32) {
+    unsigned int masque = Classe::masque32(debut);
+    if (masque != 0) return debut + __builtin_ctz(masque);
+    debut += 32;
+  }
+  return balayerSse2<Classe>(debut, fin);
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Choix des noyaux
+////////////////////////////////////////////////////////////////////////////////
+
+#define NOYAUX(jeu, balayer) { jeu, balayer<ArretNonBlanc>, balayer<ArretFinLigne>, \
+  balayer<ArretNonMot>, balayer<ArretNonChiffre>, balayer<ArretFinChaine> }
+
+const Balayeur::Noyaux* Balayeur::s_noyaux = nullptr;
+
+Balayeur::JeuInstructions Balayeur::getJeuInstructions() {
+  return noyaux().jeu;
+}
+
+Balayeur::JeuInstructions Balayeur::meilleurJeu() {
+#ifdef BALAYEUR_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return AVX2;
+  return SSE2;
+#else
+  return SCALAIRE;
+#endif
+}
+
+void Balayeur::choisir(JeuInstructions jeu) {
+  static const Noyaux scalaires = NOYAUX(SCALAIRE, balayerScalaire);
+#ifdef BALAYEUR_X86
+  static const Noyaux sse2 = NOYAUX(SSE2, balayerSse2);
+  static const Noyaux avx2 = NOYAUX(AVX2, balayerAvx2);
+  if (jeu > meilleurJeu()) jeu = meilleurJeu();
+  s_noyaux = (jeu == AVX2) ? &avx2 : (jeu == SSE2) ? &sse2 : &scalaires;
+#else
+  s_noyaux = &scalaires;
+#endif
+}
@@ -0,0 +1,52 @@
+#ifndef BALAYEUR_H
+#define BALAYEUR_H
+
+// Noyaux de balayage utilisés par le lecteur pour sauter d'un coup des suites de caractères.
+// Chaque noyau renvoie l'adresse du premier caractère de [debut, fin) qui arrête le balayage, ou fin.
+// Ils existent en version scalaire, SSE2 (16 caractères à la fois) et AVX2 (32 caractères à la fois) ;
+// la meilleure version disponible sur le processeur est choisie au premier appel.
+// Comme le lecteur de caractères, ils considèrent le caractère de code 0xFF comme EOF.
+
+class Balayeur {
+public:
+    enum JeuInstructions { SCALAIRE, SSE2, AVX2 };
+
+    static inline const char* sauterBlancs(const char* debut, const char* fin) {
+        return noyaux().sauterBlancs(debut, fin);
+    } // Premier caractère qui n'est ni ' ', ni '\t', ni '\r', ni '\n'
+
+    static inline const char* finLigne(const char* debut, const char* fin) {
+        return noyaux().finLigne(debut, fin);
+    } // Premier '\r', '\n' ou EOF (fin d'un commentaire)
+
+    static inline const char* finMot(const char* debut, const char* fin) {
+        return noyaux().finMot(debut, fin);
+    } // Premier caractère qui n'est ni une lettre, ni un chiffre, ni '_'
+
+    static inline const char* finEntier(const char* debut, const char* fin) {
+        return noyaux().finEntier(debut, fin);
+    } // Premier caractère qui n'est pas un chiffre
+
+    static inline const char* finChaine(const char* debut, const char* fin) {
+        return noyaux().finChaine(debut, fin);
+    } // Premier '"', '\n' ou EOF (fin d'une chaîne)
+
+    static JeuInstructions getJeuInstructions(); // Jeu d'instructions des noyaux utilisés
+    static JeuInstructions meilleurJeu();        // Meilleur jeu d'instructions disponible sur ce processeur
+    static void choisir(JeuInstructions jeu);    // Impose un jeu d'instructions (pour les mesures et ComparateurLecteurs),
+                                                 //  ramené au meilleur disponible s'il n'est pas supporté
+private:
+    typedef const char* (*Noyau)(const char* debut, const char* fin);
+    struct Noyaux {
+        JeuInstructions jeu;
+        Noyau sauterBlancs, finLigne, finMot, finEntier, finChaine;
+    };
+    static const Noyaux* s_noyaux; // Les noyaux choisis, nullptr tant qu'on n'a pas choisi
+
+    static inline const Noyaux & noyaux() {
+        if (s_noyaux == nullptr) choisir(meilleurJeu());
+        return *s_noyaux;
+    }
+};
+
+#endif /* BALAYEUR_H */
@@ -0,0 +1,365 @@
+#include "Bytecode.h"
+#include "SymboleValue.h"
+#include "Optimiseur.h"
+#include <algorithm>
+
+Bytecode::Bytecode(const Noeud* racine)
+: m_code(), m_instructions(nullptr), m_taille(0), m_chaines(), m_profondeur(0), m_profondeurMax(0) {
+  traduire(racine);
+  emettre(FIN);
+  m_instructions = m_code.data();
+  m_taille = m_code.size();
+}
+
+Bytecode::Bytecode(const int* code, unsigned int taille, const vector<string> & chaines, unsigned int profondeurMax)
+: m_code(), m_instructions(code), m_taille(taille), m_chaines(chaines), m_profondeur(0), m_profondeurMax(profondeurMax) {
+}
+
+bool Bytecode::contient(Operation operation) const {
+  for (unsigned int pc = 0; pc < m_taille; pc += 1 + getNombreOperandes(m_instructions + pc))
+    if (m_instructions[pc] == operation) return true;
+  return false;
+}
+
+bool Bytecode::estCoherent(unsigned int nombreEmplacements, unsigned int nombreChaines) const {
+  vector<bool> debuts(m_taille, false); // vrai au début de chaque instruction
+  unsigned int derniere = m_taille;
+  for (unsigned int pc = 0; pc < m_taille; ) {
+    if (m_instructions[pc] < 0 || m_instructions[pc] >= NB_OPERATIONS) return false;
+    if (m_instructions[pc] == AIGUILLER // son nombre de cibles doit être lisible et raisonnable
+        && (m_taille - pc < 3 || m_instructions[pc + 2] < 1 || (unsigned int) m_instructions[pc + 2] > m_taille)) return false;
+    unsigned int suivante = pc + 1 + getNombreOperandes(m_instructions + pc);
+    if (suivante > m_taille) return false;
+    debuts[pc] = true;
+    derniere = pc;
+    pc = suivante;
+  }
+  if (derniere == m_taille || m_instructions[derniere] != FIN) return false;
+  for (unsigned int pc = 0; pc < m_taille; pc += 1 + getNombreOperandes(m_instructions + pc)) {
+    Operation operation = (Operation) m_instructions[pc];
+    if (getNombreOperandes(m_instructions + pc) == 0) continue;
+    unsigned int operande = m_instructions[pc + 1];
+    switch (operation) {
+      case CHARGER: case CHARGER_SUR: case RANGER: case LIRE: case TESTER: case OUBLIER:
+        if (operande >= nombreEmplacements) return false;
+        break;
+      case ECRIRE_CHAINE:
+        if (operande >= nombreChaines) return false;
+        break;
+      case SAUTER: case SAUTER_SI_FAUX: case SAUTER_SI_VRAI: case ET_ALORS: case OU_SINON:
+        if (operande >= m_taille || !debuts[operande]) return false;
+        break;
+      case AIGUILLER: // les cibles, puis celle du sinon
+        for (unsigned int i = 0; i <= (unsigned int) m_instructions[pc + 2]; i++) {
+          unsigned int cible = m_instructions[pc + 3 + i];
+          if (cible >= m_taille || !debuts[cible]) return false;
+        }
+        break;
+      default: // EMPILER : toute valeur convient
+        break;
+    }
+  }
+  return true;
+}
+
+unsigned int Bytecode::getNombreOperandes(const int* instruction) {
+  switch (instruction[0]) {
+    case CHARGER: case CHARGER_SUR: case EMPILER: case RANGER: case SAUTER: case SAUTER_SI_FAUX: case SAUTER_SI_VRAI:
+    case ET_ALORS: case OU_SINON: case ECRIRE_CHAINE: case LIRE: case TESTER: case OUBLIER:
+      return 1;
+    case AIGUILLER:
+      return 3 + instruction[2];
+    default:
+      return 0;
+  }
+}
+
+void Bytecode::emettre(Operation operation) {
+  m_code.push_back(operation);
+}
+
+void Bytecode::emettre(Operation operation, int operande) {
+  m_code.push_back(operation);
+  m_code.push_back(operande);
+}
+
+unsigned int Bytecode::emettreSaut(Operation saut) {
+  emettre(saut, 0);
+  return m_code.size() - 1;
+}
+
+void Bytecode::fixer(unsigned int indiceCible) {
+  m_code[indiceCible] = m_code.size();
+}
+
+void Bytecode::empiler(int nombre) {
+  m_profondeur += nombre;
+  if (m_profondeur > m_profondeurMax) m_profondeurMax = m_profondeur;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Traduction de chaque genre de noeud
+////////////////////////////////////////////////////////////////////////////////
+
+static Bytecode::Operation operationBinaire(Jeton operateur) {
+  switch (operateur) {
+    case J_PLUS:           return Bytecode::ADDITION;
+    case J_MOINS:          return Bytecode::SOUSTRACTION;
+    case J_MULTIPLICATION: return Bytecode::MULTIPLICATION;
+    case J_DIVISION:       return Bytecode::DIVISION;
+    case J_EGAL:           return Bytecode::EGAL;
+    case J_DIFFERENT:      return Bytecode::DIFFERENT;
+    case J_INFERIEUR:      return Bytecode::INFERIEUR;
+    case J_INFERIEUREGAL:  return Bytecode::INFERIEUREGAL;
+    case J_SUPERIEUR:      return Bytecode::SUPERIEUR;
+    case J_SUPERIEUREGAL:  return Bytecode::SUPERIEUREGAL;
+    default:               throw OperationInterditeException(); // et, ou : voir traduire()
+  }
+}
+
+// Vrai si la valeur de expression est toujours 0 ou 1
+static bool estBooleenne(const Noeud* expression) {
+  int valeur;
+  if (Optimiseur::estConstante(expression, valeur)) return valeur == 0 || valeur == 1;
+  if (expression->getGenre() == N_OPERATEURUNAIRE) return ((const NoeudOperateurUnaire*) expression)->getOperateur() == J_NON;
+  if (expression->getGenre() != N_OPERATEURBINAIRE) return false;
+  Jeton operateur = ((const NoeudOperateurBinaire*) expression)->getOperateur();
+  return operateur != J_PLUS && operateur != J_MOINS && operateur != J_MULTIPLICATION && operateur != J_DIVISION;
+}
+
+void Bytecode::traduire(const Noeud* noeud) {
+  switch (noeud->getGenre()) {
+    case N_SEQINST: {
+      const vector<Noeud*> & instructions = ((const NoeudSeqInst*) noeud)->getInstructions();
+      for (unsigned int i = 0; i < instructions.size(); i++) traduire(instructions[i]);
+      return;
+    }
+    case N_AFFECTATION: {
+      const NoeudAffectation* affectation = (const NoeudAffectation*) noeud;
+      traduire(affectation->getExpression());
+      emettre(RANGER, ((const SymboleValue*) affectation->getVariable())->getNumero());
+      empiler(-1);
+      return;
+    }
+    case N_SYMBOLEVALUE: {
+      const SymboleValue* symbole = (const SymboleValue*) noeud;
+      if (*symbole == "<ENTIER>") emettre(EMPILER, symbole->getValeur());
+      else emettre(CHARGER, symbole->getNumero());
+      empiler(1);
+      return;
+    }
+    case N_VARIABLESURE:
+      emettre(CHARGER_SUR, ((const SymboleValue*) ((const NoeudVariableSure*) noeud)->getVariable())->getNumero());
+      empiler(1);
+      return;
+    case N_CONSTANTE:
+      emettre(EMPILER, ((const NoeudConstante*) noeud)->getValeur());
+      empiler(1);
+      return;
+    case N_OPERATEURBINAIRE: {
+      const NoeudOperateurBinaire* operation = (const NoeudOperateurBinaire*) noeud;
+      traduire(operation->getOperandeGauche());
+      if (operation->getOperateur() == J_ET || operation->getOperateur() == J_OU) {
+        //   gauche ; ET_ALORS fin (OU_SINON fin) ; droit ; BOOLEEN ; fin:
+        unsigned int fin = emettreSaut(operation->getOperateur() == J_ET ? ET_ALORS : OU_SINON);
+        empiler(-1);
+        traduire(operation->getOperandeDroit());
+        if (!estBooleenne(operation->getOperandeDroit())) emettre(BOOLEEN);
+        fixer(fin);
+        return;
+      }
+      traduire(operation->getOperandeDroit());
+      emettre(operationBinaire(operation->getOperateur()));
+      empiler(-1);
+      return;
+    }
+    case N_DIVISIONSURE:
+      traduire(((const NoeudOperateurBinaire*) noeud)->getOperandeGauche());
+      traduire(((const NoeudOperateurBinaire*) noeud)->getOperandeDroit());
+      emettre(DIVISION_SURE);
+      empiler(-1);
+      return;
+    case N_OPERATEURUNAIRE: {
+      const NoeudOperateurUnaire* operation = (const NoeudOperateurUnaire*) noeud;
+      traduire(operation->getOperande());
+      emettre(operation->getOperateur() == J_MOINS ? OPPOSE : NEGATION);
+      return;
+    }
+    case N_SI: { //   condition ; SAUTER_SI_FAUX fin ; sequence ; fin:
+      const NoeudInstSi* si = (const NoeudInstSi*) noeud;
+      traduire(si->getCondition());
+      unsigned int fin = emettreSaut(SAUTER_SI_FAUX);
+      empiler(-1);
+      traduire(si->getSequence());
+      fixer(fin);
+      return;
+    }
+    case N_SIRICHE: { // pour chaque branche : condition ; SAUTER_SI_FAUX suivante ; sequence ; SAUTER fin ; suivante:
+      const NoeudInstSiRiche* siRiche = (const NoeudInstSiRiche*) noeud;
+      vector<unsigned int> fins;
+      for (unsigned int i = 0; i < siRiche->getConditions().size(); i++) {
+        const Noeud* condition = siRiche->getConditions()[i];
+        if (condition == nullptr) { // sinon
+          traduire(siRiche->getSequences()[i]);
+          break;
+        }
+        traduire(condition);
+        unsigned int suivante = emettreSaut(SAUTER_SI_FAUX);
+        empiler(-1);
+        traduire(siRiche->getSequences()[i]);
+        fins.push_back(emettreSaut(SAUTER));
+        fixer(suivante);
+      }
+      for (unsigned int i = 0; i < fins.size(); i++) fixer(fins[i]);
+      return;
+    }
+    case N_TANTQUE: { //   SAUTER test ; debut: sequence ; test: condition ; SAUTER_SI_VRAI debut
+      const NoeudInstTantQue* tantQue = (const NoeudInstTantQue*) noeud;
+      unsigned int test = emettreSaut(SAUTER);
+      unsigned int debut = m_code.size();
+      traduire(tantQue->getSequence());
+      fixer(test);
+      traduire(tantQue->getCondition());
+      emettre(SAUTER_SI_VRAI, debut);
+      empiler(-1);
+      return;
+    }
+    case N_REPETER: { //   SAUTER test ; debut: sequence ; test: condition ; SAUTER_SI_FAUX debut
+      const NoeudInstRepeter* repeter = (const NoeudInstRepeter*) noeud;
+      unsigned int test = emettreSaut(SAUTER);
+      unsigned int debut = m_code.size();
+      traduire(repeter->getSequence());
+      fixer(test);
+      traduire(repeter->getCondition());
+      emettre(SAUTER_SI_FAUX, debut);
+      empiler(-1);
+      return;
+    }
+    case N_POUR: { //   affectation1 ; SAUTER test ; debut: sequence ; affectation2 ; test: condition ; SAUTER_SI_VRAI debut
+      const NoeudInstPour* pour = (const NoeudInstPour*) noeud;
+      if (pour->getAffectation1() != nullptr) traduire(pour->getAffectation1());
+      unsigned int test = emettreSaut(SAUTER);
+      unsigned int debut = m_code.size();
+      traduire(pour->getSequence());
+      if (pour->getAffectation2() != nullptr) traduire(pour->getAffectation2());
+      fixer(test);
+      traduire(pour->getCondition());
+      emettre(SAUTER_SI_VRAI, debut);
+      empiler(-1);
+      return;
+    }
+    case N_LIRE: {
+      const vector<Noeud*> & variables = ((const NoeudInstLire*) noeud)->getVariables();
+      for (unsigned int i = 0; i < variables.size(); i++)
+        emettre(LIRE, ((const SymboleValue*) variables[i])->getNumero());
+      return;
+    }
+    case N_ECRIRE: {
+      const vector<Noeud*> & parametres = ((const NoeudInstEcrire*) noeud)->getParametres();
+      for (unsigned int i = 0; i < parametres.size(); i++) {
+        if (parametres[i]->getGenre() == N_CHAINE) {
+          m_chaines.push_back(((const NoeudChaine*) parametres[i])->getChaine());
+          emettre(ECRIRE_CHAINE, m_chaines.size() - 1);
+        } else {
+          traduire(parametres[i]);
+          emettre(ECRIRE_VALEUR);
+          empiler(-1);
+        }
+      }
+      return;
+    }
+    case N_AIGUILLAGE:
+      traduireAiguillage((const NoeudInstAiguillage*) noeud);
+      return;
+    case N_INVARIANT: { //   TESTER t ; SAUTER_SI_VRAI calcule ; expression ; RANGER t ; calcule: CHARGER t
+      const NoeudInvariant* invariant = (const NoeudInvariant*) noeud;
+      unsigned int temporaire = ((const SymboleValue*) invariant->getTemporaire())->getNumero();
+      emettre(TESTER, temporaire);
+      empiler(1);
+      unsigned int calcule = emettreSaut(SAUTER_SI_VRAI);
+      empiler(-1);
+      traduire(invariant->getExpression());
+      emettre(RANGER, temporaire);
+      empiler(-1);
+      fixer(calcule);
+      emettre(CHARGER, temporaire);
+      empiler(1);
+      return;
+    }
+    case N_OUBLIER: {
+      const vector<Noeud*> & temporaires = ((const NoeudInstOublier*) noeud)->getTemporaires();
+      for (unsigned int i = 0; i < temporaires.size(); i++)
+        emettre(OUBLIER, ((const SymboleValue*) temporaires[i])->getNumero());
+      return;
+    }
+    case N_CHAINE:
+      break;
+  }
+  throw OperationInterditeException(); // une chaîne ne s'évalue pas
+}
+
+void Bytecode::traduireAiguillage(const NoeudInstAiguillage* aiguillage) {
+  // table :     CHARGER v ; AIGUILLER minimum, nombre, cibles..., sinon
+  // recherche : comparaisons de v aux valeurs (traduireRecherche)
+  // puis :      pour chaque séquence : debut: sequence ; SAUTER fin   et enfin   sinon: sinon ; fin:
+  vector<pair<unsigned int, unsigned int> > sauts; // indice d'une cible à fixer, rang de sa séquence
+  if (aiguillage->estDense()) {
+    traduire(aiguillage->getVariable());
+    unsigned int nombre = (unsigned int) aiguillage->getMaximum() - (unsigned int) aiguillage->getMinimum() + 1;
+    emettre(AIGUILLER, aiguillage->getMinimum());
+    m_code.push_back(nombre);
+    for (unsigned int i = 0; i < nombre; i++) {
+      sauts.push_back(make_pair((unsigned int) m_code.size(), aiguillage->choisir(aiguillage->getMinimum() + (int) i)));
+      m_code.push_back(0);
+    }
+    sauts.push_back(make_pair((unsigned int) m_code.size(), NoeudInstAiguillage::AUCUNE));
+    m_code.push_back(0);
+    empiler(-1);
+  } else {
+    vector<pair<int, unsigned int> > valeurs; // chaque valeur (sans double) avec le rang de sa séquence
+    for (int valeur : aiguillage->getValeurs()) valeurs.push_back(make_pair(valeur, aiguillage->choisir(valeur)));
+    sort(valeurs.begin(), valeurs.end());
+    valeurs.erase(unique(valeurs.begin(), valeurs.end()), valeurs.end());
+    traduireRecherche(aiguillage->getVariable(), valeurs, 0, valeurs.size(), sauts);
+  }
+  vector<unsigned int> debuts, fins;
+  for (unsigned int i = 0; i < aiguillage->getSequences().size(); i++) {
+    debuts.push_back(m_code.size());
+    traduire(aiguillage->getSequences()[i]);
+    fins.push_back(emettreSaut(SAUTER));
+  }
+  unsigned int sinon = m_code.size();
+  if (aiguillage->getSinon() != nullptr) traduire(aiguillage->getSinon());
+  for (unsigned int i = 0; i < sauts.size(); i++)
+    m_code[sauts[i].first] = sauts[i].second == NoeudInstAiguillage::AUCUNE ? sinon : debuts[sauts[i].second];
+  for (unsigned int i = 0; i < fins.size(); i++) fixer(fins[i]);
+}
+
+void Bytecode::traduireRecherche(const Noeud* variable, const vector<pair<int, unsigned int> > & valeurs,
+                                 unsigned int debut, unsigned int fin, vector<pair<unsigned int, unsigned int> > & sauts) {
+  if (fin - debut <= 4) { // peu de valeurs : CHARGER v ; EMPILER valeur ; EGAL ; SAUTER_SI_VRAI sequence ... SAUTER sinon
+    for (unsigned int i = debut; i < fin; i++) {
+      traduire(variable);
+      emettre(EMPILER, valeurs[i].first);
+      empiler(1);
+      emettre(EGAL);
+      empiler(-1);
+      sauts.push_back(make_pair(emettreSaut(SAUTER_SI_VRAI), valeurs[i].second));
+      empiler(-1);
+    }
+    sauts.push_back(make_pair(emettreSaut(SAUTER), NoeudInstAiguillage::AUCUNE));
+    return;
+  }
+  //   CHARGER v ; EMPILER valeur du milieu ; INFERIEUR ; SAUTER_SI_VRAI gauche ; moitié droite ; gauche: moitié gauche
+  unsigned int milieu = (debut + fin) / 2;
+  traduire(variable);
+  emettre(EMPILER, valeurs[milieu].first);
+  empiler(1);
+  emettre(INFERIEUR);
+  empiler(-1);
+  unsigned int gauche = emettreSaut(SAUTER_SI_VRAI);
+  empiler(-1);
+  traduireRecherche(variable, valeurs, milieu, fin, sauts);
+  fixer(gauche);
+  traduireRecherche(variable, valeurs, debut, milieu, sauts);
+}
@@ -0,0 +1,87 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+// Bytecode : traduction de l'arbre abstrait en une suite d'instructions pour une machine à pile
+// (voir MachineVirtuelle.h). Chaque instruction est un mot (son code) suivi de ses opérandes éventuels,
+// un mot chacun. Les expressions empilent leurs opérandes puis les remplacent par leur résultat ;
+// les instructions si, sinonsi, tantque, repeter et pour deviennent des sauts (conditionnels ou non)
+// vers l'indice d'une instruction dans le code, et l'opérande droit de et/ou est sauté quand le gauche
+// suffit. Un aiguillage (NoeudInstAiguillage) devient une table de sauts s'il est dense, sinon une
+// recherche dichotomique parmi ses valeurs.
+
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "ArbreAbstrait.h"
+
+class Bytecode {
+public:
+    enum Operation {    // opérandes entre parenthèses, effet sur la pile
+        CHARGER,        // (emplacement)  empile la valeur de la variable, IndefiniException si elle est indéfinie
+        CHARGER_SUR,    // (emplacement)  empile la valeur de la variable, certainement définie (NoeudVariableSure)
+        EMPILER,        // (valeur)       empile une constante
+        RANGER,         // (emplacement)  dépile une valeur et l'affecte à la variable
+        ADDITION, SOUSTRACTION, MULTIPLICATION, DIVISION, // dépilent d puis g, empilent g op d
+        DIVISION_SURE,  //                idem, d n'est jamais nul (NoeudDivisionSure)
+        EGAL, DIFFERENT, INFERIEUR, INFERIEUREGAL, SUPERIEUR, SUPERIEUREGAL,
+        OPPOSE, NEGATION, BOOLEEN, // remplacent le sommet x par -x / !x / x != 0
+        SAUTER,         // (cible)        continue à l'instruction cible
+        SAUTER_SI_FAUX, // (cible)        dépile une valeur, saute si elle est nulle
+        SAUTER_SI_VRAI, // (cible)        dépile une valeur, saute si elle n'est pas nulle
+        ET_ALORS,       // (cible)        si le sommet est nul, saute en le laissant (c'est la valeur du et), sinon le dépile
+        OU_SINON,       // (cible)        si le sommet n'est pas nul, le remplace par 1 et saute, sinon le dépile
+        AIGUILLER,      // (minimum, nombre, nombre cibles, cible du sinon)  dépile v, saute à la cible de rang
+                        //                v - minimum s'il est entre 0 et nombre - 1, sinon à la cible du sinon
+        ECRIRE_VALEUR,  //                dépile une valeur et l'écrit sur une ligne
+        ECRIRE_CHAINE,  // (chaîne)       écrit la chaîne numéro chaîne de getChaines() sur une ligne
+        LIRE,           // (emplacement)  comme NoeudInstLire : lit la valeur de la variable (voir Entree)
+        TESTER,         // (emplacement)  empile 1 si la variable est définie, 0 sinon
+        OUBLIER,        // (emplacement)  rend la variable indéfinie
+        FIN,            //                fin du programme
+        NB_OPERATIONS
+    };
+
+    Bytecode(const Noeud* racine); // Traduit l'arbre de racine racine (non nul)
+    Bytecode(const int* code, unsigned int taille, const vector<string> & chaines, unsigned int profondeurMax);
+    // Bytecode déjà traduit, dont les taille mots d'instructions sont à l'adresse code
+    //  (par exemple dans un fichier projeté en mémoire, voir CacheProgrammes.h) : ils ne sont pas copiés
+    Bytecode(const Bytecode &) = delete; // getCode() peut désigner m_code
+    Bytecode & operator=(const Bytecode &) = delete;
+
+    bool estCoherent(unsigned int nombreEmplacements, unsigned int nombreChaines) const;
+    // Vrai si chaque code est une opération, chaque opérande dans les bornes, chaque cible de saut
+    //  le début d'une instruction, et si la dernière instruction est FIN : l'exécution ne sort pas du code
+
+    bool contient(Operation operation) const; // Vrai si une des instructions est operation
+
+    inline const int* getCode() const { return m_instructions; } // Les instructions
+    inline unsigned int getTaille() const { return m_taille; }     // Nombre de mots des instructions
+    inline const vector<string> & getChaines() const { return m_chaines; } // Les chaînes de ecrire
+    inline unsigned int getProfondeurMax() const { return m_profondeurMax; } // Nombre maximal de valeurs empilées
+
+    static unsigned int getNombreOperandes(const int* instruction);
+    // Nombre de mots qui suivent le code de l'instruction (variable pour AIGUILLER : 3 + son nombre de cibles)
+
+private:
+    void traduire(const Noeud* noeud);     // Ajoute les instructions qui exécutent noeud
+    void emettre(Operation operation);     // Ajoute une instruction sans opérande
+    void emettre(Operation operation, int operande); // Ajoute une instruction à un opérande
+    unsigned int emettreSaut(Operation saut); // Ajoute un saut sans cible, renvoie l'indice de sa cible
+    void fixer(unsigned int indiceCible);  // La cible du saut d'indice de cible indiceCible est la prochaine instruction
+    void empiler(int nombre);              // Tient compte de nombre valeurs empilées (dépilées si nombre < 0)
+    void traduireAiguillage(const NoeudInstAiguillage* aiguillage);
+    void traduireRecherche(const Noeud* variable, const vector<pair<int, unsigned int> > & valeurs,
+                           unsigned int debut, unsigned int fin, vector<pair<unsigned int, unsigned int> > & sauts);
+    // Ajoute la recherche dichotomique de la valeur de variable parmi valeurs[debut..fin[ (triées, chacune avec
+    //  le rang de sa séquence) ; ajoute à sauts chaque cible à fixer avec son rang (AUCUNE pour le sinon)
+
+    vector<int>    m_code;          // Les instructions traduites (vide si elles sont ailleurs)
+    const int*     m_instructions;  // Début des instructions (m_code, ou la mémoire d'un autre)
+    unsigned int   m_taille;
+    vector<string> m_chaines;
+    unsigned int   m_profondeur;    // Nombre de valeurs empilées à l'endroit du code en cours de traduction
+    unsigned int   m_profondeurMax;
+};
+
+#endif /* BYTECODE_H */
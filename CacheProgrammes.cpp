@@ -0,0 +1,195 @@
+#include "CacheProgrammes.h"
+#include "SymboleValue.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+const char CacheProgrammes::SIGNATURE[8] = { 'P', 'R', 'O', 'G', 'C', 'O', 'M', 'P' };
+const unsigned int CacheProgrammes::VERSION = 7; // à augmenter à chaque changement du format ou du bytecode
+
+////////////////////////////////////////////////////////////////////////////////
+// ProgrammeCompile
+////////////////////////////////////////////////////////////////////////////////
+
+ProgrammeCompile::ProgrammeCompile()
+: m_projection(nullptr), m_taille(0), m_arene(), m_table(m_arene), m_bytecode(nullptr) {
+}
+
+ProgrammeCompile::~ProgrammeCompile() {
+  if (m_projection != nullptr) munmap(m_projection, m_taille);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// CacheProgrammes
+////////////////////////////////////////////////////////////////////////////////
+
+CacheProgrammes::CacheProgrammes(const string & repertoire, bool optimise, unsigned int profondeurAnalyse,
+                                 unsigned long long tailleMax)
+: m_repertoire(repertoire), m_options(optimise ? 1 : 0), m_profondeurAnalyse(profondeurAnalyse), m_tailleMax(tailleMax) {
+  mkdir(m_repertoire.c_str(), 0777); // s'il existe déjà, rien à faire ; sinon les ouvertures échoueront
+}
+
+unsigned long long CacheProgrammes::hacher(const char* debut, size_t taille) {
+  unsigned long long h = 14695981039346656037ULL;
+  for (size_t i = 0; i < taille; i++) {
+    h ^= (unsigned char) debut[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+string CacheProgrammes::nomFichier(unsigned long long hachageSource) const {
+  char nom[48];
+  snprintf(nom, sizeof(nom), "/%016llx-%u-%u.prog", hachageSource, m_options, m_profondeurAnalyse);
+  return m_repertoire + nom;
+}
+
+bool CacheProgrammes::charger(const TamponSource & source, ProgrammeCompile & programme) const {
+  unsigned long long hachage = hacher(source.getDebut(), source.getTaille());
+  int descripteur = open(nomFichier(hachage).c_str(), O_RDONLY);
+  if (descripteur < 0) return false; // pas encore dans le cache
+  struct stat infos;
+  void* adresse = MAP_FAILED;
+  if (fstat(descripteur, &infos) == 0 && S_ISREG(infos.st_mode) && (size_t) infos.st_size >= sizeof(EnteteCache))
+    adresse = mmap(nullptr, infos.st_size, PROT_READ, MAP_PRIVATE, descripteur, 0);
+  close(descripteur);
+  if (adresse == MAP_FAILED) return false;
+  programme.m_projection = adresse;
+  programme.m_taille = infos.st_size;
+
+  const EnteteCache & entete = *(const EnteteCache*) adresse;
+  const char* donnees = (const char*) adresse + sizeof(EnteteCache);
+  bool valide = memcmp(entete.signature, SIGNATURE, sizeof(SIGNATURE)) == 0
+          && entete.version == VERSION
+          && entete.nombreOperations == Bytecode::NB_OPERATIONS
+          && entete.options == m_options
+          && entete.profondeurAnalyse == m_profondeurAnalyse
+          && entete.tailleSource == source.getTaille()
+          && entete.hachageSource == hachage
+          && entete.tailleDonnees == (unsigned long long) infos.st_size - sizeof(EnteteCache)
+          && entete.somme == hacher(donnees, entete.tailleDonnees)
+          && lire(donnees, entete, programme);
+  if (valide) utimensat(AT_FDCWD, nomFichier(hachage).c_str(), nullptr, 0); // utilisé maintenant : le dernier à supprimer
+  return valide;
+}
+
+// Lit dans [position, fin) une longueur (32 bits) puis une chaîne de cette longueur complétée à 4 octets
+static bool lireChaine(const char* & position, const char* fin, string & chaine) {
+  unsigned int longueur;
+  if (fin - position < 4) return false;
+  memcpy(&longueur, position, 4);
+  position += 4;
+  size_t complete = ((size_t) longueur + 3) & ~(size_t) 3;
+  if ((size_t) (fin - position) < complete) return false;
+  chaine.assign(position, longueur);
+  position += complete;
+  return true;
+}
+
+bool CacheProgrammes::lire(const char* donnees, const EnteteCache & entete, ProgrammeCompile & programme) const {
+  const char* position = donnees;
+  const char* fin = donnees + entete.tailleDonnees;
+  string chaine;
+  for (unsigned int i = 0; i < entete.nombreSymboles; i++) {
+    unsigned int jeton;
+    if (fin - position < 4) return false;
+    memcpy(&jeton, position, 4);
+    position += 4;
+    if (!lireChaine(position, fin, chaine)) return false;
+    SymboleValue* symbole = programme.m_table.chercheAjoute(Symbole(chaine));
+    if (symbole->getJeton() != jeton || symbole->getNumero() != i) return false; // symbole altéré ou en double
+  }
+  if (entete.nombreTemporaires > entete.tailleCode) return false; // chaque temporaire sert à une instruction au moins
+  for (unsigned int i = 0; i < entete.nombreTemporaires; i++) programme.m_table.ajouteTemporaire();
+  vector<string> chaines(entete.nombreChaines);
+  for (unsigned int i = 0; i < entete.nombreChaines; i++)
+    if (!lireChaine(position, fin, chaines[i])) return false;
+  if ((size_t) (fin - position) != (size_t) entete.tailleCode * 4) return false;
+  programme.m_bytecode = programme.m_arene.creer<Bytecode>((const int*) position, entete.tailleCode, chaines,
+                                                           entete.profondeurMax);
+  return programme.m_bytecode->estCoherent(entete.nombreSymboles + entete.nombreTemporaires, entete.nombreChaines);
+}
+
+// Ajoute à donnees l'entier valeur (32 bits), puis les caractères de chaine complétés par des 0 à 4 octets
+static void ecrireChaine(string & donnees, unsigned int valeur, const string & chaine) {
+  donnees.append((const char*) &valeur, 4);
+  donnees.append(chaine);
+  donnees.append((4 - chaine.size() % 4) % 4, '\0');
+}
+
+void CacheProgrammes::enregistrer(const TamponSource & source, const TableSymboles & table, const Bytecode & bytecode) const {
+  string donnees;
+  for (unsigned int i = 0; i < table.getTaille(); i++) {
+    unsigned int jeton = table[i].getJeton();
+    donnees.append((const char*) &jeton, 4);
+    ecrireChaine(donnees, table[i].getChaine().size(), table[i].getChaine());
+  }
+  for (unsigned int i = 0; i < bytecode.getChaines().size(); i++)
+    ecrireChaine(donnees, bytecode.getChaines()[i].size(), bytecode.getChaines()[i]);
+  donnees.append((const char*) bytecode.getCode(), bytecode.getTaille() * 4);
+
+  EnteteCache entete;
+  memset(&entete, 0, sizeof(entete));
+  memcpy(entete.signature, SIGNATURE, sizeof(SIGNATURE));
+  entete.version = VERSION;
+  entete.nombreOperations = Bytecode::NB_OPERATIONS;
+  entete.hachageSource = hacher(source.getDebut(), source.getTaille());
+  entete.tailleSource = source.getTaille();
+  entete.options = m_options;
+  entete.profondeurAnalyse = m_profondeurAnalyse;
+  entete.nombreSymboles = table.getTaille();
+  entete.nombreTemporaires = table.getNombreTemporaires();
+  entete.nombreChaines = bytecode.getChaines().size();
+  entete.tailleCode = bytecode.getTaille();
+  entete.profondeurMax = bytecode.getProfondeurMax();
+  entete.tailleDonnees = donnees.size();
+  entete.somme = hacher(donnees.data(), donnees.size());
+  if (sizeof(entete) + donnees.size() > m_tailleMax) return; // il prendrait toute la place
+
+  string nom = nomFichier(entete.hachageSource);
+  char suffixe[24];
+  snprintf(suffixe, sizeof(suffixe), ".%d.tmp", (int) getpid()); // deux exécutions simultanées n'écrivent pas le même
+  string temporaire = nom + suffixe;
+  ofstream sortie(temporaire.c_str(), ios::binary | ios::trunc);
+  sortie.write((const char*) &entete, sizeof(entete));
+  sortie.write(donnees.data(), donnees.size());
+  sortie.close();
+  if (sortie.fail() || rename(temporaire.c_str(), nom.c_str()) != 0) remove(temporaire.c_str());
+  limiter(m_repertoire, ".prog", m_tailleMax);
+}
+
+void CacheProgrammes::limiter(const string & repertoire, const char* extension, unsigned long long tailleMax) {
+  struct Fichier {
+    string nom;
+    unsigned long long date; // de la dernière utilisation, en nanosecondes
+    unsigned long long taille;
+  };
+  vector<Fichier> fichiers;
+  unsigned long long total = 0;
+  size_t longueurExtension = strlen(extension);
+  DIR* dossier = opendir(repertoire.c_str());
+  if (dossier == nullptr) return;
+  for (struct dirent* entree = readdir(dossier); entree != nullptr; entree = readdir(dossier)) {
+    size_t longueur = strlen(entree->d_name);
+    if (longueur < longueurExtension || strcmp(entree->d_name + longueur - longueurExtension, extension) != 0)
+      continue; // pas un fichier de ce cache (les temporaires finissent par .tmp)
+    string nom = repertoire + "/" + entree->d_name;
+    struct stat infos;
+    if (stat(nom.c_str(), &infos) != 0 || !S_ISREG(infos.st_mode)) continue;
+    fichiers.push_back(Fichier{nom, infos.st_mtim.tv_sec * 1000000000ULL + infos.st_mtim.tv_nsec,
+                               (unsigned long long) infos.st_size});
+    total += infos.st_size;
+  }
+  closedir(dossier);
+  if (total <= tailleMax) return;
+  sort(fichiers.begin(), fichiers.end(), [](const Fichier & a, const Fichier & b) { return a.date < b.date; });
+  for (unsigned int i = 0; i < fichiers.size() && total > tailleMax; i++)
+    if (remove(fichiers[i].nom.c_str()) == 0) total -= fichiers[i].taille;
+}
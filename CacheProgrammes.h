@@ -0,0 +1,99 @@
+#ifndef CACHEPROGRAMMES_H
+#define CACHEPROGRAMMES_H
+
+// Cache des programmes compilés : le bytecode d'un programme (voir Bytecode.h), avec sa table des symboles
+// et les chaînes de ses ecrire, est écrit dans un fichier d'un répertoire, nommé d'après un hachage du texte
+// source. Une exécution suivante du même texte projette ce fichier en mémoire (mmap) et exécute le bytecode
+// là où il est : ni découpage en symboles, ni analyse, ni arbre à allouer.
+//
+// Format du fichier (entiers dans l'ordre des octets de la machine qui l'a écrit) :
+//   en-tête   : voir EnteteCache ci-dessous
+//   symboles  : pour chaque symbole de la table, dans l'ordre de ses emplacements :
+//               son jeton et sa longueur (32 bits chacun), puis ses caractères, complétés par des 0
+//               jusqu'à un multiple de 4 octets
+//   chaînes   : idem pour chaque chaîne de Bytecode::getChaines() (sans jeton)
+//               (les temporaires de l'optimiseur, indéfinies au départ, ne sont que comptées dans l'en-tête)
+//   code      : les mots du bytecode (32 bits chacun)
+// Un fichier dont la signature, la version, le texte source, les options ou la somme de contrôle ne
+// correspondent pas, ou dont le code est incohérent, est ignoré : le programme est réanalysé et le fichier
+// remplacé. Le fichier est écrit sous un nom temporaire puis renommé : on ne lit jamais un fichier à moitié écrit.
+// La taille totale des fichiers est bornée : quand elle dépasse la limite, les programmes les moins récemment
+// utilisés (date de modification la plus ancienne, remise à jour à chaque chargement) sont supprimés.
+
+#include <string>
+using namespace std;
+
+#include "Arene.h"
+#include "Bytecode.h"
+#include "TableSymboles.h"
+#include "TamponSource.h"
+
+class ProgrammeCompile { // Un programme chargé depuis un fichier du cache
+public:
+    ProgrammeCompile();  // Programme vide, rempli par CacheProgrammes::charger
+    ~ProgrammeCompile(); // Libère la projection du fichier
+    ProgrammeCompile(const ProgrammeCompile &) = delete; // le bytecode désigne la projection
+    ProgrammeCompile & operator=(const ProgrammeCompile &) = delete;
+
+    inline TableSymboles & getTable() { return m_table; } // accesseur
+    inline const Bytecode & getBytecode() const { return *m_bytecode; } // accesseur (après un chargement réussi)
+
+private:
+    friend class CacheProgrammes;
+    void*         m_projection; // Le fichier projeté en mémoire, nullptr avant le chargement
+    size_t        m_taille;
+    Arene         m_arene;      // Où sont alloués les symboles valués et le bytecode
+    TableSymboles m_table;
+    Bytecode*     m_bytecode;   // Ses instructions sont dans la projection
+};
+
+class CacheProgrammes {
+public:
+    CacheProgrammes(const string & repertoire, bool optimise, unsigned int profondeurAnalyse,
+                    unsigned long long tailleMax);
+    // Cache des programmes dans repertoire (créé s'il n'existe pas), pour des programmes optimisés ou non et
+    //  analysés avec la limite d'imbrication profondeurAnalyse (un programme trop imbriqué pour une limite
+    //  plus petite doit y être refusé), d'au plus tailleMax octets en tout
+
+    bool charger(const TamponSource & source, ProgrammeCompile & programme) const;
+    // Charge dans programme le programme compilé du texte source, renvoie faux s'il n'y en a pas de valide
+    void enregistrer(const TamponSource & source, const TableSymboles & table, const Bytecode & bytecode) const;
+    // Enregistre la table et le bytecode du texte source ; en cas d'échec, le cache reste simplement sans ce programme.
+    //  Supprime ensuite les programmes les plus anciens si besoin
+
+    static unsigned long long hacher(const char* debut, size_t taille); // Hachage FNV-1a sur 64 bits
+    static void limiter(const string & repertoire, const char* extension, unsigned long long tailleMax);
+    // Supprime les fichiers de repertoire qui finissent par extension, les moins récemment utilisés d'abord,
+    //  jusqu'à ce que leur taille totale ne dépasse plus tailleMax (sert aussi à ResultatsMemorises)
+
+private:
+    struct EnteteCache {
+        char               signature[8];     // SIGNATURE
+        unsigned int       version;          // VERSION
+        unsigned int       nombreOperations; // Bytecode::NB_OPERATIONS : change si les opérations changent
+        unsigned long long hachageSource;    // hacher() du texte source
+        unsigned long long tailleSource;
+        unsigned int       options;          // 1 si le programme a été optimisé
+        unsigned int       profondeurAnalyse; // Interpreteur::getProfondeurMax() de l'analyse
+        unsigned int       nombreSymboles;
+        unsigned int       nombreChaines;
+        unsigned int       tailleCode;       // en mots
+        unsigned int       profondeurMax;
+        unsigned int       nombreTemporaires; // temporaires de l'optimiseur, emplacements après ceux des symboles
+        unsigned long long tailleDonnees;    // Nombre d'octets qui suivent l'en-tête
+        unsigned long long somme;            // hacher() des octets qui suivent l'en-tête
+    };
+    static const char         SIGNATURE[8];
+    static const unsigned int VERSION;
+
+    string nomFichier(unsigned long long hachageSource) const; // Fichier du cache du texte de hachage hachageSource
+    bool lire(const char* donnees, const EnteteCache & entete, ProgrammeCompile & programme) const;
+    // Reconstruit la table et le bytecode à partir des données qui suivent entete, faux s'ils sont incohérents
+
+    string             m_repertoire;
+    unsigned int       m_options;
+    unsigned int       m_profondeurAnalyse;
+    unsigned long long m_tailleMax;
+};
+
+#endif /* CACHEPROGRAMMES_H */
@@ -0,0 +1,316 @@
+#include "CodeNatif.h"
+#include "Exceptions.h"
+#include "Sortie.h"
+#include "Entree.h"
+#include <iostream>
+#include <string.h>
+#include <cstddef>
+
+#if defined(__x86_64__) && defined(__unix__)
+#define CODENATIF_X86_64
+#include <sys/mman.h>
+#endif
+
+static_assert(sizeof(Emplacement) == 8 && offsetof(Emplacement, defini) == 4,
+              "le code natif suppose qu'un emplacement fait 8 octets, valeur puis defini");
+
+bool CodeNatif::estDisponible() {
+#ifdef CODENATIF_X86_64
+  return true;
+#else
+  return false;
+#endif
+}
+
+#ifdef CODENATIF_X86_64
+
+// Fonctions appelées par le code natif (convention d'appel System V, elles ne lèvent pas d'exception)
+
+static void ecrireValeur(int valeur) {
+  Sortie::ecrire(valeur);
+}
+
+static void ecrireChaine(const string* chaine) {
+  Sortie::ecrire(*chaine);
+}
+
+static bool lireValeur(Emplacement* emplacement) { // faux si la donnée est mal formée (voir Entree::erreur)
+  int valeur;
+  if (!Entree::lire(valeur)) return false;
+  *emplacement = Emplacement{valeur, true};
+  return true;
+}
+
+namespace {
+
+class Emetteur { // Ecrit les octets du code machine
+public:
+  vector<unsigned char> octets;
+
+  void emettre(unsigned char o) { octets.push_back(o); }
+  void emettre(unsigned char o1, unsigned char o2) { emettre(o1); emettre(o2); }
+  void emettre(unsigned char o1, unsigned char o2, unsigned char o3) { emettre(o1, o2); emettre(o3); }
+  void mot32(unsigned int m) { for (int i = 0; i < 4; i++) emettre((unsigned char) (m >> (8 * i))); }
+  void mot64(unsigned long long m) { for (int i = 0; i < 8; i++) emettre((unsigned char) (m >> (8 * i))); }
+  unsigned int position() const { return octets.size(); }
+  void fixer32(unsigned int position, unsigned int m) { for (int i = 0; i < 4; i++) octets[position + i] = m >> (8 * i); }
+
+  // registres : eax = sommet de la pile, ecx = second opérande, rbx = emplacements
+  void pushRax()  { emettre(0x50); }
+  void popRax()   { emettre(0x58); }
+  void popRcx()   { emettre(0x59); }
+  void movEaxImm(int valeur) { emettre(0xB8); mot32(valeur); }
+  void setccEax(unsigned char cc) { emettre(0x0F, cc, 0xC0); emettre(0x0F, 0xB6, 0xC0); } // setcc al ; movzx eax, al
+  void appeler(const void* fonction) { emettre(0x48, 0xB8); mot64((unsigned long long) fonction); emettre(0xFF, 0xD0); } // mov rax, fonction ; call rax
+  unsigned int saut(unsigned char cc) { // jcc rel32 (cc = 0 pour jmp), renvoie la position du déplacement
+    if (cc == 0) emettre(0xE9);
+    else emettre(0x0F, cc);
+    mot32(0);
+    return position() - 4;
+  }
+};
+
+enum {  // codes de condition des instructions jcc/setcc
+  CC_AE = 0x83, CC_E = 0x84, CC_NE = 0x85, CC_L = 0x8C, CC_GE = 0x8D, CC_LE = 0x8E, CC_G = 0x8F
+};
+
+struct Renvoi { // saut dont la cible n'est connue qu'à la fin de la traduction
+  unsigned int position; // position du déplacement dans le code
+  unsigned int cible;    // indice de l'instruction cible dans le bytecode
+};
+
+struct CaseTable { // case d'une table de sauts (AIGUILLER) : déplacement de la cible depuis le début de la table
+  unsigned int position; // position de la case dans le code
+  unsigned int cible;    // indice de l'instruction cible dans le bytecode
+  unsigned int table;    // position du début de la table dans le code
+};
+
+}
+
+CodeNatif::CodeNatif(const Bytecode & bytecode) : m_zone(nullptr), m_taille(0) {
+  const int* code = bytecode.getCode();
+  unsigned int taille = bytecode.getTaille();
+  Emetteur e;
+  vector<unsigned int> adresses(taille + 1, 0); // position dans le code natif de chaque instruction
+  vector<Renvoi> renvois, indefinis, divisions, entrees;
+  vector<CaseTable> cases;
+  unsigned int epilogue;
+
+  // prologue : push rbp ; mov rbp, rsp ; push rbx ; sub rsp, 8 (pile alignée sur 16) ; mov rbx, rdi
+  e.emettre(0x55); e.emettre(0x48, 0x89, 0xE5); e.emettre(0x53); e.emettre(0x48, 0x83, 0xEC); e.emettre(0x08);
+  e.emettre(0x48, 0x89, 0xFB);
+
+  unsigned int profondeur = 0; // nombre de valeurs de la pile du bytecode : le sommet dans eax, les autres empilées
+  for (unsigned int pc = 0; pc < taille; ) {
+    adresses[pc] = e.position();
+    Bytecode::Operation operation = (Bytecode::Operation) code[pc];
+    const int* instruction = code + pc;
+    int operande = Bytecode::getNombreOperandes(instruction) ? instruction[1] : 0;
+    pc += 1 + Bytecode::getNombreOperandes(instruction);
+    unsigned int deplacement = 8 * operande; // déplacement de l'emplacement operande depuis rbx
+    // pour un appel, la pile du processeur doit être alignée sur 16 : nombre pair de valeurs empilées
+    bool aligner = profondeur >= 2 && (profondeur - 1) % 2 == 1;
+    switch (operation) {
+      case Bytecode::CHARGER:
+        if (profondeur++ > 0) e.pushRax();
+        e.emettre(0x80, 0xBB); e.mot32(deplacement + 4); e.emettre(0x00); // cmp byte [rbx + d + 4], 0
+        indefinis.push_back(Renvoi{e.saut(CC_E), 0});
+        e.emettre(0x8B, 0x83); e.mot32(deplacement);                   // mov eax, [rbx + d]
+        break;
+      case Bytecode::CHARGER_SUR:
+        if (profondeur++ > 0) e.pushRax();
+        e.emettre(0x8B, 0x83); e.mot32(deplacement);                   // mov eax, [rbx + d]
+        break;
+      case Bytecode::EMPILER:
+        if (profondeur++ > 0) e.pushRax();
+        e.movEaxImm(operande);
+        break;
+      case Bytecode::RANGER:
+        e.emettre(0x89, 0x83); e.mot32(deplacement);                   // mov [rbx + d], eax
+        e.emettre(0xC6, 0x83); e.mot32(deplacement + 4); e.emettre(1); // mov byte [rbx + d + 4], 1
+        if (--profondeur > 0) e.popRax();
+        break;
+      case Bytecode::ADDITION:
+        e.popRcx(); e.emettre(0x01, 0xC8); profondeur--;               // add eax, ecx
+        break;
+      case Bytecode::SOUSTRACTION:
+        e.popRcx(); e.emettre(0x29, 0xC1); e.emettre(0x89, 0xC8); profondeur--; // sub ecx, eax ; mov eax, ecx
+        break;
+      case Bytecode::MULTIPLICATION:
+        e.popRcx(); e.emettre(0x0F, 0xAF, 0xC1); profondeur--;         // imul eax, ecx
+        break;
+      case Bytecode::DIVISION:
+        e.popRcx(); profondeur--;
+        e.emettre(0x85, 0xC0);                                         // test eax, eax
+        divisions.push_back(Renvoi{e.saut(CC_E), 0});
+        e.emettre(0x41, 0x89, 0xC0); e.emettre(0x89, 0xC8);            // mov r8d, eax ; mov eax, ecx
+        e.emettre(0x99); e.emettre(0x41, 0xF7, 0xF8);                  // cdq ; idiv r8d
+        break;
+      case Bytecode::DIVISION_SURE:
+        e.popRcx(); profondeur--;
+        e.emettre(0x41, 0x89, 0xC0); e.emettre(0x89, 0xC8);            // mov r8d, eax ; mov eax, ecx
+        e.emettre(0x99); e.emettre(0x41, 0xF7, 0xF8);                  // cdq ; idiv r8d
+        break;
+      case Bytecode::EGAL: case Bytecode::DIFFERENT: case Bytecode::INFERIEUR:
+      case Bytecode::INFERIEUREGAL: case Bytecode::SUPERIEUR: case Bytecode::SUPERIEUREGAL: {
+        static const unsigned char setcc[] = { 0x94, 0x95, 0x9C, 0x9E, 0x9F, 0x9D }; // sete setne setl setle setg setge
+        e.popRcx(); profondeur--;
+        e.emettre(0x39, 0xC1);                                         // cmp ecx, eax
+        e.setccEax(setcc[operation - Bytecode::EGAL]);
+        break;
+      }
+      case Bytecode::OPPOSE:
+        e.emettre(0xF7, 0xD8);                                         // neg eax
+        break;
+      case Bytecode::NEGATION:
+        e.emettre(0x85, 0xC0); e.setccEax(0x94);                       // test eax, eax ; sete al
+        break;
+      case Bytecode::BOOLEEN:
+        e.emettre(0x85, 0xC0); e.setccEax(0x95);                       // test eax, eax ; setne al
+        break;
+      case Bytecode::SAUTER:
+        renvois.push_back(Renvoi{e.saut(0), (unsigned int) operande});
+        break;
+      case Bytecode::SAUTER_SI_FAUX: case Bytecode::SAUTER_SI_VRAI:
+        e.emettre(0x85, 0xC0);                                         // test eax, eax
+        if (--profondeur > 0) e.popRax();                              // (pop ne change pas les indicateurs)
+        renvois.push_back(Renvoi{e.saut(operation == Bytecode::SAUTER_SI_FAUX ? CC_E : CC_NE), (unsigned int) operande});
+        break;
+      case Bytecode::ET_ALORS: // le sommet (0) reste dans eax si on saute
+        e.emettre(0x85, 0xC0);                                         // test eax, eax
+        renvois.push_back(Renvoi{e.saut(CC_E), (unsigned int) operande});
+        if (--profondeur > 0) e.popRax();
+        break;
+      case Bytecode::OU_SINON: // le sommet, ramené à 1, reste dans eax si on saute
+        e.emettre(0x85, 0xC0); e.setccEax(0x95);                       // test eax, eax ; setne al (movzx garde les indicateurs)
+        renvois.push_back(Renvoi{e.saut(CC_NE), (unsigned int) operande});
+        if (--profondeur > 0) e.popRax();
+        break;
+      case Bytecode::AIGUILLER: {
+        unsigned int nombre = instruction[2];
+        e.emettre(0x89, 0xC1);                                         // mov ecx, eax
+        if (--profondeur > 0) e.popRax();
+        e.emettre(0x81, 0xE9); e.mot32(operande);                      // sub ecx, minimum
+        e.emettre(0x81, 0xF9); e.mot32(nombre);                        // cmp ecx, nombre
+        renvois.push_back(Renvoi{e.saut(CC_AE), (unsigned int) instruction[3 + nombre]}); // jae sinon
+        e.emettre(0x48, 0x8D, 0x15); e.mot32(0);                       // lea rdx, [rip + table]
+        unsigned int lea = e.position();
+        e.emettre(0x48, 0x63, 0x0C); e.emettre(0x8A);                  // movsxd rcx, dword [rdx + rcx * 4]
+        e.emettre(0x48, 0x01, 0xD1);                                   // add rcx, rdx
+        e.emettre(0xFF, 0xE1);                                         // jmp rcx
+        unsigned int table = e.position();
+        e.fixer32(lea - 4, table - lea);
+        for (unsigned int i = 0; i < nombre; i++) {
+          cases.push_back(CaseTable{e.position(), (unsigned int) instruction[3 + i], table});
+          e.mot32(0);
+        }
+        break;
+      }
+      case Bytecode::ECRIRE_VALEUR:
+        e.emettre(0x89, 0xC7);                                         // mov edi, eax
+        if (aligner) e.emettre(0x48, 0x83, 0xEC), e.emettre(0x08);     // sub rsp, 8
+        e.appeler((const void*) &ecrireValeur);
+        if (aligner) e.emettre(0x48, 0x83, 0xC4), e.emettre(0x08);     // add rsp, 8
+        if (--profondeur > 0) e.popRax();
+        break;
+      case Bytecode::ECRIRE_CHAINE: case Bytecode::LIRE:
+        // le sommet éventuel est sauvé sur la pile : elle contient alors profondeur valeurs
+        if (profondeur > 0) e.pushRax();
+        aligner = profondeur % 2 == 1;
+        if (operation == Bytecode::ECRIRE_CHAINE) {
+          e.emettre(0x48, 0xBF); e.mot64((unsigned long long) &bytecode.getChaines()[operande]); // mov rdi, chaine
+        } else {
+          e.emettre(0x48, 0x8D, 0xBB); e.mot32(deplacement);           // lea rdi, [rbx + d]
+        }
+        if (aligner) e.emettre(0x48, 0x83, 0xEC), e.emettre(0x08);
+        e.appeler(operation == Bytecode::ECRIRE_CHAINE ? (const void*) &ecrireChaine : (const void*) &lireValeur);
+        if (aligner) e.emettre(0x48, 0x83, 0xC4), e.emettre(0x08);
+        if (operation == Bytecode::LIRE) {
+          e.emettre(0x84, 0xC0);                                       // test al, al
+          entrees.push_back(Renvoi{e.saut(CC_E), 0});
+        }
+        if (profondeur > 0) e.popRax();
+        break;
+      case Bytecode::TESTER:
+        if (profondeur++ > 0) e.pushRax();
+        e.emettre(0x0F, 0xB6, 0x83); e.mot32(deplacement + 4);         // movzx eax, byte [rbx + d + 4]
+        break;
+      case Bytecode::OUBLIER:
+        e.emettre(0xC6, 0x83); e.mot32(deplacement + 4); e.emettre(0); // mov byte [rbx + d + 4], 0
+        break;
+      case Bytecode::FIN:
+        e.emettre(0x31, 0xC0);                                         // xor eax, eax (statut OK)
+        renvois.push_back(Renvoi{e.saut(0), taille});
+        break;
+      default:
+        throw OperationInterditeException();
+    }
+  }
+
+  // sorties en erreur, puis épilogue : lea rsp, [rbp - 8] ; pop rbx ; pop rbp ; ret
+  unsigned int sortieIndefini = e.position();
+  e.movEaxImm(INDEFINI);
+  unsigned int sautIndefini = e.saut(0);
+  unsigned int sortieEntree = e.position();
+  e.movEaxImm(ENTREE_INVALIDE);
+  unsigned int sautEntree = e.saut(0);
+  unsigned int sortieDivision = e.position();
+  e.movEaxImm(DIVISION_PAR_ZERO);
+  epilogue = e.position();
+  e.emettre(0x48, 0x8D, 0x65); e.emettre(0xF8); e.emettre(0x5B); e.emettre(0x5D); e.emettre(0xC3);
+  adresses[taille] = epilogue;
+
+  // les déplacements des sauts sont relatifs à la fin de l'instruction de saut
+  e.fixer32(sautIndefini, epilogue - (sautIndefini + 4));
+  e.fixer32(sautEntree, epilogue - (sautEntree + 4));
+  for (unsigned int i = 0; i < renvois.size(); i++)
+    e.fixer32(renvois[i].position, adresses[renvois[i].cible] - (renvois[i].position + 4));
+  for (unsigned int i = 0; i < cases.size(); i++)
+    e.fixer32(cases[i].position, adresses[cases[i].cible] - cases[i].table);
+  for (unsigned int i = 0; i < indefinis.size(); i++)
+    e.fixer32(indefinis[i].position, sortieIndefini - (indefinis[i].position + 4));
+  for (unsigned int i = 0; i < divisions.size(); i++)
+    e.fixer32(divisions[i].position, sortieDivision - (divisions[i].position + 4));
+  for (unsigned int i = 0; i < entrees.size(); i++)
+    e.fixer32(entrees[i].position, sortieEntree - (entrees[i].position + 4));
+
+  // copie dans une zone que l'on rend ensuite exécutable (et non modifiable)
+  m_taille = e.octets.size();
+  m_zone = mmap(nullptr, m_taille, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (m_zone == MAP_FAILED) {
+    m_zone = nullptr;
+    throw OperationInterditeException();
+  }
+  memcpy(m_zone, e.octets.data(), m_taille);
+  if (mprotect(m_zone, m_taille, PROT_READ | PROT_EXEC) != 0) {
+    munmap(m_zone, m_taille);
+    m_zone = nullptr;
+    throw OperationInterditeException();
+  }
+}
+
+CodeNatif::~CodeNatif() {
+  if (m_zone != nullptr) munmap(m_zone, m_taille);
+}
+
+void CodeNatif::executer(vector<Emplacement> & emplacements) const {
+  int statut = ((Programme) m_zone)(emplacements.data());
+  if (statut == INDEFINI) throw IndefiniException();
+  if (statut == DIVISION_PAR_ZERO) throw DivParZeroException();
+  if (statut == ENTREE_INVALIDE) throw Entree::erreur();
+}
+
+#else
+
+CodeNatif::CodeNatif(const Bytecode & bytecode) : m_zone(nullptr), m_taille(0) {
+  throw OperationInterditeException(); // pas de code natif pour cette machine
+}
+
+CodeNatif::~CodeNatif() {
+}
+
+void CodeNatif::executer(vector<Emplacement> & emplacements) const {
+  throw OperationInterditeException();
+}
+
+#endif
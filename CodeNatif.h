@@ -0,0 +1,41 @@
+#ifndef CODENATIF_H
+#define CODENATIF_H
+
+// Code natif : traduction du bytecode d'un programme (voir Bytecode.h) en code machine x86-64,
+// écrit dans une zone mémoire exécutable obtenue par mmap (sans aucune bibliothèque extérieure).
+// Le sommet de la pile du bytecode est gardé dans le registre eax, le reste sur la pile du processeur ;
+// les variables restent dans leurs emplacements de la table des symboles, dont l'adresse est dans rbx.
+// Le code natif n'appelle le reste du programme que pour ecrire et lire ; une variable indéfinie,
+// une division par 0 ou une donnée de lire mal formée le fait sortir avec un code d'erreur, que executer()
+// transforme en exception.
+
+#include <vector>
+using namespace std;
+
+#include "Bytecode.h"
+#include "SymboleValue.h"
+
+class CodeNatif {
+public:
+    static bool estDisponible(); // Vrai si le code natif peut être produit sur cette machine (x86-64)
+
+    CodeNatif(const Bytecode & bytecode); // Traduit bytecode ; lève OperationInterditeException si pas disponible
+    ~CodeNatif();                         // Rend la zone exécutable
+    CodeNatif(const CodeNatif &) = delete;
+    CodeNatif & operator=(const CodeNatif &) = delete;
+
+    void executer(vector<Emplacement> & emplacements) const;
+    // Exécute le programme avec les valeurs des variables dans emplacements,
+    //  lève les mêmes exceptions que l'arbre abstrait
+
+    inline unsigned int getTaille() const { return m_taille; } // Nombre d'octets de code machine
+
+private:
+    enum Statut { OK = 0, INDEFINI = 1, DIVISION_PAR_ZERO = 2, ENTREE_INVALIDE = 3 }; // Valeur renvoyée par le code natif
+    typedef int (*Programme)(Emplacement* emplacements);
+
+    void*        m_zone;   // Zone exécutable qui contient le code
+    unsigned int m_taille;
+};
+
+#endif /* CODENATIF_H */
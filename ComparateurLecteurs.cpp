@@ -0,0 +1,79 @@
+#include "ComparateurLecteurs.h"
+#include "Lecteur.h"
+#include "LecteurReference.h"
+#include "Balayeur.h"
+#include <sstream>
+#include <random>
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+string ComparateurLecteurs::symbolesReference(const string & nomFichier) {
+  LecteurReference lecteur(nomFichier);
+  ostringstream texte;
+  for (;;) {
+    texte << (int) lecteur.getSymbole().getJeton() << ' ' << lecteur.getLigne() << ':' << lecteur.getColonne()
+          << ' ' << lecteur.getSymbole().getChaine() << '\n';
+    if (lecteur.getSymbole() == J_FINDEFICHIER) break;
+    lecteur.avancer();
+  }
+  return texte.str();
+}
+
+string ComparateurLecteurs::symboles(const string & nomFichier, bool parFenetre) {
+  Lecteur lecteur(nomFichier, parFenetre);
+  ostringstream texte;
+  for (;;) {
+    texte << (int) lecteur.getJeton() << ' ' << lecteur.getLigne() << ':' << lecteur.getColonne() << ' '
+          << lecteur.getChaine() << '\n';
+    if (lecteur.getJeton() == J_FINDEFICHIER) break;
+    lecteur.avancer();
+  }
+  return texte.str();
+}
+
+bool ComparateurLecteurs::comparer(const string & nomFichier, ostream & sortie) {
+  static const char* const NOMS[] = { "scalaire", "SSE2", "AVX2" };
+  static const unsigned int OUVRIERS[] = { 1, 2, 3, 7 }; // plusieurs fils seulement pour les gros textes
+  string reference = symbolesReference(nomFichier);
+  bool identiques = true;
+  for (int jeu = Balayeur::SCALAIRE; jeu <= Balayeur::meilleurJeu(); jeu++) {
+    Balayeur::choisir((Balayeur::JeuInstructions) jeu);
+    for (unsigned int ouvriers : OUVRIERS) {
+      Lecteur::setNombreOuvriers(ouvriers);
+      if (symboles(nomFichier, false) != reference) {
+        sortie << nomFichier << " : " << NOMS[jeu] << ", " << ouvriers << " fil(s) : symboles différents" << endl;
+        identiques = false;
+      }
+    }
+    Lecteur::setNombreOuvriers(1);
+    if (symboles(nomFichier, true) != reference) {
+      sortie << nomFichier << " : " << NOMS[jeu] << ", par fenêtre : symboles différents" << endl;
+      identiques = false;
+    }
+  }
+  Balayeur::choisir(Balayeur::meilleurJeu()); // les réglages par défaut
+  Lecteur::setNombreOuvriers(0);
+  return identiques;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+string ComparateurLecteurs::texteAleatoire(unsigned int graine, size_t taille) {
+  static const char* const MORCEAUX[] = {
+    "a", "b", "zz_9", "x1", "_x", "A", "Z", "9", "12", "007", "123456789012345678901234567890123",
+    "identificateur_tres_long_1234567890_abcdefghijklmnop", "tantque", "si", "finsi",
+    "\"str ing\"", "\"chaine longue longue longue longue longue longue\"", "\"non terminee",
+    "#commentaire\n", "# c\r\n", "\n# commentaire long long long long long long long long\n",
+    "\n", "\r\n", "\n\n", " ", "\t", "            ", "\t\t\t\t\n\n\n   \r\n   ",
+    "==", "!=", "<=", ">=", "<", ">", "=", "!", "+", "++", "-", "--", "*", "/", "(", ")", ";", ",", "@", ".",
+    "\xC3\xA9", "\xE9" // é en UTF-8 et en Latin-1
+  };
+  mt19937 hasard(graine);
+  uniform_int_distribution<size_t> morceau(0, sizeof(MORCEAUX) / sizeof(MORCEAUX[0]) - 1);
+  string texte;
+  while (texte.size() < taille) texte += MORCEAUX[morceau(hasard)];
+  if (!texte.empty() && hasard() % 2 == 0) // le lecteur prend 0xFF pour la fin du fichier
+    texte.insert(hasard() % texte.size(), 1, '\xFF');
+  return texte;
+}
@@ -0,0 +1,29 @@
+#ifndef COMPARATEURLECTEURS_H
+#define COMPARATEURLECTEURS_H
+
+// Comparateur de lecteurs : vérifie que le découpage en symboles du Lecteur ne dépend ni du jeu d'instructions
+// des noyaux de balayage (Balayeur::choisir), ni du nombre de fils qui découpent (Lecteur::setNombreOuvriers),
+// ni de la lecture par fenêtre. Chaque façon de lire doit donner exactement les mêmes symboles (jeton, texte,
+// ligne, colonne) que la référence : le lecteur d'origine, caractère par caractère (voir LecteurReference).
+// Sert à l'option --comparer-lecteurs.
+
+#include <iostream>
+#include <string>
+using namespace std;
+
+class ComparateurLecteurs {
+public:
+    static bool comparer(const string & nomFichier, ostream & sortie);
+    // Lit nomFichier de toutes les façons ; vrai si elles donnent toutes les symboles de la référence
+    //  (sinon, écrit sur sortie chaque façon qui diffère)
+
+    static string texteAleatoire(unsigned int graine, size_t taille);
+    // Texte d'environ taille octets (mots, entiers, chaînes parfois non terminées, commentaires, fins de ligne
+    //  \n ou \r\n, caractères accentués, parfois un 0xFF) : les cas limites du lecteur, pour comparer
+
+private:
+    static string symbolesReference(const string & nomFichier);          // Tous les symboles lus par la référence,
+    static string symboles(const string & nomFichier, bool parFenetre);  //  ou par le Lecteur, un par ligne
+};
+
+#endif /* COMPARATEURLECTEURS_H */
@@ -0,0 +1,120 @@
+#include "Entree.h"
+#include "Sortie.h"
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+using namespace std;
+
+const size_t Entree::TAILLE_BLOC = 1 << 16;
+const char* const Entree::FIN_DONNEES = "fin des données";
+const char* const Entree::ENTIER_ATTENDU = "entier attendu";
+const char* const Entree::ENTIER_TROP_GRAND = "entier trop grand";
+
+unique_ptr<TamponSource> Entree::s_source;
+vector<char>       Entree::s_tampon;
+int                Entree::s_descripteur = -1;
+const char*        Entree::s_debut = nullptr;
+const char*        Entree::s_position = nullptr;
+const char*        Entree::s_fin = nullptr;
+bool               Entree::s_finDonnees = false;
+unsigned long long Entree::s_decalage = 0;
+unsigned long long Entree::s_ligne = 1;
+unsigned long long Entree::s_debutLigne = 0;
+const char*        Entree::s_probleme = nullptr;
+unsigned long long Entree::s_positionErreur = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Entree::ouvrir(const string & nomFichier) {
+  int descripteur = open(nomFichier.c_str(), O_RDONLY);
+  if (descripteur < 0) // si le fichier ne peut-être lu...
+    throw FichierException();
+  commencer(descripteur);
+}
+
+void Entree::commencer(int descripteur) {
+  s_source.reset();
+  s_tampon.clear();
+  s_descripteur = descripteur;
+  s_debut = s_position = s_fin = nullptr;
+  s_finDonnees = false;
+  s_decalage = 0;
+  struct stat infos;
+  if (fstat(descripteur, &infos) == 0 && S_ISREG(infos.st_mode) && infos.st_size > 0) {
+    // fichier régulier : projeté en entier, à partir de là où il en est (l'entrée standard a pu être entamée)
+    off_t depart = lseek(descripteur, 0, SEEK_CUR);
+    s_source.reset(new TamponSource(descripteur));
+    s_debut = s_position = s_source->getDebut() + min((off_t) s_source->getTaille(), max((off_t) 0, depart));
+    s_fin = s_source->getFin();
+    s_finDonnees = true;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Entree::recharger() {
+  Sortie::vider(); // la lecture peut attendre : ce qui est écrit doit l'avoir été
+  size_t lu = s_position - s_debut, reste = s_fin - s_position;
+  s_decalage += lu;
+  if (reste == s_tampon.size()) s_tampon.resize(max(TAILLE_BLOC, 2 * s_tampon.size()));
+  memmove(s_tampon.data(), s_tampon.data() + lu, reste);
+  ssize_t lus;
+  do lus = read(s_descripteur, s_tampon.data() + reste, s_tampon.size() - reste);
+  while (lus < 0 && errno == EINTR);
+  if (lus <= 0) s_finDonnees = true; // fin des données (ou erreur de lecture : rien de plus à lire)
+  s_debut = s_position = s_tampon.data();
+  s_fin = s_debut + reste + max((ssize_t) 0, lus);
+}
+
+bool Entree::echouer(const char* probleme, const char* position) {
+  s_probleme = probleme;
+  s_positionErreur = s_decalage + (position - s_debut);
+  return false;
+}
+
+bool Entree::lire(int & valeur) {
+  if (s_descripteur < 0) commencer(STDIN_FILENO);
+  const char* p = s_position;
+  for (;;) {
+    // les blancs, en suivant les lignes pour situer les erreurs
+    while (p < s_fin && estBlanc(*p)) {
+      if (*p == '\n') {
+        s_ligne++;
+        s_debutLigne = s_decalage + (p - s_debut) + 1;
+      }
+      p++;
+    }
+    s_position = p;
+    if (p == s_fin) {
+      if (s_finDonnees) return echouer(FIN_DONNEES, p);
+      recharger();
+      p = s_position;
+      continue;
+    }
+    // l'entier : chiffres accumulés sur 64 bits, bloqués juste au-delà du plus grand entier permis
+    bool negatif = *p == '-';
+    if (*p == '-' || *p == '+') p++;
+    const char* chiffres = p;
+    unsigned long long n = 0;
+    while (p < s_fin && (unsigned char) (*p - '0') < 10) {
+      if (n <= 2147483648ULL) n = 10 * n + (*p - '0');
+      p++;
+    }
+    if (p == s_fin && !s_finDonnees) { // il peut continuer dans le bloc suivant : on le relit en entier
+      recharger();
+      p = s_position;
+      continue;
+    }
+    if (p == chiffres || (p < s_fin && !estBlanc(*p))) return echouer(ENTIER_ATTENDU, s_position);
+    if (n > (negatif ? 2147483648ULL : 2147483647ULL)) return echouer(ENTIER_TROP_GRAND, s_position);
+    valeur = negatif ? (int) (0u - (unsigned int) n) : (int) n;
+    s_position = p;
+    return true;
+  }
+}
+
+EntreeException Entree::erreur() {
+  return EntreeException(s_probleme, s_ligne, s_positionErreur - s_debutLigne + 1);
+}
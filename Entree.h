@@ -0,0 +1,69 @@
+#ifndef ENTREE_H
+#define ENTREE_H
+
+// Entree : les données que lit l'instruction lire, des entiers séparés par des blancs (espaces, tabulations,
+// fins de ligne), chacun avec un signe éventuel. Elles viennent de l'entrée standard, ou du fichier donné à
+// ouvrir (option --entree).
+// Un fichier régulier est projeté en mémoire en entier (voir TamponSource). Sinon (tube, terminal, ...) les
+// données sont lues par gros blocs, au fur et à mesure : avant chaque lecture, qui peut attendre, ce que le
+// programme a écrit est envoyé (Sortie::vider), pour qu'un utilisateur voie la question avant d'y répondre.
+// Les entiers sont convertis directement dans le tampon, sans passer par les flux. Une donnée absente ou
+// mal formée lève EntreeException, avec sa position (ligne, colonne) dans les données.
+
+#include <memory>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "Exceptions.h"
+#include "TamponSource.h"
+
+class Entree {
+public:
+    static void ouvrir(const string & nomFichier);
+    // Les données seront lues dans le fichier nomFichier plutôt que sur l'entrée standard ;
+    //  lève FichierException s'il ne peut pas être ouvert
+
+    static bool lire(int & valeur);
+    // Lit l'entier suivant dans valeur ; faux (la donnée n'est pas consommée) s'il est absent ou mal formé
+
+    static inline int lire() {
+        int valeur;
+        if (!lire(valeur)) throw erreur();
+        return valeur;
+    } // Renvoie l'entier suivant ; lève EntreeException s'il est absent ou mal formé
+
+    static EntreeException erreur(); // L'exception qui décrit la dernière donnée que lire n'a pas pu lire
+
+    static const char* const FIN_DONNEES;       // Les problèmes que décrit EntreeException
+    static const char* const ENTIER_ATTENDU;    //  (aussi pour les programmes traduits en C++, voir TraducteurCpp)
+    static const char* const ENTIER_TROP_GRAND;
+
+private:
+    static void commencer(int descripteur); // Les données seront lues dans le fichier ouvert descripteur
+    static void recharger();
+    // Lit le bloc suivant à la suite de ce qui reste à lire, ramené au début du tampon (qui grandit si ce qui
+    //  reste le remplit) ; s_finDonnees devient vrai s'il n'y a plus rien
+    static bool echouer(const char* probleme, const char* position); // Note l'erreur, renvoie faux
+
+    static inline bool estBlanc(char c) {
+        return c == ' ' || (unsigned char) (c - '\t') <= '\r' - '\t';
+    } // Espace, tabulation, fin de ligne (\t \n \v \f \r)
+
+    static const size_t TAILLE_BLOC; // Taille des lectures quand le fichier n'est pas projeté
+
+    static unique_ptr<TamponSource> s_source; // Le fichier projeté (nullptr si les données sont lues par blocs)
+    static vector<char>       s_tampon;       // Les blocs lus, à partir de ce qui restait à lire
+    static int                s_descripteur;  // Le fichier lu par blocs (-1 tant que rien n'a été lu)
+    static const char*        s_debut;        // Les données en mémoire : début,
+    static const char*        s_position;     //  premier caractère pas encore lu
+    static const char*        s_fin;          //  et fin
+    static bool               s_finDonnees;   // Vrai si rien ne suit s_fin
+    static unsigned long long s_decalage;     // Position dans les données du caractère s_debut
+    static unsigned long long s_ligne;        // Numéro (à partir de 1) de la ligne de s_position
+    static unsigned long long s_debutLigne;   // Position dans les données du début de cette ligne
+    static const char*        s_probleme;     // La dernière erreur de lire
+    static unsigned long long s_positionErreur; //  et sa position dans les données
+};
+
+#endif /* ENTREE_H */
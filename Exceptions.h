@@ -9,6 +9,7 @@
 #define	EXCEPTIONS_H
 #include <exception>
 #include <string>
+#include <cstdio>
 using namespace std;
 
 // Classe mère de toutes les exceptions de l'interpréteur
@@ -37,6 +38,13 @@ private :
 };
 
 
+class ProfondeurException : public SyntaxeException {
+// Programme trop profondément imbriqué (voir Interpreteur::setProfondeurMax) : l'analyse s'arrête, sans
+//  sauter l'instruction comme pour les autres erreurs de syntaxe
+public:
+    ProfondeurException(const char * message = NULL) : SyntaxeException(message) {}
+};
+
 class IndefiniException : public InterpreteurException {
 public:
     const char * what() const throw() {
@@ -52,6 +60,21 @@ public:
     }
 };
 
+class EntreeException : public InterpreteurException {
+// Donnée de lire (voir Entree) absente ou mal formée ; le message donne sa position dans les données
+public:
+    EntreeException(const char * probleme, unsigned long long ligne, unsigned long long colonne) {
+        snprintf(m_message, sizeof(m_message), FORMAT, probleme, ligne, colonne);
+    }
+    const char * what() const throw() {
+        return m_message;
+    }
+    static constexpr const char* FORMAT = "Lire : %s (ligne %llu, colonne %llu des données)";
+    // Aussi utilisé par les programmes traduits en C++ (voir TraducteurCpp)
+private :
+    char m_message[128];
+};
+
 class OperationInterditeException : public InterpreteurException {
 public:
     const char * what() const throw() {
@@ -0,0 +1,70 @@
+#include "FluxJetons.h"
+#include <algorithm>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// ReservoirChaines
+////////////////////////////////////////////////////////////////////////////////
+
+ReservoirChaines::ReservoirChaines() : m_chaines(), m_index() {
+}
+
+unsigned int ReservoirChaines::interner(const char* debut, unsigned int longueur) {
+  unsigned int hachage = IndexChaines::hacher(debut, longueur);
+  unsigned int numero = m_index.chercher(hachage, [&](unsigned int n) {
+    return m_chaines[n].size() == longueur && memcmp(m_chaines[n].data(), debut, longueur) == 0;
+  });
+  if (numero != IndexChaines::AUCUN) return numero; // déjà dans le réservoir
+  numero = m_chaines.size();
+  m_chaines.push_back(string(debut, longueur));
+  m_index.inserer(hachage, numero);
+  return numero;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FluxJetons
+////////////////////////////////////////////////////////////////////////////////
+
+FluxJetons::FluxJetons() : m_jetons(), m_debuts(), m_longueurs(), m_lignes(), m_colonnes(), m_numerosChaines() {
+}
+
+void FluxJetons::reserver(unsigned int nombre) {
+  m_jetons.reserve(nombre);
+  m_debuts.reserve(nombre);
+  m_longueurs.reserve(nombre);
+  m_lignes.reserve(nombre);
+  m_colonnes.reserve(nombre);
+  m_numerosChaines.reserve(nombre);
+}
+
+void FluxJetons::redimensionner(unsigned int nombre) {
+  m_jetons.resize(nombre);
+  m_debuts.resize(nombre);
+  m_longueurs.resize(nombre);
+  m_lignes.resize(nombre);
+  m_colonnes.resize(nombre);
+  m_numerosChaines.resize(nombre);
+}
+
+void FluxJetons::recopier(unsigned int position, const FluxJetons & morceau, unsigned int nombre,
+                          unsigned int decalageLignes, const vector<unsigned int> & numerosChaines) {
+  copy(morceau.m_jetons.begin(), morceau.m_jetons.begin() + nombre, m_jetons.begin() + position);
+  copy(morceau.m_debuts.begin(), morceau.m_debuts.begin() + nombre, m_debuts.begin() + position);
+  copy(morceau.m_longueurs.begin(), morceau.m_longueurs.begin() + nombre, m_longueurs.begin() + position);
+  copy(morceau.m_colonnes.begin(), morceau.m_colonnes.begin() + nombre, m_colonnes.begin() + position);
+  for (unsigned int i = 0; i < nombre; i++) {
+    m_lignes[position + i] = morceau.m_lignes[i] + decalageLignes;
+    unsigned int numero = morceau.m_numerosChaines[i];
+    m_numerosChaines[position + i] = (numero == AUCUNE_CHAINE) ? AUCUNE_CHAINE : numerosChaines[numero];
+  }
+}
+
+void FluxJetons::retirerDebut(unsigned int nombre, unsigned int decalagePositions) {
+  m_jetons.erase(m_jetons.begin(), m_jetons.begin() + nombre);
+  m_debuts.erase(m_debuts.begin(), m_debuts.begin() + nombre);
+  m_longueurs.erase(m_longueurs.begin(), m_longueurs.begin() + nombre);
+  m_lignes.erase(m_lignes.begin(), m_lignes.begin() + nombre);
+  m_colonnes.erase(m_colonnes.begin(), m_colonnes.begin() + nombre);
+  m_numerosChaines.erase(m_numerosChaines.begin(), m_numerosChaines.begin() + nombre);
+  for (unsigned int i = 0; i < m_debuts.size(); i++) m_debuts[i] -= decalagePositions;
+}
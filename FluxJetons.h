@@ -0,0 +1,104 @@
+#ifndef FLUXJETONS_H
+#define FLUXJETONS_H
+
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "Symbole.h"
+#include "IndexChaines.h"
+
+// Réservoir de chaînes : l'orthographe de chaque identificateur, entier ou chaîne
+// n'y est rangée qu'une fois, et désignée ensuite par son numéro (0, 1, 2, ...)
+
+class ReservoirChaines {
+public:
+    ReservoirChaines(); // Construit un réservoir vide
+
+    unsigned int interner(const char* debut, unsigned int longueur);
+    // Renvoie le numéro de la chaîne formée des longueur caractères de debut,
+    // après l'avoir ajoutée au réservoir si elle n'y était pas encore
+
+    inline const string & getChaine(unsigned int numero) const {
+        return m_chaines[numero];
+    } // Chaîne de numéro numero
+
+    inline unsigned int getTaille() const {
+        return m_chaines.size();
+    } // Nombre de chaînes différentes du réservoir
+
+private:
+    vector<string> m_chaines; // Les chaînes, rangées par numéro
+    IndexChaines   m_index;   // Le numéro de chaque chaîne, retrouvé par son hachage
+};
+
+// Flux de jetons : tous les symboles d'un texte source, rangés dans des tableaux parallèles
+// (un tableau par attribut plutôt qu'un objet par symbole) pour être compacts et parcourus
+// sans allocation. Le dernier jeton du flux est toujours J_FINDEFICHIER.
+
+class FluxJetons {
+public:
+    static const unsigned int AUCUNE_CHAINE = ~0u; // Numéro de chaîne des jetons qui n'en ont pas (mots clés, ...)
+
+    FluxJetons(); // Construit un flux vide
+
+    inline void ajouter(Jeton jeton, unsigned int debut, unsigned int longueur,
+                        unsigned int ligne, unsigned int colonne, unsigned int numeroChaine) {
+        m_jetons.push_back(jeton);
+        m_debuts.push_back(debut);
+        m_longueurs.push_back(longueur);
+        m_lignes.push_back(ligne);
+        m_colonnes.push_back(colonne);
+        m_numerosChaines.push_back(numeroChaine);
+    } // Ajoute un jeton à la fin du flux
+
+    void reserver(unsigned int nombre); // Prévoit la place de nombre jetons
+    void redimensionner(unsigned int nombre); // Fixe le nombre de jetons du flux (les nouveaux jetons sont à remplir)
+
+    void recopier(unsigned int position, const FluxJetons & morceau, unsigned int nombre,
+                  unsigned int decalageLignes, const vector<unsigned int> & numerosChaines);
+    // Recopie les nombre premiers jetons de morceau à partir du jeton position de ce flux,
+    // en ajoutant decalageLignes à leurs lignes et en traduisant leurs numéros de chaîne par numerosChaines
+
+    void retirerDebut(unsigned int nombre, unsigned int decalagePositions);
+    // Retire les nombre premiers jetons du flux (les suivants sont renumérotés depuis 0), en retranchant
+    // decalagePositions aux positions des autres
+
+    inline unsigned int getTaille() const {
+        return m_jetons.size();
+    } // Nombre de jetons du flux
+
+    inline Jeton getJeton(unsigned int i) const {
+        return (Jeton) m_jetons[i];
+    } // Code du ième jeton
+
+    inline unsigned int getDebut(unsigned int i) const {
+        return m_debuts[i];
+    } // Position (en caractères depuis le début du texte) du ième jeton
+
+    inline unsigned int getLongueur(unsigned int i) const {
+        return m_longueurs[i];
+    } // Nombre de caractères du ième jeton
+
+    inline unsigned int getLigne(unsigned int i) const {
+        return m_lignes[i];
+    } // Ligne du ième jeton
+
+    inline unsigned int getColonne(unsigned int i) const {
+        return m_colonnes[i];
+    } // Colonne du ième jeton
+
+    inline unsigned int getNumeroChaine(unsigned int i) const {
+        return m_numerosChaines[i];
+    } // Numéro dans le réservoir de l'orthographe du ième jeton (variables, entiers, chaînes)
+
+private:
+    vector<unsigned char> m_jetons;         // Code de chaque jeton (type Jeton)
+    vector<unsigned int>  m_debuts;         // Position de chaque jeton dans le texte
+    vector<unsigned int>  m_longueurs;      // Longueur de chaque jeton
+    vector<unsigned int>  m_lignes;         // Ligne de chaque jeton
+    vector<unsigned int>  m_colonnes;       // Colonne de chaque jeton
+    vector<unsigned int>  m_numerosChaines; // Numéro de chaîne de chaque jeton, AUCUNE_CHAINE s'il n'en a pas
+};
+
+#endif /* FLUXJETONS_H */
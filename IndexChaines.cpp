@@ -0,0 +1,20 @@
+#include "IndexChaines.h"
+
+IndexChaines::IndexChaines() : m_entrees(16, Entree{0, AUCUN}), m_masque(15), m_nombre(0) {
+}
+
+void IndexChaines::inserer(unsigned int hachage, unsigned int numero) {
+  if (2 * (m_nombre + 1) > m_entrees.size()) { // on double la taille, en replaçant les entrées grâce à leur hachage
+    vector<Entree> anciennes(2 * m_entrees.size(), Entree{0, AUCUN});
+    anciennes.swap(m_entrees);
+    m_masque = m_entrees.size() - 1;
+    m_nombre = 0;
+    for (unsigned int i = 0; i < anciennes.size(); i++)
+      if (anciennes[i].numero != AUCUN) inserer(anciennes[i].hachage, anciennes[i].numero);
+  }
+  unsigned int i = hachage & m_masque;
+  while (m_entrees[i].numero != AUCUN) i = (i + 1) & m_masque;
+  m_entrees[i].hachage = hachage;
+  m_entrees[i].numero = numero;
+  m_nombre++;
+}
@@ -0,0 +1,45 @@
+#ifndef INDEXCHAINES_H
+#define INDEXCHAINES_H
+
+#include <vector>
+using namespace std;
+
+// Index de hachage à adressage ouvert (sondage linéaire) qui retrouve le numéro (0, 1, 2, ...) d'une chaîne.
+// L'index ne range pas les chaînes : c'est son utilisateur qui les garde, et qui dit, lors d'une recherche,
+// si la chaîne d'un numéro candidat est bien celle cherchée. L'index garde seulement le hachage de chaque
+// chaîne, ce qui évite presque toutes les comparaisons et permet de l'agrandir sans relire les chaînes.
+
+class IndexChaines {
+public:
+    static const unsigned int AUCUN = ~0u; // Résultat d'une recherche infructueuse
+
+    IndexChaines(); // Construit un index vide
+
+    static inline unsigned int hacher(const char* debut, unsigned int longueur) {
+        unsigned int h = 2166136261u; // FNV-1a
+        for (unsigned int i = 0; i < longueur; i++) h = (h ^ (unsigned char) debut[i]) * 16777619u;
+        return h;
+    } // Hachage de la chaîne formée des longueur caractères de debut
+
+    template <class Egal>
+    inline unsigned int chercher(unsigned int hachage, const Egal & egal) const {
+        for (unsigned int i = hachage & m_masque; ; i = (i + 1) & m_masque) {
+            const Entree & e = m_entrees[i];
+            if (e.numero == AUCUN) return AUCUN;
+            if (e.hachage == hachage && egal(e.numero)) return e.numero;
+        }
+    } // Numéro de la chaîne de hachage hachage pour laquelle egal(numero) est vrai, AUCUN s'il n'y en a pas
+
+    void inserer(unsigned int hachage, unsigned int numero); // Ajoute le numéro d'une nouvelle chaîne
+
+private:
+    struct Entree {
+        unsigned int hachage;
+        unsigned int numero; // AUCUN si l'entrée est libre
+    };
+    vector<Entree> m_entrees; // Toujours au moins à moitié libres, en nombre égal à une puissance de 2
+    unsigned int   m_masque;  // Nombre d'entrées - 1
+    unsigned int   m_nombre;  // Nombre d'entrées occupées
+};
+
+#endif /* INDEXCHAINES_H */
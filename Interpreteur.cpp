@@ -1,269 +1,498 @@
 #include "Interpreteur.h"
+#include "Optimiseur.h"
+#include "AnalyseurFlot.h"
 #include <stdlib.h>
+#include <algorithm>
 #include <iostream>
 using namespace std;
 
-Interpreteur::Interpreteur(ifstream & fichier) :
-m_lecteur(fichier), m_table(), m_arbre(nullptr) {
+// Table des opérateurs binaires, indexée par le code du symbole : priorité de chaque opérateur
+// (0 si le symbole n'est pas un opérateur binaire), associativité, et si une longue chaîne de cet opérateur
+// peut être équilibrée. Plus la priorité est forte, plus l'opérateur lie ses opérandes :
+// a ou b et c == d + e * f se lit a ou (b et (c == (d + (e * f))))
+struct Operateur {
+  unsigned char priorite;
+  bool          aDroite;     // vrai si l'opérateur est associatif à droite
+  bool          equilibrable; // vrai si (a op b) op c et a op (b op c) ont toujours la même valeur, les mêmes
+                              //  exceptions et évaluent leurs opérandes dans le même ordre (+ et * débordent de la
+                              //  même façon ; - l'est avec +, voir Interpreteur::equilibrer)
+};
+
+static const struct TableOperateurs {
+  Operateur operateurs[NB_JETONS];
+  TableOperateurs() : operateurs() {
+    operateurs[J_OU]             = { 1, false, true  };
+    operateurs[J_ET]             = { 2, false, true  };
+    operateurs[J_EGAL]           = { 3, false, false };
+    operateurs[J_DIFFERENT]      = { 3, false, false };
+    operateurs[J_INFERIEUR]      = { 4, false, false };
+    operateurs[J_INFERIEUREGAL]  = { 4, false, false };
+    operateurs[J_SUPERIEUR]      = { 4, false, false };
+    operateurs[J_SUPERIEUREGAL]  = { 4, false, false };
+    operateurs[J_PLUS]           = { 5, false, true  };
+    operateurs[J_MOINS]          = { 5, false, true  };
+    operateurs[J_MULTIPLICATION] = { 6, false, true  };
+    operateurs[J_DIVISION]       = { 6, false, false };
+  }
+} OPERATEURS;
+
+// Une chaîne d'opérateurs de même priorité qui a au moins autant d'opérandes est équilibrée (si tous ses
+// opérateurs le permettent) : l'arbre d'une expression générée de milliers de termes reste peu profond
+static const unsigned int CHAINE_MIN_EQUILIBREE = 64;
+
+const unsigned int Interpreteur::PROFONDEUR_MAX = 2000;
+
+// Table des instructions : chaque symbole qui peut commencer une instruction donne la règle qui l'analyse
+// Il faut la compléter chaque fois qu'on rajoute une nouvelle instruction
+const Interpreteur::RegleInstruction Interpreteur::s_instructions[NB_JETONS] = {
+  /* J_PROCEDURE */ nullptr, /* J_PRINCIPALE */ nullptr, /* J_FINPROC */ nullptr,
+  /* J_POUR      */ &Interpreteur::instPour, /* J_FINPOUR */ nullptr,
+  /* J_SI        */ &Interpreteur::instSi, /* J_SINON */ nullptr, /* J_SINONSI */ nullptr, /* J_FINSI */ nullptr,
+  /* J_TANTQUE   */ &Interpreteur::instTantQue, /* J_FINTANTQUE */ nullptr,
+  /* J_REPETER   */ &Interpreteur::instRepeter, /* J_JUSQUA */ nullptr,
+  /* J_LIRE      */ &Interpreteur::instLire,
+  /* J_ECRIRE    */ &Interpreteur::instEcrire,
+  /* ; , = ( )   */ nullptr, nullptr, nullptr, nullptr, nullptr,
+  /* + ++ - -- * / */ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+  /* == != < <= > >= */ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+  /* et ou non   */ nullptr, nullptr, nullptr,
+  /* J_VARIABLE  */ &Interpreteur::instAffectation,
+  /* J_ENTIER, J_CHAINE, J_INDEFINI, J_FINDEFICHIER */ nullptr, nullptr, nullptr, nullptr
+};
+
+Interpreteur::Interpreteur(const string & nomFichier, bool parFlux) :
+m_lecteur(nomFichier, parFlux), m_arene(), m_areneSymboles(), m_table(m_areneSymboles), m_expressions(m_arene),
+m_arbre(nullptr), m_nombreErreurs(0), m_nombreAvertissements(0), m_deterministe(true), m_profondeurMax(PROFONDEUR_MAX),
+m_parFlux(parFlux), m_marque(), m_blocs(), m_operateurs() {
+}
+
+Interpreteur::Interpreteur(istream & flux) :
+m_lecteur(flux), m_arene(), m_areneSymboles(), m_table(m_areneSymboles), m_expressions(m_arene), m_arbre(nullptr),
+m_nombreErreurs(0), m_nombreAvertissements(0), m_deterministe(true), m_profondeurMax(PROFONDEUR_MAX), m_parFlux(false),
+m_marque(), m_blocs(), m_operateurs() {
 }
 
 void Interpreteur::analyse() {
   m_arbre = programme(); // on lance l'analyse de la première règle
+  if (m_arbre == nullptr) return;
+  // les variables lues là où aucune affectation n'a pu les définir lèveront une exception si la lecture est exécutée
+  for (const SymboleValue* variable : AnalyseurFlot(m_arene, m_table, m_expressions).lecturesIndefinies(m_arbre)) {
+    cout << "ATTENTION : Variable " << variable->getChaine() << " lue avant d'avoir été affectée"
+            " => Valeur Indéfinie si cette lecture est exécutée" << endl;
+    m_nombreAvertissements++;
+  }
+}
+
+void Interpreteur::optimiser() {
+  Optimiseur optimiseur(m_arene, m_table, m_expressions);
+  if (m_arbre != nullptr) m_arbre = optimiseur.optimiser(m_arbre);
+  if (m_arbre != nullptr) m_arbre = optimiseur.sortirInvariants(m_arbre);
+  if (m_arbre != nullptr) m_arbre = optimiseur.numeroterValeurs(m_arbre);
+  if (m_arbre != nullptr) m_arbre = AnalyseurFlot(m_arene, m_table, m_expressions).rendreSur(m_arbre);
+}
+
+void Interpreteur::commencerFlux() {
+  testerEtAvancer(J_PROCEDURE);
+  testerEtAvancer(J_PRINCIPALE);
+  testerEtAvancer(J_PARENTHESEOUVRANTE);
+  testerEtAvancer(J_PARENTHESEFERMANTE);
+  m_blocs.clear();
+  ouvrirBloc(J_PROCEDURE);
+  m_marque = m_arene.marquer(); // les noeuds de chaque instruction seront alloués après
+}
+
+Noeud* Interpreteur::instructionSuivante() {
+  // l'instruction précédente a été exécutée : ses noeuds, et ses expressions, ne servent plus
+  m_arene.revenir(m_marque);
+  m_expressions.vider();
+  Noeud* instruction = instructionPrincipale();
+  if (instruction == nullptr) { // la séquence du programme est finie
+    testerEtAvancer(J_FINPROC);
+    tester(J_FINDEFICHIER);
+  }
+  return instruction;
 }
 
-void Interpreteur::tester(const string & symboleAttendu) const throw (SyntaxeException) {
+Noeud* Interpreteur::optimiser(Noeud* instruction) {
+  // sortirInvariants et numeroterValeurs ajoutent des temporaires, qui doivent suivre toutes les variables du
+  //  programme ; l'analyse de flot a besoin des instructions précédentes et suivantes
+  return Optimiseur(m_arene, m_table, m_expressions).optimiser(instruction);
+}
+
+void Interpreteur::tester(Jeton symboleAttendu) const {
   // Teste si le symbole courant est égal au symboleAttendu... Si non, lève une exception
   static char messageWhat[256];
-  if (m_lecteur.getSymbole() != symboleAttendu) {
+  if (m_lecteur.getJeton() != symboleAttendu) {
     sprintf(messageWhat,
             "Ligne %d, Colonne %d - Erreur de syntaxe - Symbole attendu : %s - Symbole trouvé : %s",
             m_lecteur.getLigne(), m_lecteur.getColonne(),
-            symboleAttendu.c_str(), m_lecteur.getSymbole().getChaine().c_str());
+            Symbole::getTexte(symboleAttendu), m_lecteur.getChaine().c_str());
     throw SyntaxeException(messageWhat);
   }
 }
 
-void Interpreteur::testerEtAvancer(const string & symboleAttendu) throw (SyntaxeException) {
+void Interpreteur::testerEtAvancer(Jeton symboleAttendu) {
   // Teste si le symbole courant est égal au symboleAttendu... Si oui, avance, Sinon, lève une exception
   tester(symboleAttendu);
   m_lecteur.avancer();
 }
 
-void Interpreteur::erreur(const string & message) const throw (SyntaxeException) {
+void Interpreteur::erreur(const string & message) const {
   // Lève une exception contenant le message et le symbole courant trouvé
   // Utilisé lorsqu'il y a plusieurs symboles attendus possibles...
   static char messageWhat[256];
   sprintf(messageWhat,
           "Ligne %d, Colonne %d - Erreur de syntaxe - %s - Symbole trouvé : %s",
-          m_lecteur.getLigne(), m_lecteur.getColonne(), message.c_str(), m_lecteur.getSymbole().getChaine().c_str());
+          m_lecteur.getLigne(), m_lecteur.getColonne(), message.c_str(), m_lecteur.getChaine().c_str());
   throw SyntaxeException(messageWhat);
 }
 
+void Interpreteur::erreurProfondeur() const {
+  // Lève une exception ProfondeurException : l'analyse ne reprend pas à l'instruction suivante
+  static char messageWhat[256];
+  sprintf(messageWhat,
+          "Ligne %d, Colonne %d - Erreur de syntaxe - Imbrication trop profonde (plus de %u niveaux) - Symbole trouvé : %s",
+          m_lecteur.getLigne(), m_lecteur.getColonne(), m_profondeurMax, m_lecteur.getChaine().c_str());
+  throw ProfondeurException(messageWhat);
+}
+
 Noeud* Interpreteur::programme() {
   // <programme> ::= procedure principale() <seqInst> finproc FIN_FICHIER
-  testerEtAvancer("procedure");
-  testerEtAvancer("principale");
-  testerEtAvancer("(");
-  testerEtAvancer(")");
+  testerEtAvancer(J_PROCEDURE);
+  testerEtAvancer(J_PRINCIPALE);
+  testerEtAvancer(J_PARENTHESEOUVRANTE);
+  testerEtAvancer(J_PARENTHESEFERMANTE);
   Noeud* sequence = seqInst();
-  testerEtAvancer("finproc");
-  tester("<FINDEFICHIER>");
+  testerEtAvancer(J_FINPROC);
+  tester(J_FINDEFICHIER);
   return sequence;
 }
 
 Noeud* Interpreteur::seqInst() {
   // <seqInst> ::= <inst> { <inst> }
-  NoeudSeqInst* sequence = new NoeudSeqInst();
-  do {
-    sequence->ajoute(inst());
-  } while (m_lecteur.getSymbole() == "<VARIABLE>" || m_lecteur.getSymbole() == "si" || m_lecteur.getSymbole() == "repeter"
-           || m_lecteur.getSymbole() == "tantque" || m_lecteur.getSymbole() == "pour" || m_lecteur.getSymbole() == "ecrire"
-            || m_lecteur.getSymbole() == "lire");
-  // Tant que le symbole courant est un début possible d'instruction...
-  // Il faut compléter cette condition chaque fois qu'on rajoute une nouvelle instruction
-  return sequence;
+  m_blocs.clear();
+  ouvrirBloc(J_PROCEDURE);
+  while (Noeud* instruction = instructionPrincipale()) m_blocs.front().sequence->ajoute(instruction);
+  return m_blocs.front().sequence;
 }
 
-Noeud* Interpreteur::inst() {
-  // <inst> ::= <affectation>  ; | <instSi>
-  try {
-    if (m_lecteur.getSymbole() == "<VARIABLE>") {
-      Noeud *affect = affectation();
-      testerEtAvancer(";");
-      return affect;
-    }
-    else if (m_lecteur.getSymbole() == "si")
-      return instSi();
-    // Compléter les alternatives chaque fois qu'on rajoute une nouvelle instruction
-    else if (m_lecteur.getSymbole() == "repeter")
-      return instRepeter();
-      else if(m_lecteur.getSymbole() == "tantque")
-        return instTantQue();
-    else if(m_lecteur.getSymbole() == "pour")
-        return instPour();
-    else if(m_lecteur.getSymbole() == "ecrire")
-        return instEcrire();
-    else if (m_lecteur.getSymbole() == "lire")
-      return instLire();
-    else erreur("Instruction incorrecte");
-  } catch (SyntaxeException) {
+Noeud* Interpreteur::instructionPrincipale() {
+  // Chaque bloc ouvert par une instruction (si, tantque, repeter, pour) est empilé sur m_blocs avec sa séquence :
+  // les instructions suivantes vont dans la séquence du bloc du sommet, jusqu'à la fin du bloc (fermerBloc)
+  for (;;) {
+    bool fin = false; // vrai pendant l'analyse de la fin du bloc du sommet
+    try {
+      Noeud* instruction;
+      // Tant que le symbole courant est un début possible d'instruction, la séquence continue
+      if (m_blocs.back().vide || s_instructions[m_lecteur.getJeton()] != nullptr)
+        instruction = inst(); // nullptr si elle ouvre un bloc, qu'on analyse maintenant
+      else if (m_blocs.size() == 1) return nullptr; // la séquence du programme est finie
+      else {
+        fin = true;
+        instruction = fermerBloc(); // nullptr si une autre séquence du bloc (sinonsi, sinon) commence
+        if (instruction != nullptr) m_blocs.pop_back();
+      }
+      if (instruction != nullptr) {
+        m_blocs.back().vide = false;
+        if (m_blocs.size() == 1) return instruction;
+        m_blocs.back().sequence->ajoute(instruction);
+      }
+    } catch (ProfondeurException &) {
+      throw;
+    } catch (SyntaxeException &) { // l'instruction en cours est incorrecte (si fin, celle qui a ouvert le bloc)
+      if (fin) m_blocs.pop_back();
+      // plus rien à sauter pour reprendre l'analyse ; ou, en mode flux, les instructions précédentes ont été exécutées
+      if (m_lecteur.getJeton() == J_FINDEFICHIER || m_parFlux) throw;
       cout << "ERREUR : Instruction incorrecte => Erreur traitée => Arbre abstrait vidé" << endl;
       m_arbre = nullptr;
+      m_nombreErreurs++;
       m_lecteur.avancer();
-      inst();
+      m_blocs.back().vide = true; // on reprend par une autre instruction à sa place
+    }
   }
 }
 
+Noeud* Interpreteur::inst() {
+  // <inst> ::= <affectation>  ; | <instSi>
+  RegleInstruction regle = s_instructions[m_lecteur.getJeton()];
+  if (regle == nullptr) erreur("Instruction incorrecte");
+  return (this->*regle)();
+}
+
+void Interpreteur::ouvrirBloc(Jeton genre) {
+  if (m_blocs.size() >= m_profondeurMax) erreurProfondeur();
+  m_blocs.emplace_back();
+  Bloc & bloc = m_blocs.back();
+  bloc.genre = genre;
+  bloc.sequence = m_arene.creer<NoeudSeqInst>();
+  bloc.vide = true;
+  bloc.affectation1 = bloc.affectation2 = nullptr;
+}
+
+Noeud* Interpreteur::fermerBloc() {
+  Bloc & bloc = m_blocs.back();
+  switch (bloc.genre) {
+    case J_SI: // { sinonsi (<expression>) <seqInst> } [sinon <seqInst>] finsi
+      bloc.sequences.push_back(bloc.sequence);
+      if (bloc.conditions.back() != nullptr && m_lecteur.getJeton() == J_SINONSI) {
+        testerEtAvancer(J_SINONSI);
+        testerEtAvancer(J_PARENTHESEOUVRANTE);
+        bloc.conditions.push_back(expression());
+        testerEtAvancer(J_PARENTHESEFERMANTE);
+      } else if (bloc.conditions.back() != nullptr && m_lecteur.getJeton() == J_SINON) {
+        testerEtAvancer(J_SINON);
+        bloc.conditions.push_back(nullptr); // pas de condition pour le sinon
+      } else {
+        testerEtAvancer(J_FINSI);
+        if (bloc.sequences.size() == 1)
+          return m_arene.creer<NoeudInstSi>(bloc.conditions[0], bloc.sequences[0]); // un noeud Instruction Si
+        return instSiRiche(bloc.conditions, bloc.sequences);
+      }
+      bloc.sequence = m_arene.creer<NoeudSeqInst>();
+      bloc.vide = true;
+      return nullptr;
+    case J_TANTQUE: // fintantque
+      testerEtAvancer(J_FINTANTQUE);
+      return m_arene.creer<NoeudInstTantQue>(bloc.conditions[0], bloc.sequence);
+    case J_REPETER: { // jusqua (<expression>)
+      testerEtAvancer(J_JUSQUA);
+      testerEtAvancer(J_PARENTHESEOUVRANTE);
+      Noeud* condition = expression();
+      testerEtAvancer(J_PARENTHESEFERMANTE);
+      return m_arene.creer<NoeudInstRepeter>(bloc.sequence, condition);
+    }
+    default: // J_POUR : finpour
+      testerEtAvancer(J_FINPOUR);
+      return m_arene.creer<NoeudInstPour>(bloc.conditions[0], bloc.sequence, bloc.affectation1, bloc.affectation2);
+  }
+}
+
+Noeud* Interpreteur::instAffectation() {
+  // <affectation> ;
+  Noeud *affect = affectation();
+  testerEtAvancer(J_POINTVIRGULE);
+  return affect;
+}
+
 Noeud* Interpreteur::affectation() {
   // <affectation> ::= <variable> = <expression> 
-  tester("<VARIABLE>");
-  Noeud* var = m_table.chercheAjoute(m_lecteur.getSymbole()); // La variable est ajoutée à la table et on la mémorise
+  tester(J_VARIABLE);
+  Noeud* var = m_table.chercheAjoute(m_lecteur.getNumeroChaine(), m_lecteur.getReservoir()); // La variable est ajoutée à la table et on la mémorise
   m_lecteur.avancer();
-  testerEtAvancer("=");
+  testerEtAvancer(J_AFFECTATION);
   Noeud* exp = expression();             // On mémorise l'expression trouvée
-  return new NoeudAffectation(var, exp); // On renvoie un noeud affectation
+  return m_arene.creer<NoeudAffectation>(var, exp); // On renvoie un noeud affectation
 }
 
 Noeud* Interpreteur::expression() {
   // <expression> ::= <facteur> { <opBinaire> <facteur> }
+  //    <facteur> ::= <entier> | <variable> | - <facteur> | non <facteur> | ( <expression> )
   //  <opBinaire> ::= + | - | *  | / | < | > | <= | >= | == | != | et | ou
-  Noeud* fact = facteur();
-  while ( m_lecteur.getSymbole() == "+"  || m_lecteur.getSymbole() == "-"  ||
-          m_lecteur.getSymbole() == "*"  || m_lecteur.getSymbole() == "/"  ||
-          m_lecteur.getSymbole() == "<"  || m_lecteur.getSymbole() == "<=" ||
-          m_lecteur.getSymbole() == ">"  || m_lecteur.getSymbole() == ">=" ||
-          m_lecteur.getSymbole() == "==" || m_lecteur.getSymbole() == "!=" ||
-          m_lecteur.getSymbole() == "et" || m_lecteur.getSymbole() == "ou"   ) {
-    Symbole operateur = m_lecteur.getSymbole(); // On mémorise le symbole de l'opérateur
+  // Analyse par priorité des opérateurs : un opérateur attend sur m_operateurs, avec son opérande gauche, que son
+  // opérande droit soit fini, c'est-à-dire qu'un opérateur moins prioritaire (ou la fin de l'expression ou de la
+  // parenthèse) le suive. Les opérateurs de même priorité qui se suivent attendent ensemble (voir reduire)
+  m_operateurs.clear();
+  for (;;) {
+    // un <facteur> : ses - et non unaires et ses parenthèses ouvrantes, puis son entier ou sa variable
+    Jeton jeton = m_lecteur.getJeton();
+    for (; jeton == J_MOINS || jeton == J_NON || jeton == J_PARENTHESEOUVRANTE; jeton = m_lecteur.getJeton()) {
+      m_operateurs.push_back({nullptr, 0, jeton, jeton == J_PARENTHESEOUVRANTE ? (unsigned char) 0 : UNAIRE});
+      m_lecteur.avancer();
+    }
+    if (jeton != J_VARIABLE && jeton != J_ENTIER) erreur("Facteur incorrect");
+    Operande facteur = { nullptr, 0 };
+    if (jeton == J_ENTIER && m_parFlux) facteur.noeud = m_expressions.constante(atoi(m_lecteur.getChaine().c_str()));
+    else facteur.noeud = m_table.chercheAjoute(m_lecteur.getNumeroChaine(), m_lecteur.getReservoir()); // on ajoute la variable ou l'entier à la table
     m_lecteur.avancer();
-    Noeud* factDroit = facteur(); // On mémorise l'opérande droit
-    fact = new NoeudOperateurBinaire(operateur, fact, factDroit); // Et on construuit un noeud opérateur binaire
+    for (;;) { // le facteur est fini : ses opérateurs unaires s'appliquent
+      while (!m_operateurs.empty() && m_operateurs.back().priorite == UNAIRE) {
+        facteur.noeud = m_expressions.operation(m_operateurs.back().jeton, facteur.noeud);
+        if (++facteur.profondeur + m_blocs.size() > m_profondeurMax) erreurProfondeur();
+        m_operateurs.pop_back();
+      }
+      jeton = m_lecteur.getJeton();
+      const Operateur & operateur = OPERATEURS.operateurs[jeton];
+      if (operateur.priorite != 0) { // un opérateur binaire : facteur est son opérande gauche, son opérande droit suit
+        if (!m_operateurs.empty() && m_operateurs.back().priorite > operateur.priorite)
+          facteur = reduire(facteur, operateur.priorite);
+        m_operateurs.push_back({facteur.noeud, facteur.profondeur, jeton, operateur.priorite});
+        m_lecteur.avancer();
+        break;
+      }
+      if (!m_operateurs.empty() && m_operateurs.back().priorite != 0) facteur = reduire(facteur, 0);
+      if (m_operateurs.empty()) return facteur.noeud; // la racine de l'expression
+      testerEtAvancer(J_PARENTHESEFERMANTE); // fin d'une expression parenthésée, qui est le facteur fini
+      m_operateurs.pop_back();
+    }
   }
-  return fact; // On renvoie fact qui pointe sur la racine de l'expression
 }
 
-Noeud* Interpreteur::facteur() {
-  // <facteur> ::= <entier> | <variable> | - <facteur> | non <facteur> | ( <expression> )
-  Noeud* fact = nullptr;
-  if (m_lecteur.getSymbole() == "<VARIABLE>" || m_lecteur.getSymbole() == "<ENTIER>") {
-    fact = m_table.chercheAjoute(m_lecteur.getSymbole()); // on ajoute la variable ou l'entier à la table
-    m_lecteur.avancer();
-  } else if (m_lecteur.getSymbole() == "-") { // - <facteur>
-    m_lecteur.avancer();
-    // on représente le moins unaire (- facteur) par une soustraction binaire (0 - facteur)
-    fact = new NoeudOperateurBinaire(Symbole("-"), m_table.chercheAjoute(Symbole("0")), facteur());
-  } else if (m_lecteur.getSymbole() == "non") { // non <facteur>
-    m_lecteur.avancer();
-    // on représente le moins unaire (- facteur) par une soustractin binaire (0 - facteur)
-    fact = new NoeudOperateurBinaire(Symbole("non"), facteur(), nullptr);
-  } else if (m_lecteur.getSymbole() == "(") { // expression parenthésée
-    m_lecteur.avancer();
-    fact = expression();
-    testerEtAvancer(")");
-  } else
-    erreur("Facteur incorrect");
-  return fact;
+Interpreteur::Operande Interpreteur::reduire(Operande dernier, unsigned int priorite) {
+  while (!m_operateurs.empty() && m_operateurs.back().priorite > priorite) {
+    // la chaîne du sommet : ses opérateurs sont m_operateurs[debut..fin), le dernier de ses opérandes est dernier
+    unsigned int fin = m_operateurs.size();
+    unsigned int debut = fin - 1;
+    if (debut == 0 || m_operateurs[debut - 1].priorite != m_operateurs[debut].priorite) { // un seul opérateur
+      const EnAttente & operateur = m_operateurs.back();
+      dernier.noeud = m_expressions.operation(operateur.jeton, operateur.gauche, dernier.noeud);
+      dernier.profondeur = 1 + max(dernier.profondeur, operateur.profondeur);
+      if (dernier.profondeur + m_blocs.size() > m_profondeurMax) erreurProfondeur();
+      m_operateurs.pop_back();
+      continue;
+    }
+    while (debut > 0 && m_operateurs[debut - 1].priorite == m_operateurs[debut].priorite) debut--;
+    bool equilibrable = fin - debut + 1 >= CHAINE_MIN_EQUILIBREE;
+    for (unsigned int i = debut; equilibrable && i < fin; i++)
+      equilibrable = OPERATEURS.operateurs[m_operateurs[i].jeton].equilibrable;
+    Operande resultat;
+    if (equilibrable) resultat = equilibrer(debut, fin, dernier, false);
+    else if (OPERATEURS.operateurs[m_operateurs[debut].jeton].aDroite) {
+      resultat = dernier;
+      for (unsigned int i = fin; i-- > debut;) {
+        resultat.noeud = m_expressions.operation(m_operateurs[i].jeton, m_operateurs[i].gauche, resultat.noeud);
+        resultat.profondeur = 1 + max(resultat.profondeur, m_operateurs[i].profondeur);
+      }
+    } else {
+      resultat = { m_operateurs[debut].gauche, m_operateurs[debut].profondeur };
+      for (unsigned int i = debut + 1; i <= fin; i++) {
+        const Operande droit = i < fin ? Operande{ m_operateurs[i].gauche, m_operateurs[i].profondeur } : dernier;
+        resultat.noeud = m_expressions.operation(m_operateurs[i - 1].jeton, resultat.noeud, droit.noeud);
+        resultat.profondeur = 1 + max(resultat.profondeur, droit.profondeur);
+      }
+    }
+    if (resultat.profondeur + m_blocs.size() > m_profondeurMax) erreurProfondeur(); // sa racine est la plus profonde
+    m_operateurs.erase(m_operateurs.begin() + debut, m_operateurs.end());
+    dernier = resultat;
+  }
+  return dernier;
+}
+
+Interpreteur::Operande Interpreteur::equilibrer(unsigned int debut, unsigned int fin, const Operande & dernier, bool inverse) {
+  // La chaîne est coupée en deux moitiés : o1 op1 ... ok opk ... on vaut (o1 op1 ... ok) opk (... on). Une
+  // soustraction est l'addition de l'opposé, en débordant de la même façon : a - b + c - d vaut (a - b) + (c - d)
+  // et a - b - c + d vaut (a - b) - (c - d), la moitié droite étant alors la chaîne inverse
+  if (debut == fin) {
+    if (fin == m_operateurs.size()) return dernier;
+    return { m_operateurs[debut].gauche, m_operateurs[debut].profondeur };
+  }
+  unsigned int milieu = (debut + fin + 1) / 2;
+  Jeton jeton = m_operateurs[milieu - 1].jeton; // entre les opérandes de rangs milieu - 1 et milieu
+  Operande gauche = equilibrer(debut, milieu - 1, dernier, inverse);
+  Operande droit = equilibrer(milieu, fin, dernier, jeton == J_MOINS);
+  if (inverse && (jeton == J_PLUS || jeton == J_MOINS)) jeton = jeton == J_PLUS ? J_MOINS : J_PLUS;
+  return { m_expressions.operation(jeton, gauche.noeud, droit.noeud), 1 + max(gauche.profondeur, droit.profondeur) };
 }
 
 Noeud* Interpreteur::instSi() {
   // <instSi> ::= si ( <expression> ) <seqInst> finsi
-    
-  testerEtAvancer("si");
-  testerEtAvancer("(");
+  //  ou <instSiRiche> (voir fermerBloc)
+  testerEtAvancer(J_SI);
+  testerEtAvancer(J_PARENTHESEOUVRANTE);
   Noeud* condition = expression(); // On mémorise la condition
-  testerEtAvancer(")");
-  Noeud* sequence = seqInst();     // On mémorise la séquence d'instruction
-  if(m_lecteur.getSymbole() == "sinonsi" || m_lecteur.getSymbole() == "sinon"){
-    return instSiRiche(condition,sequence);
-  }else{
-    testerEtAvancer("finsi");
-    return new NoeudInstSi(condition, sequence); // Et on renvoie un noeud Instruction Si   
-  }
+  testerEtAvancer(J_PARENTHESEFERMANTE);
+  ouvrirBloc(J_SI);                // Et on analyse la séquence d'instruction
+  m_blocs.back().conditions.push_back(condition);
+  return nullptr;
 }
 
 Noeud* Interpreteur::instRepeter(){
-    testerEtAvancer("repeter");
-    Noeud* sequence = seqInst();
-    testerEtAvancer("jusqua");
-    testerEtAvancer("(");
-    Noeud* condition = expression();
-    testerEtAvancer(")");
-    return new NoeudInstRepeter(sequence,condition);
+    testerEtAvancer(J_REPETER);
+    ouvrirBloc(J_REPETER);
+    return nullptr;
 }
 
- Noeud* Interpreteur::instEcrire() {
-    testerEtAvancer("ecrire");
-    testerEtAvancer("(");
-    /*m_table.chercheAjoute("<CHAINE>");
-    if (m_lecteur.getSymbole() == "<CHAINE>")
-     */
-    return nullptr;
- } 
 Noeud* Interpreteur::instTantQue() {
-    testerEtAvancer("tantque");
-    testerEtAvancer("(");
+    testerEtAvancer(J_TANTQUE);
+    testerEtAvancer(J_PARENTHESEOUVRANTE);
     Noeud* condition = expression();
-    testerEtAvancer(")");
-    Noeud* sequence = seqInst();
-    testerEtAvancer("fintantque");
-    return new NoeudInstTantQue(condition,sequence);
+    testerEtAvancer(J_PARENTHESEFERMANTE);
+    ouvrirBloc(J_TANTQUE);
+    m_blocs.back().conditions.push_back(condition);
+    return nullptr;
 }
-Noeud* Interpreteur::instSiRiche(Noeud* condition, Noeud* sequence) {
-    vector<Noeud*> conditions;
-    vector<Noeud*> sequences;
-    conditions.push_back(condition);
-    sequences.push_back(sequence);
-    while(m_lecteur.getSymbole() == "sinonsi"){
-        testerEtAvancer("sinonsi");
-        testerEtAvancer("(");
-        Noeud* condition1 = expression();
-        conditions.push_back(condition1);
-        testerEtAvancer(")");
-        Noeud* sequence1 = seqInst();
-        sequences.push_back(sequence1);
-
+Noeud* Interpreteur::instSiRiche(const vector<Noeud*> & conditions, const vector<Noeud*> & sequences) {
+    // les premières conditions comparent-elles toutes la même variable à des entiers ? (v == entier ou entier == v)
+    Noeud* variable = nullptr;
+    vector<int> valeurs;
+    for (unsigned int i = 0; i < conditions.size() && conditions[i] != nullptr; i++) {
+        if (conditions[i]->getGenre() != N_OPERATEURBINAIRE
+            || ((NoeudOperateurBinaire*) conditions[i])->getOperateur() != J_EGAL) break;
+        Noeud* gauche = ((NoeudOperateurBinaire*) conditions[i])->getOperandeGauche();
+        Noeud* droit = ((NoeudOperateurBinaire*) conditions[i])->getOperandeDroit();
+        int valeur;
+        if (Optimiseur::estConstante(gauche, valeur)) swap(gauche, droit);
+        if (gauche->getGenre() != N_SYMBOLEVALUE || *((SymboleValue*) gauche) != J_VARIABLE
+            || !Optimiseur::estConstante(droit, valeur) || (variable != nullptr && gauche != variable)) break;
+        variable = gauche;
+        valeurs.push_back(valeur);
     }
-    if(m_lecteur.getSymbole() == "sinon"){
-        testerEtAvancer("sinon");
-        Noeud * sequence1 = seqInst();
-        cout << sequence1 << endl;
-        conditions.push_back(sequence1);
-        sequences.push_back(sequence1);
-    }
-    testerEtAvancer("finsi");
-    return new NoeudInstSiRiche(conditions,sequences);
+    if (valeurs.size() < NoeudInstAiguillage::VALEURS_MIN) return m_arene.creer<NoeudInstSiRiche>(conditions,sequences);
+    // aiguillage sur la valeur de la variable ; le sinon est le reste de la chaîne
+    vector<Noeud*> suiteConditions(conditions.begin() + valeurs.size(), conditions.end());
+    vector<Noeud*> suiteSequences(sequences.begin() + valeurs.size(), sequences.end());
+    Noeud* sinon = nullptr;
+    if (suiteConditions.size() == 1 && suiteConditions[0] == nullptr) sinon = suiteSequences[0];
+    else if (!suiteConditions.empty()) sinon = m_arene.creer<NoeudInstSiRiche>(suiteConditions, suiteSequences);
+    vector<Noeud*> sequencesValeurs(sequences.begin(), sequences.begin() + valeurs.size());
+    return m_arene.creer<NoeudInstAiguillage>(variable, valeurs, sequencesValeurs, sinon);
 }
 Noeud* Interpreteur::instPour() {
-    testerEtAvancer("pour");
-    testerEtAvancer("(");
+    testerEtAvancer(J_POUR);
+    testerEtAvancer(J_PARENTHESEOUVRANTE);
     Noeud* affectation1 = NULL;
     Noeud* affectation2 = NULL;
-    if(!(m_lecteur.getSymbole() == ";")){
+    if(!(m_lecteur.getJeton() == J_POINTVIRGULE)){
        affectation1 = affectation();
     }
-    testerEtAvancer(";");
+    testerEtAvancer(J_POINTVIRGULE);
     Noeud* condition = expression();
-    testerEtAvancer(";");
-    if(!(m_lecteur.getSymbole() == ")")){
+    testerEtAvancer(J_POINTVIRGULE);
+    if(!(m_lecteur.getJeton() == J_PARENTHESEFERMANTE)){
         affectation2 = affectation();
     }
-    testerEtAvancer(")");
-    Noeud* sequence = seqInst();
-    testerEtAvancer("finpour");
-    return new NoeudInstPour(condition,sequence,affectation1,affectation2);
+    testerEtAvancer(J_PARENTHESEFERMANTE);
+    ouvrirBloc(J_POUR);
+    m_blocs.back().conditions.push_back(condition);
+    m_blocs.back().affectation1 = affectation1;
+    m_blocs.back().affectation2 = affectation2;
+    return nullptr;
 }
 
 Noeud* Interpreteur::instLire() {
-    testerEtAvancer("lire");
-    testerEtAvancer("(");
-    tester("<VARIABLE>");
+    testerEtAvancer(J_LIRE);
+    testerEtAvancer(J_PARENTHESEOUVRANTE);
+    tester(J_VARIABLE);
     vector<Noeud*> variables;
-    variables.push_back(facteur());
-    while (m_lecteur.getSymbole()== ",") {
-        testerEtAvancer("<VARIABLE>");
-        variables.push_back(facteur());
+    variables.push_back(m_table.chercheAjoute(m_lecteur.getNumeroChaine(), m_lecteur.getReservoir()));
+    m_lecteur.avancer();
+    while (m_lecteur.getJeton() == J_VIRGULE) {
+        testerEtAvancer(J_VIRGULE);
+        tester(J_VARIABLE);
+        variables.push_back(m_table.chercheAjoute(m_lecteur.getNumeroChaine(), m_lecteur.getReservoir()));
+        m_lecteur.avancer();
     }
-    testerEtAvancer(")");
-    return new NoeudInstLire(variables);
+    testerEtAvancer(J_PARENTHESEFERMANTE);
+    m_deterministe = false;
+    return m_arene.creer<NoeudInstLire>(variables);
  }
 //      <instEcrire> ::= ecrire ( <expression> | <chaine> { , <expression> | <chaine> } )
 Noeud* Interpreteur::instEcrire() {
-    testerEtAvancer("ecrire");
-    testerEtAvancer("(");
+    testerEtAvancer(J_ECRIRE);
+    testerEtAvancer(J_PARENTHESEOUVRANTE);
     vector<Noeud*> v;
     do{
         Noeud* ve;
-        if(m_lecteur.getSymbole() == "<CHAINE>"){
-          ve= new SymboleValue(m_lecteur.getSymbole().getChaine());
+        if(m_lecteur.getJeton() == J_CHAINE){
+          ve= m_arene.creer<NoeudChaine>(m_lecteur.getChaine());
           m_lecteur.avancer();
         }else{
           ve = expression();
         }
         v.push_back(ve);
-        if(m_lecteur.getSymbole() == ","){
-            testerEtAvancer(",");
+        if(m_lecteur.getJeton() == J_VIRGULE){
+            testerEtAvancer(J_VIRGULE);
         }
-    }while(m_lecteur.getSymbole() == "<CHAINE>" || m_lecteur.getSymbole() == "<VARIABLE>" );
-    testerEtAvancer(")");
-    return new NoeudInstEcrire(v);
+    }while(m_lecteur.getJeton() == J_CHAINE || m_lecteur.getJeton() == J_VARIABLE );
+    testerEtAvancer(J_PARENTHESEFERMANTE);
+    return m_arene.creer<NoeudInstEcrire>(v);
 }
@@ -5,47 +5,140 @@
 #include "Lecteur.h"
 #include "Exceptions.h"
 #include "TableSymboles.h"
+#include "TableExpressions.h"
 #include "ArbreAbstrait.h"
+#include "Arene.h"
 
 class Interpreteur {
 public:
-	Interpreteur(ifstream & fichier);   // Construit un interpréteur pour interpreter
-	                                    //  le programme dans  fichier 
+	Interpreteur(const string & nomFichier, bool parFlux = false); // Construit un interpréteur pour interpreter
+	                                         //  le programme dans le fichier nomFichier (si parFlux, en mode flux)
+	Interpreteur(istream & flux);            // Idem pour le programme lu dans flux
                                       
 	void analyse();                     // Si le contenu du fichier est conforme à la grammaire,
 	                                    //   cette méthode se termine normalement et affiche un message "Syntaxe correcte".
                                       //   la table des symboles (ts) et l'arbre abstrait (arbre) auront été construits
 	                                    // Sinon, une exception sera levée
+	                                    // Les variables lues certainement indéfinies sont signalées (voir AnalyseurFlot.h)
+	void optimiser();                   // Remplace l'arbre abstrait construit par analyse() par un arbre équivalent
+	                                    //   plus rapide à exécuter (voir Optimiseur.h), sans les tests que l'analyse
+	                                    //   de flot prouve inutiles (voir AnalyseurFlot.h)
+
+	// Mode flux : le programme est analysé une instruction de principale à la fois, chacune étant exécutée puis
+	//  oubliée avant que la suivante soit lue (voir Lecteur, lecture par fenêtre) : la mémoire ne dépend que de la
+	//  plus grande instruction, pas de la taille du fichier. Il n'y a pas d'arbre abstrait ; les entiers ne vont
+	//  pas dans la table des symboles, et la première erreur de syntaxe arrête l'analyse
+	void   commencerFlux();             // Analyse le début du programme : procedure principale ( )
+	Noeud* instructionSuivante();       // Oublie l'instruction précédente, puis analyse et renvoie la suivante ;
+	                                    //   nullptr à la fin du programme (finproc). Lève une exception comme analyse()
+	Noeud* optimiser(Noeud* instruction); // Instruction équivalente à instruction, plus rapide à exécuter (nullptr si
+	                                      //   elle ne fait rien), par les seules simplifications de Optimiseur::optimiser
 
 	inline const TableSymboles & getTable () const  { return m_table;    } // accesseur	
+	inline TableSymboles & getTable ()              { return m_table;    } // accesseur
 	inline Noeud* getArbre () const { return m_arbre; }                    // accesseur
+	inline const Arene & getArene () const { return m_arene; }             // accesseur
+	inline const TamponSource & getSource () const { return m_lecteur.getSource(); } // le texte analysé
+	inline unsigned int getNombreErreurs () const { return m_nombreErreurs; } // instructions incorrectes sautées
+	inline unsigned int getNombreAvertissements () const { return m_nombreAvertissements; } // lectures indéfinies signalées
+	inline bool estDeterministe () const { return m_deterministe; } // vrai si le programme analysé n'a pas de lire :
+	                                                                 //  ce qu'il écrit ne dépend que de son texte
+	inline unsigned int getProfondeurMax () const { return m_profondeurMax; } // accesseur
+	inline void setProfondeurMax (unsigned int profondeur) { m_profondeurMax = profondeur; }
+	// Nombre de niveaux d'imbrication acceptés par analyse() : chaque bloc (si, tantque, repeter, pour) ouvert
+	//  et chaque opérateur entre la racine d'une expression et sa feuille la plus profonde (les parenthèses ne
+	//  comptent pas) ajoute un niveau. Au-delà, analyse() lève ProfondeurException : l'arbre abstrait, que les
+	//  passes suivantes parcourent récursivement, n'est jamais plus profond
+	static const unsigned int PROFONDEUR_MAX; // Valeur par défaut de getProfondeurMax()
 	
 private:
     Lecteur        m_lecteur;  // Le lecteur de symboles utilisé pour analyser le fichier
+    Arene          m_arene;    // L'arène où est alloué l'arbre abstrait, libérée d'un coup à la destruction de
+                               //  l'interpréteur (en mode flux, après chaque instruction)
+    Arene          m_areneSymboles; // Celle où sont alloués les symboles valués, qui durent tout le programme
     TableSymboles  m_table;    // La table des symboles valués
+    TableExpressions m_expressions; // Les opérations et constantes de l'arbre, chacune construite une seule fois
     Noeud*         m_arbre;    // L'arbre abstrait
+    unsigned int   m_nombreErreurs; // Nombre d'erreurs de syntaxe traitées (instructions sautées) par inst()
+    unsigned int   m_nombreAvertissements; // Nombre de variables signalées lues certainement indéfinies
+    bool           m_deterministe;  // Faux dès qu'une instruction lire a été analysée
+    unsigned int   m_profondeurMax; // voir setProfondeurMax()
+    bool           m_parFlux;  // Vrai en mode flux
+    Arene::Marque  m_marque;   // Mode flux : l'arène avant la première instruction
+
+    struct Bloc {    // Un bloc en cours d'analyse (voir seqInst())
+        Jeton          genre;        // Le symbole qui l'a ouvert (J_SI, J_TANTQUE, J_REPETER, J_POUR), J_PROCEDURE
+                                     //  pour la séquence du programme
+        NoeudSeqInst*  sequence;     // La séquence en cours d'analyse
+        bool           vide;         // Vrai si <seqInst> y attend encore une instruction (la séquence vient d'être
+                                     //  ouverte, ou une instruction incorrecte vient d'être sautée)
+        vector<Noeud*> conditions;   // La condition de chaque séquence (nullptr pour le sinon d'un si)
+        vector<Noeud*> sequences;    // Les séquences déjà terminées (si)
+        Noeud*         affectation1; // Les affectations d'un pour (peuvent être nullptr)
+        Noeud*         affectation2;
+    };
+    vector<Bloc>   m_blocs;    // Pile des blocs ouverts, le premier est le programme
+
+    struct Operande {                // Une expression déjà construite par expression()
+        Noeud*       noeud;
+        unsigned int profondeur;     // Nombre d'opérateurs entre sa racine et sa feuille la plus profonde
+    };
+    struct EnAttente {               // Un opérateur dont expression() n'a pas encore l'opérande droit
+        Noeud*        gauche;        // Son opérande gauche, s'il est binaire (nullptr sinon)
+        unsigned int  profondeur;    //  et la profondeur de celui-ci
+        Jeton         jeton;
+        unsigned char priorite;      // Celle de la table des opérateurs ; 0 pour une parenthèse ouverte,
+    };                               //  UNAIRE pour - et non unaires
+    static const unsigned char UNAIRE = 0xFF;
+    vector<EnAttente> m_operateurs;  // La pile de expression()
 
     // Implémentation de la grammaire
     Noeud*  programme();   //   <programme> ::= procedure principale() <seqInst> finproc FIN_FICHIER
     Noeud*  seqInst();	   //     <seqInst> ::= <inst> { <inst> }
-    Noeud*  inst();	       //        <inst> ::= <affectation> ; | <instSi>
+                           //  la séquence du programme, instruction après instruction (instructionPrincipale)
+    Noeud*  instructionPrincipale();
+                           // Analyse l'instruction suivante de la séquence du programme, avec tous ses blocs
+                           //  imbriqués, par une boucle sur la pile m_blocs, sans récursion : la pile native ne
+                           //  dépend pas du programme. Renvoie nullptr quand la séquence est finie
+    Noeud*  inst();	       //        <inst> ::= <affectation> ; | <instSi> | ...
+                           //  renvoie l'instruction, ou nullptr si elle ouvre un bloc (empilé sur m_blocs)
+    Noeud*  instAffectation(); //    <affectation> ;
     Noeud*  affectation(); // <affectation> ::= <variable> = <expression> 
     Noeud*  expression();  //  <expression> ::= <facteur> { <opBinaire> <facteur> }
-    Noeud*  facteur();     //     <facteur> ::= <entier>  |  <variable>  |  - <facteur>  | non <facteur> | ( <expression> )
+                           //     <facteur> ::= <entier>  |  <variable>  |  - <facteur> | non <facteur> | ( <expression> )
                            //   <opBinaire> ::= + | - | *  | / | < | > | <= | >= | == | != | et | ou
+                           //  analysée par priorité des opérateurs (voir la table des opérateurs dans Interpreteur.cpp),
+                           //  sans récursion : les opérateurs en attente sont sur m_operateurs
+    Operande reduire(Operande dernier, unsigned int priorite);
+                           // Construit les chaînes d'opérateurs en attente de priorité supérieure à priorite (jusqu'à la
+                           //  parenthèse ouverte), dernier étant l'opérande droit du sommet : renvoie l'expression construite
+    Operande equilibrer(unsigned int debut, unsigned int fin, const Operande & dernier, bool inverse);
+                           // Expression équilibrée de la chaîne d'opérateurs associatifs m_operateurs[debut..fin) (l'opérande
+                           //  de rang fin, après le sommet, est dernier) ; inverse échange + et -
     Noeud*  instSi();      //      <instSi> ::= si ( <expression> ) <seqInst> finsi
     
     Noeud* instRepeter();  // <instRepeter> ::= repeter<seqInst> jusqua (<expression>)
-    Noeud*  instSiRiche(Noeud* condition, Noeud* sequence); //   <instSiRiche> ::= si (expression) <seqInst> { sinonsi (<expression>) <seqInst> } [sinon <seqInst>] finsi  
+    Noeud*  instSiRiche(const vector<Noeud*> & conditions, const vector<Noeud*> & sequences);
+                           //   <instSiRiche> ::= si (expression) <seqInst> { sinonsi (<expression>) <seqInst> } [sinon <seqInst>] finsi  
+                           //  construit le noeud (ou l'aiguillage) des conditions et séquences analysées
     Noeud*  instTantQue(); //      <instTantQue> ::= tantque (<expression> ) <seqInst> fintantque
     Noeud*  instPour();    //      <instPour> ::= pour([<affectation> ]; <expression>; [<affectation>]) <seInst> finpour
     Noeud*  instEcrire();  //      <instEcrire> ::= ecrire ( <expression> | <chaine> { , <expression> | <chaine> } ))
     Noeud* instLire();     // <instLire> ::= lire ( <variable> { , <variable> } ) 
+    // instSi, instRepeter, instTantQue et instPour analysent le début de leur bloc, jusqu'à sa séquence, et l'ouvrent :
+    void    ouvrirBloc(Jeton genre);     // Empile un bloc genre, de séquence vide ; ProfondeurException s'il y en a trop
+    Noeud*  fermerBloc();  // Analyse ce qui suit la séquence du bloc du sommet : renvoie son instruction, ou nullptr
+                           //  si une autre séquence commence (sinonsi, sinon)
+
+    typedef Noeud* (Interpreteur::*RegleInstruction)();
+    static const RegleInstruction s_instructions[NB_JETONS]; // Règle à appliquer pour chaque symbole qui commence
+                                                              //  une instruction, nullptr pour les autres symboles
 
 	// outils pour simplifier l'analyse syntaxique
-    void tester (const string & symboleAttendu) const throw (SyntaxeException);   // Si symbole courant != symboleAttendu, on lève une exception
-    void testerEtAvancer(const string & symboleAttendu) throw (SyntaxeException); // Si symbole courant != symboleAttendu, on lève une exception, sinon on avance
-    void erreur (const string & mess) const throw (SyntaxeException);             // Lève une exception "contenant" le message mess
+    void tester (Jeton symboleAttendu) const;   // Si symbole courant != symboleAttendu, on lève une exception SyntaxeException
+    void testerEtAvancer(Jeton symboleAttendu); // Si symbole courant != symboleAttendu, on lève une exception, sinon on avance
+    [[noreturn]] void erreur (const string & mess) const; // Lève une exception SyntaxeException "contenant" le message mess
+    [[noreturn]] void erreurProfondeur () const; // Lève une exception ProfondeurException (voir setProfondeurMax)
 };
 
 #endif /* INTERPRETEUR_H */
@@ -3,130 +3,254 @@
 #include <ctype.h>
 #include <string.h>
 #include <iostream>
+#include <algorithm>
+#include <thread>
 using namespace std;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-Lecteur::Lecteur(ifstream& fichier) :
-m_lecteurCar(fichier), m_symbole("") {
-  avancer(); // pour aller lire le premier symbole
+unsigned int Lecteur::s_nombreOuvriers = 0;
+const size_t Lecteur::TAILLE_MIN_MORCEAU = 1 << 20;
+const unsigned int Lecteur::TAILLE_FENETRE = 1 << 14;
+
+Lecteur::Lecteur(const string & nomFichier, bool parFenetre) :
+m_source(nomFichier), m_reservoir(), m_flux(), m_courant(0), m_origine(m_source.getDebut()), m_lecteurCar(m_source),
+m_toutDecoupe(!parFenetre) {
+  if (parFenetre) recharger(); // pour lire les premiers symboles
+  else decouper();             // pour lire tous les symboles, le premier devient le symbole courant
+}
+
+Lecteur::Lecteur(istream & flux) :
+m_source(flux), m_reservoir(), m_flux(), m_courant(0), m_origine(m_source.getDebut()), m_lecteurCar(m_source),
+m_toutDecoupe(true) {
+  decouper(); // pour lire tous les symboles, le premier devient le symbole courant
+}
+
+void Lecteur::setNombreOuvriers(unsigned int nombre) {
+  s_nombreOuvriers = nombre;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+string Lecteur::getChaine() const {
+  return string(m_origine + m_flux.getDebut(m_courant), m_flux.getLongueur(m_courant));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Lecteur::decouper() {
+  unsigned int ouvriers = s_nombreOuvriers != 0 ? s_nombreOuvriers : thread::hardware_concurrency();
+  unsigned int morceaux = min<size_t>(ouvriers, m_source.getTaille() / TAILLE_MIN_MORCEAU);
+  if (morceaux > 1) {
+    decouperEnParallele(morceaux);
+  } else {
+    m_flux.reserver(m_source.getTaille() / 4); // estimation grossière, pour limiter les recopies
+    decouperMorceau(m_source.getDebut(), m_source.getFin(), m_source.getDebut(), m_flux, m_reservoir);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Lecteur::avancer() {
-  sauterSeparateurs();
+inline Jeton Lecteur::decouperSymbole(LecteurCaractere & lecteurCar, const char* origine, FluxJetons & flux,
+                                      ReservoirChaines & reservoir, bool valeurs) {
+  sauterSeparateurs(lecteurCar);
   // on est maintenant positionne sur le premier caractère d'un symbole
-  m_ligne = m_lecteurCar.getLigne();
-  m_colonne = m_lecteurCar.getColonne();
-  m_symbole = Symbole(motSuivant()); // on reconstruit symbole avec le nouveau mot lu
+  unsigned int ligne = lecteurCar.getLigne();
+  unsigned int colonne = lecteurCar.getColonne();
+  const char* debut = lecteurCar.getPosition();
+  motSuivant(lecteurCar);
+  unsigned int longueur = lecteurCar.getPosition() - debut;
+  Jeton jeton = Symbole::classer(debut, longueur);
+  unsigned int numero = FluxJetons::AUCUNE_CHAINE;
+  if (jeton == J_VARIABLE || (valeurs && (jeton == J_ENTIER || jeton == J_CHAINE)))
+    numero = reservoir.interner(debut, longueur);
+  flux.ajouter(jeton, debut - origine, longueur, ligne, colonne, numero);
+  return jeton;
+}
+
+bool Lecteur::decouperMorceau(const char* debutMorceau, const char* finMorceau, const char* origine,
+                              FluxJetons & flux, ReservoirChaines & reservoir) {
+  LecteurCaractere lecteurCar(debutMorceau, finMorceau);
+  while (decouperSymbole(lecteurCar, origine, flux, reservoir, true) != J_FINDEFICHIER);
+  return lecteurCar.getPosition() == finMorceau;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Lecteur::sauterSeparateurs() {
-  while (m_lecteurCar.getCaractere() == ' ' ||
-          m_lecteurCar.getCaractere() == '\t' ||
-          m_lecteurCar.getCaractere() == '\r' ||
-          m_lecteurCar.getCaractere() == '\n')
-    m_lecteurCar.avancer();
-  if (m_lecteurCar.getCaractere() == '#') {
-    do {
-      m_lecteurCar.avancer();
-    } while (m_lecteurCar.getCaractere() != '\r' &&
-            m_lecteurCar.getCaractere() != '\n' &&
-            m_lecteurCar.getCaractere() != EOF);
-    sauterSeparateurs();
+void Lecteur::recharger() {
+  // Les symboles avant le symbole courant ne seront plus lus : ses positions et celles des suivants sont
+  // désormais comptées depuis lui. Les entiers et les chaînes, différents presque à chaque instruction d'un gros
+  // programme, ne vont pas dans le réservoir, qui ne garderait sinon rien de moins que le texte
+  if (m_flux.getTaille() > 0) {
+    unsigned int decalage = m_flux.getDebut(m_courant);
+    m_flux.retirerDebut(m_courant, decalage);
+    m_origine += decalage;
+    m_courant = 0;
   }
+  m_source.oublierAvant(m_origine);
+  for (unsigned int i = 0; i < TAILLE_FENETRE && !m_toutDecoupe; i++)
+    m_toutDecoupe = decouperSymbole(m_lecteurCar, m_origine, m_flux, m_reservoir, false) == J_FINDEFICHIER;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-string Lecteur::motSuivant() {
-  string s;
-  s = "";
-  if (isdigit(m_lecteurCar.getCaractere()))
-    // c'est le début d'un entier
-    do {
-      s = s + m_lecteurCar.getCaractere();
-      m_lecteurCar.avancer();
-    } while (isdigit(m_lecteurCar.getCaractere()));
+// Exécute tache(0), tache(1), ..., tache(nombre - 1), chacune dans son propre fil d'exécution
+template <class Tache>
+static void executerEnParallele(unsigned int nombre, const Tache & tache) {
+  vector<thread> ouvriers;
+  for (unsigned int i = 1; i < nombre; i++) ouvriers.push_back(thread(tache, i));
+  tache(0); // le fil courant fait sa part
+  for (unsigned int i = 0; i < ouvriers.size(); i++) ouvriers[i].join();
+}
 
-  else if (isalpha(m_lecteurCar.getCaractere()))
-    // c'est le début d'un mot
-    do {
-      s = s + m_lecteurCar.getCaractere();
-      m_lecteurCar.avancer();
-    } while (isalpha(m_lecteurCar.getCaractere()) ||
-            isdigit(m_lecteurCar.getCaractere()) ||
-            m_lecteurCar.getCaractere() == '_');
-  else if (m_lecteurCar.getCaractere() == '"') {
-    // c'est le début d'une chaîne
-    do {
-      s = s + m_lecteurCar.getCaractere();
-      m_lecteurCar.avancer();
-    } while (m_lecteurCar.getCaractere() != '"' &&
-            m_lecteurCar.getCaractere() != '\n' &&
-            m_lecteurCar.getCaractere() != EOF);
-    if (m_lecteurCar.getCaractere() == '"') {
-      s = s + m_lecteurCar.getCaractere();
-      m_lecteurCar.avancer();
-    }
-  } else if (m_lecteurCar.getCaractere() == '=' || m_lecteurCar.getCaractere() == '!' ||
-          m_lecteurCar.getCaractere() == '<' || m_lecteurCar.getCaractere() == '>') {
-    s = s + m_lecteurCar.getCaractere();
-    m_lecteurCar.avancer();
-    if (m_lecteurCar.getCaractere() == '=') {
-      // pour lire les symbole == != <= >=
-      s = s + m_lecteurCar.getCaractere();
-      m_lecteurCar.avancer();
-    }
-  } else if (m_lecteurCar.getCaractere() == '+') {
-    s = s + m_lecteurCar.getCaractere();
-    m_lecteurCar.avancer();
-    if (m_lecteurCar.getCaractere() == '+') {
-      // pour lire les symbole ++
-      s = s + m_lecteurCar.getCaractere();
-      m_lecteurCar.avancer();
+void Lecteur::decouperEnParallele(unsigned int nombreMorceaux) {
+  // Les morceaux commencent tous au début d'une ligne. Aucun symbole ne contient de fin de ligne,
+  // et un commentaire ou une chaîne s'arrête toujours à la fin de sa ligne : la frontière entre
+  // deux lignes est donc toujours sûre, et chaque morceau peut être découpé indépendamment.
+  const char* debut = m_source.getDebut();
+  const char* fin = m_source.getFin();
+  vector<const char*> bornes(1, debut);
+  for (unsigned int k = 1; k < nombreMorceaux; k++) {
+    const char* p = max(bornes.back(), debut + m_source.getTaille() / nombreMorceaux * k);
+    const char* finDeLigne = (const char*) memchr(p, '\n', fin - p);
+    if (finDeLigne == nullptr || finDeLigne + 1 == fin) break;
+    if (finDeLigne + 1 > bornes.back()) bornes.push_back(finDeLigne + 1);
+  }
+  bornes.push_back(fin);
+  nombreMorceaux = bornes.size() - 1;
+
+  // 1) chaque morceau est découpé avec ses propres lignes (depuis 1) et son propre réservoir
+  struct Morceau {
+    FluxJetons       flux;
+    ReservoirChaines reservoir;
+    bool             complet;       // faux si le morceau s'arrête sur un caractère EOF
+    unsigned int     finsDeLigne;   // nombre de fins de ligne du morceau
+    unsigned int     premierJeton;  // indice de son premier jeton dans le flux recollé
+    unsigned int     premiereLigne; // numéro (dans tout le texte) de sa première ligne, moins 1
+    vector<unsigned int> numeros;   // numéro, dans le réservoir commun, de chaque chaîne de son réservoir
+  };
+  vector<Morceau> morceaux(nombreMorceaux);
+  Balayeur::getJeuInstructions(); // choisit les noyaux avant de lancer les fils d'exécution
+  executerEnParallele(nombreMorceaux, [&](unsigned int i) {
+    Morceau & m = morceaux[i];
+    m.flux.reserver((bornes[i + 1] - bornes[i]) / 4);
+    m.complet = decouperMorceau(bornes[i], bornes[i + 1], debut, m.flux, m.reservoir);
+    m.finsDeLigne = count(bornes[i], bornes[i + 1], '\n');
+  });
+
+  // 2) on place les morceaux les uns derrière les autres et on fusionne leurs réservoirs
+  unsigned int jetons = 0, lignes = 0;
+  for (unsigned int i = 0; i < nombreMorceaux; i++) {
+    Morceau & m = morceaux[i];
+    m.premierJeton = jetons;
+    m.premiereLigne = lignes;
+    m.numeros.resize(m.reservoir.getTaille());
+    for (unsigned int n = 0; n < m.numeros.size(); n++) {
+      const string & chaine = m.reservoir.getChaine(n);
+      m.numeros[n] = m_reservoir.interner(chaine.data(), chaine.size());
     }
-  } else if (m_lecteurCar.getCaractere() == '-') {
-    s = s + m_lecteurCar.getCaractere();
-    m_lecteurCar.avancer();
-    if (m_lecteurCar.getCaractere() == '-') {
-      // pour lire les symbole --
-      s = s + m_lecteurCar.getCaractere();
-      m_lecteurCar.avancer();
+    bool dernier = (i + 1 == nombreMorceaux || !m.complet);
+    jetons += m.flux.getTaille() - (dernier ? 0 : 1); // le J_FINDEFICHIER d'un morceau intermédiaire disparaît
+    lignes += m.finsDeLigne;
+    if (dernier) {
+      nombreMorceaux = i + 1; // un caractère EOF termine le texte : on ignore les morceaux suivants
+      break;
     }
-  } else if (m_lecteurCar.getCaractere() != EOF)
-    // c'est un caractere spécial
-  {
-    s = m_lecteurCar.getCaractere();
-    m_lecteurCar.avancer();
   }
-  return s;
+
+  // 3) et on recopie tous les jetons dans le flux commun, en même temps
+  m_flux.redimensionner(jetons);
+  executerEnParallele(nombreMorceaux, [&](unsigned int i) {
+    Morceau & m = morceaux[i];
+    unsigned int nombre = (i + 1 == nombreMorceaux) ? m.flux.getTaille() : m.flux.getTaille() - 1;
+    m_flux.recopier(m.premierJeton, m.flux, nombre, m.premiereLigne, m.numeros);
+  });
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-LecteurCaractere::LecteurCaractere(ifstream & fichier) : m_fichier(fichier) {
-  m_ligne = 1;
-  m_colonne = 0;
-  if (m_fichier.fail()) // si le fichier ne peut-être lu...
-    throw FichierException();
-  avancer();
+void Lecteur::sauterSeparateurs(LecteurCaractere & lecteurCar) {
+  // les suites de séparateurs et les commentaires sont sautés d'un bloc (voir Balayeur)
+  for (;;) {
+    lecteurCar.sauterJusqua(Balayeur::sauterBlancs(lecteurCar.getPosition(), lecteurCar.getFin()));
+    if (lecteurCar.getCaractere() != '#') return;
+    // on saute le commentaire jusqu'à la fin de la ligne
+    lecteurCar.avancer();
+    lecteurCar.sauterJusqua(Balayeur::finLigne(lecteurCar.getPosition(), lecteurCar.getFin()));
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void LecteurCaractere::avancer() {
-  if (m_fichier.peek() == EOF)
+void Lecteur::motSuivant(LecteurCaractere & lecteurCar) {
+  if (isdigit(lecteurCar.getCaractere())) {
+    // c'est le début d'un entier
+    lecteurCar.avancer();
+    lecteurCar.sauterJusqua(Balayeur::finEntier(lecteurCar.getPosition(), lecteurCar.getFin()));
+  } else if (isalpha(lecteurCar.getCaractere())) {
+    // c'est le début d'un mot
+    lecteurCar.avancer();
+    lecteurCar.sauterJusqua(Balayeur::finMot(lecteurCar.getPosition(), lecteurCar.getFin()));
+  } else if (lecteurCar.getCaractere() == '"') {
+    // c'est le début d'une chaîne
+    lecteurCar.avancer();
+    lecteurCar.sauterJusqua(Balayeur::finChaine(lecteurCar.getPosition(), lecteurCar.getFin()));
+    if (lecteurCar.getCaractere() == '"')
+      lecteurCar.avancer();
+  } else if (lecteurCar.getCaractere() == '=' || lecteurCar.getCaractere() == '!' ||
+          lecteurCar.getCaractere() == '<' || lecteurCar.getCaractere() == '>') {
+    lecteurCar.avancer();
+    if (lecteurCar.getCaractere() == '=') // pour lire les symbole == != <= >=
+      lecteurCar.avancer();
+  } else if (lecteurCar.getCaractere() == '+') {
+    lecteurCar.avancer();
+    if (lecteurCar.getCaractere() == '+') // pour lire les symbole ++
+      lecteurCar.avancer();
+  } else if (lecteurCar.getCaractere() == '-') {
+    lecteurCar.avancer();
+    if (lecteurCar.getCaractere() == '-') // pour lire les symbole --
+      lecteurCar.avancer();
+  } else if (lecteurCar.getCaractere() != EOF)
+    // c'est un caractere spécial
+    lecteurCar.avancer();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+LecteurCaractere::LecteurCaractere(const TamponSource & source) :
+LecteurCaractere(source.getDebut(), source.getFin()) {
+}
+
+LecteurCaractere::LecteurCaractere(const char* debut, const char* fin) :
+m_position(debut), m_fin(fin) {
+  m_ligne = 1;
+  if (m_position == m_fin) { // texte vide
     m_caractere = EOF;
-  else {
-    if (m_caractere == '\n') {
-      m_colonne = 0;
-      m_ligne++;
-    }
-    m_fichier.get(m_caractere);
-    m_colonne++;
+    m_colonne = 0;
+  } else {
+    m_caractere = *m_position;
+    m_colonne = 1;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void LecteurCaractere::sauterJusqua(const char* cible) {
+  if (cible == m_position) return;
+  if (cible == m_fin) {
+    // on va sur le dernier caractère, puis sur EOF sans changer de ligne ni de colonne
+    sauterJusqua(m_fin - 1);
+    avancer();
+    return;
+  }
+  // les fins de ligne des caractères quittés font changer de ligne
+  const char* finDeLigne = nullptr;
+  for (const char* p = m_position; (p = (const char*) memchr(p, '\n', cible - p)) != nullptr; p++) {
+    finDeLigne = p;
+    m_ligne++;
   }
+  if (finDeLigne != nullptr) m_colonne = cible - finDeLigne;
+  else m_colonne += cible - m_position;
+  m_position = cible;
+  m_caractere = *cible;
 }
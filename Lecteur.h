@@ -6,17 +6,26 @@
 using namespace std;
 
 #include "Symbole.h"
+#include "TamponSource.h"
+#include "FluxJetons.h"
+#include "Balayeur.h"
 
-// Lecteur pour parcourir un fichier texte caractère par caractère
+// Lecteur pour parcourir un texte source caractère par caractère
+// Le texte est entièrement en mémoire (voir TamponSource) : on avance un simple pointeur
 
 class LecteurCaractere {
 public:
-    LecteurCaractere(ifstream & fichier); // Construit le lecteur pour parcourir fichier
+    LecteurCaractere(const TamponSource & source); // Construit le lecteur pour parcourir source
+    LecteurCaractere(const char* debut, const char* fin); // Construit le lecteur pour parcourir [debut, fin)
 
     inline char getCaractere() const {
         return m_caractere;
     } // Caractere courant
 
+    inline const char* getPosition() const {
+        return m_position;
+    } // Adresse du caractère courant dans le tampon (fin du tampon si on est sur EOF)
+
     inline unsigned int getLigne() const {
         return m_ligne;
     } // Ligne du caractère courant
@@ -24,40 +33,116 @@ public:
     inline unsigned int getColonne() const {
         return m_colonne;
     } // Colonne du caractère courant
-    void avancer(); // Passe au caractere suivant, s'il existe, sinon reste sur le caractère de fin de fichier (EOF)
+
+    inline void avancer() {
+        if (m_position == m_fin) return; // on reste sur le caractère de fin de fichier
+        bool finDeLigne = (*m_position == '\n');
+        if (++m_position == m_fin) {
+            m_caractere = EOF; // la ligne et la colonne restent celles du dernier caractère
+        } else {
+            if (finDeLigne) {
+                m_colonne = 0;
+                m_ligne++;
+            }
+            m_caractere = *m_position;
+            m_colonne++;
+        }
+    } // Passe au caractere suivant, s'il existe, sinon reste sur le caractère de fin de fichier (EOF)
+
+    void sauterJusqua(const char* cible);
+    // Avance directement jusqu'au caractère d'adresse cible (entre la position courante et getFin()),
+    // avec la même ligne et la même colonne que si l'on avait appelé avancer() plusieurs fois
+
+    inline const char* getFin() const {
+        return m_fin;
+    } // Adresse qui suit le dernier caractère du texte
 
 private:
-    ifstream& m_fichier; // Le fichier texte que l'on parcourt
+    const char*  m_position; // Le caractère courant dans le texte que l'on parcourt
+    const char*  m_fin;      // La fin du texte que l'on parcourt
     char m_caractere; // Le caractere courant
     unsigned int m_ligne; // Ligne du caractere courant dans le fichier
     unsigned int m_colonne; // Colonne du caractere courant dans le fichier
 };
 
 // Lecteur pour parcourir un fichier texte symbole par symbole
+// Tout le texte est découpé en symboles dès la construction, dans un flux de jetons (voir FluxJetons) :
+// le symbole courant n'est qu'un indice dans ce flux, et on peut regarder aussi loin que l'on veut devant lui.
+// En lecture par fenêtre, le flux ne garde que TAILLE_FENETRE symboles à partir du symbole courant, découpés
+// au fur et à mesure : la mémoire ne dépend plus de la taille du texte
 
 class Lecteur {
 public:
-    Lecteur(ifstream & fichier); // Résultat : symbole = premier symbole du fichier
-    void avancer(); // Passe au symbole suivant du fichier
+    Lecteur(const string & nomFichier, bool parFenetre = false); // Résultat : symbole = premier symbole du fichier
+                                                                 //  (si parFenetre, lecture par fenêtre)
+    Lecteur(istream & flux);            // Idem, mais le texte est lu dans flux
+
+    inline void avancer() {
+        if (m_courant + 1 < m_flux.getTaille()) m_courant++;
+        else if (!m_toutDecoupe) {
+            recharger();
+            m_courant++;
+        }
+    } // Passe au symbole suivant du fichier (on reste sur la fin de fichier une fois qu'on l'a atteinte)
+
+    inline Jeton getJeton(unsigned int decalage = 0) const {
+        unsigned int i = m_courant + decalage;
+        return i < m_flux.getTaille() ? m_flux.getJeton(i) : J_FINDEFICHIER;
+    } // Code du symbole courant, ou du symbole situé decalage symboles plus loin
+      //  (en lecture par fenêtre, seulement s'il est déjà découpé)
+
+    inline unsigned int getNumeroChaine() const {
+        return m_flux.getNumeroChaine(m_courant);
+    } // Numéro dans le réservoir de l'orthographe du symbole courant (variable, entier ou chaîne)
 
-    inline const Symbole& getSymbole() const {
-        return m_symbole;
-    } // Symbole courant
+    string getChaine() const; // Texte du symbole courant
+
+    inline const ReservoirChaines & getReservoir() const {
+        return m_reservoir;
+    } // Les orthographes des variables, entiers et chaînes du fichier (en lecture par fenêtre, seulement des
+      //  variables : les entiers et les chaînes n'ont pas de numéro de chaîne)
+
+    inline const TamponSource & getSource() const {
+        return m_source;
+    } // Le texte source analysé
 
     inline unsigned int getLigne() const {
-        return m_ligne;
+        return m_flux.getLigne(m_courant);
     } // Ligne du symbole courant
 
     inline unsigned int getColonne() const {
-        return m_colonne;
+        return m_flux.getColonne(m_courant);
     } // Colonne du symbole courant
 
+    static void setNombreOuvriers(unsigned int nombre); // Nombre de fils d'exécution pour découper les gros textes
+                                                        //  (0, par défaut : un par processeur ; voir aussi ComparateurLecteurs)
+
 private:
-    LecteurCaractere m_lecteurCar; // Le lecteur de caractères utilisé
-    Symbole m_symbole; // Le symbole courant du lecteur de symboles
-    unsigned int m_ligne, m_colonne; // Coordonnees, dans le fichier, du symbole courant
-    void sauterSeparateurs(); // Saute avec m_lecteurCar une suite de séparateurs, commentaires consécutifs
-    string motSuivant(); // Lit avec m_lecteurCar la chaîne du prochain symbole et la renvoie en résultat
+    TamponSource     m_source;     // Le texte source, entièrement en mémoire
+    ReservoirChaines m_reservoir;  // Les orthographes des symboles qui en ont une
+    FluxJetons       m_flux;       // Tous les symboles du fichier (en lecture par fenêtre, ceux de la fenêtre)
+    unsigned int     m_courant;    // Indice du symbole courant dans m_flux
+    const char*      m_origine;    // Adresse d'où sont comptées les positions des symboles de m_flux
+    LecteurCaractere m_lecteurCar; // Lecture par fenêtre : la suite du texte, à découper
+    bool             m_toutDecoupe; // Vrai quand le dernier symbole de m_flux est la fin du fichier
+    static unsigned int s_nombreOuvriers; // Voir setNombreOuvriers
+    static const size_t TAILLE_MIN_MORCEAU; // Taille en dessous de laquelle découper en parallèle ne vaut pas la peine
+    static const unsigned int TAILLE_FENETRE; // Nombre de symboles découpés à la fois en lecture par fenêtre
+
+    void decouper(); // Découpe tout le texte en symboles rangés dans m_flux (en parallèle si le texte est gros)
+    void decouperEnParallele(unsigned int nombreMorceaux); // Découpe le texte en morceaux en même temps, puis les recolle
+    void recharger();  // Lecture par fenêtre : oublie les symboles avant le symbole courant (qui devient le premier)
+                       //  et découpe les TAILLE_FENETRE suivants
+    static bool decouperMorceau(const char* debut, const char* fin, const char* origine,
+                                FluxJetons & flux, ReservoirChaines & reservoir);
+    // Découpe [debut, fin) en symboles ajoutés à flux (positions comptées depuis origine), terminés par J_FINDEFICHIER ;
+    // renvoie faux si le découpage s'est arrêté avant fin (sur un caractère EOF)
+    static inline Jeton decouperSymbole(LecteurCaractere & lecteurCar, const char* origine, FluxJetons & flux,
+                                        ReservoirChaines & reservoir, bool valeurs);
+    // Découpe avec lecteurCar le symbole suivant et l'ajoute à flux ; l'orthographe des variables est rangée
+    // dans reservoir, et, si valeurs, celle des entiers et des chaînes aussi
+    static void sauterSeparateurs(LecteurCaractere & lecteurCar); // Saute avec lecteurCar une suite de séparateurs, commentaires consécutifs
+    static void motSuivant(LecteurCaractere & lecteurCar); // Lit avec lecteurCar les caractères du prochain symbole (sans les recopier)
 };
 
 #endif /* LECTEUR_H */ 
@@ -0,0 +1,30 @@
+#!/bin/bash
+# Mesures : durée de chaque programme de MESURES avec l'arbre de pointeurs, puis avec chaque option donnée.
+# Usage : MESURES/mesurer.sh interpreteur [option ...]     (par exemple : MESURES/mesurer.sh ./interp --aplati)
+# Chaque programme est lancé FOIS fois (3 par défaut) dans chaque mode, et on garde la meilleure durée ;
+# les sorties de tous les modes doivent être identiques.
+
+interpreteur=$1
+shift
+[ -x "$interpreteur" ] || { echo "Usage : $0 interpreteur [option ...]"; exit 2; }
+FOIS=${FOIS:-3}
+statut=0
+for programme in "$(dirname "$0")"/*.txt; do
+  reference=
+  for option in "" "$@"; do
+    meilleure=
+    for ((n = 0; n < FOIS; n++)); do
+      debut=$(date +%s%N)
+      sortie=$("$interpreteur" $option "$programme" < /dev/null)
+      duree=$((($(date +%s%N) - debut) / 1000000))
+      [ -z "$meilleure" ] || [ $duree -lt $meilleure ] && meilleure=$duree
+    done
+    [ -z "$option" ] && reference=$sortie
+    if [ "$sortie" != "$reference" ]; then
+      echo "$(basename "$programme") ${option:-arbre} : sortie différente de celle de l'arbre de pointeurs"
+      statut=1
+    fi
+    printf "%-20s %-22s %8d ms\n" "$(basename "$programme")" "${option:-arbre}" $meilleure
+  done
+done
+exit $statut
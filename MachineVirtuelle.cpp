@@ -0,0 +1,107 @@
+#include "MachineVirtuelle.h"
+#include "Exceptions.h"
+#include "Sortie.h"
+#include "Entree.h"
+#include <iostream>
+
+MachineVirtuelle::MachineVirtuelle(const Bytecode & bytecode, vector<Emplacement> & emplacements)
+: m_bytecode(bytecode), m_emplacements(emplacements), m_pile(bytecode.getProfondeurMax() + 1) {
+}
+
+#if defined(__GNUC__)
+#define MV_GOTO_CALCULE
+#endif
+
+#ifdef MV_GOTO_CALCULE
+#define CAS(operation) ETIQUETTE_##operation:
+#define SUIVANTE       goto *etiquettes[code[pc++]]
+#define DEBUT          SUIVANTE;
+#define FIN_BOUCLE
+#else
+#define CAS(operation) case Bytecode::operation:
+#define SUIVANTE       continue
+#define DEBUT          for (;;) switch (code[pc++]) {
+#define FIN_BOUCLE     }
+#endif
+
+#define BINAIRE(operation, expression) CAS(operation) { int d = *sommet--; int g = *sommet; *sommet = (expression); } SUIVANTE;
+
+void MachineVirtuelle::executer() {
+  const int* code = m_bytecode.getCode();
+  const string* chaines = m_bytecode.getChaines().data();
+  Emplacement* emplacements = m_emplacements.data();
+  int* sommet = m_pile.data(); // m_pile[0] n'est jamais utilisé : la pile vide a son sommet sur lui
+  unsigned int pc = 0;
+#ifdef MV_GOTO_CALCULE
+  static void* const etiquettes[Bytecode::NB_OPERATIONS] = { // dans l'ordre de Bytecode::Operation
+    &&ETIQUETTE_CHARGER, &&ETIQUETTE_CHARGER_SUR, &&ETIQUETTE_EMPILER, &&ETIQUETTE_RANGER,
+    &&ETIQUETTE_ADDITION, &&ETIQUETTE_SOUSTRACTION, &&ETIQUETTE_MULTIPLICATION, &&ETIQUETTE_DIVISION,
+    &&ETIQUETTE_DIVISION_SURE,
+    &&ETIQUETTE_EGAL, &&ETIQUETTE_DIFFERENT, &&ETIQUETTE_INFERIEUR, &&ETIQUETTE_INFERIEUREGAL,
+    &&ETIQUETTE_SUPERIEUR, &&ETIQUETTE_SUPERIEUREGAL,
+    &&ETIQUETTE_OPPOSE, &&ETIQUETTE_NEGATION, &&ETIQUETTE_BOOLEEN,
+    &&ETIQUETTE_SAUTER, &&ETIQUETTE_SAUTER_SI_FAUX, &&ETIQUETTE_SAUTER_SI_VRAI,
+    &&ETIQUETTE_ET_ALORS, &&ETIQUETTE_OU_SINON, &&ETIQUETTE_AIGUILLER,
+    &&ETIQUETTE_ECRIRE_VALEUR, &&ETIQUETTE_ECRIRE_CHAINE, &&ETIQUETTE_LIRE,
+    &&ETIQUETTE_TESTER, &&ETIQUETTE_OUBLIER, &&ETIQUETTE_FIN
+  };
+#endif
+  DEBUT
+    CAS(CHARGER) {
+      const Emplacement & e = emplacements[code[pc++]];
+      if (!e.defini) throw IndefiniException();
+      *++sommet = e.valeur;
+    } SUIVANTE;
+    CAS(CHARGER_SUR) *++sommet = emplacements[code[pc++]].valeur; SUIVANTE;
+    CAS(EMPILER) *++sommet = code[pc++]; SUIVANTE;
+    CAS(RANGER) emplacements[code[pc++]] = Emplacement{*sommet--, true}; SUIVANTE;
+    BINAIRE(ADDITION, g + d)
+    BINAIRE(SOUSTRACTION, g - d)
+    BINAIRE(MULTIPLICATION, g * d)
+    CAS(DIVISION) {
+      int d = *sommet--;
+      if (d == 0) throw DivParZeroException();
+      *sommet = *sommet / d;
+    } SUIVANTE;
+    BINAIRE(DIVISION_SURE, g / d)
+    BINAIRE(EGAL, g == d)
+    BINAIRE(DIFFERENT, g != d)
+    BINAIRE(INFERIEUR, g < d)
+    BINAIRE(INFERIEUREGAL, g <= d)
+    BINAIRE(SUPERIEUR, g > d)
+    BINAIRE(SUPERIEUREGAL, g >= d)
+    CAS(OPPOSE) *sommet = -*sommet; SUIVANTE;
+    CAS(NEGATION) *sommet = !*sommet; SUIVANTE;
+    CAS(BOOLEEN) *sommet = *sommet != 0; SUIVANTE;
+    CAS(SAUTER) pc = code[pc]; SUIVANTE;
+    CAS(SAUTER_SI_FAUX) pc = *sommet-- ? pc + 1 : code[pc]; SUIVANTE;
+    CAS(SAUTER_SI_VRAI) pc = *sommet-- ? code[pc] : pc + 1; SUIVANTE;
+    CAS(ET_ALORS) {
+      if (*sommet == 0) pc = code[pc];
+      else {
+        sommet--;
+        pc++;
+      }
+    } SUIVANTE;
+    CAS(OU_SINON) {
+      if (*sommet != 0) {
+        *sommet = 1;
+        pc = code[pc];
+      } else {
+        sommet--;
+        pc++;
+      }
+    } SUIVANTE;
+    CAS(AIGUILLER) { // code[pc] : minimum, code[pc + 1] : nombre, puis les cibles et celle du sinon
+      unsigned int rang = (unsigned int) *sommet-- - (unsigned int) code[pc];
+      unsigned int nombre = code[pc + 1];
+      pc = code[pc + 2 + (rang < nombre ? rang : nombre)];
+    } SUIVANTE;
+    CAS(ECRIRE_VALEUR) Sortie::ecrire(*sommet--); SUIVANTE;
+    CAS(ECRIRE_CHAINE) Sortie::ecrire(chaines[code[pc++]]); SUIVANTE;
+    CAS(LIRE) emplacements[code[pc++]] = Emplacement{Entree::lire(), true}; SUIVANTE;
+    CAS(TESTER) *++sommet = emplacements[code[pc++]].defini; SUIVANTE;
+    CAS(OUBLIER) emplacements[code[pc++]].defini = false; SUIVANTE;
+    CAS(FIN) return;
+  FIN_BOUCLE
+}
@@ -0,0 +1,26 @@
+#ifndef MACHINEVIRTUELLE_H
+#define MACHINEVIRTUELLE_H
+
+// Machine virtuelle : exécute le bytecode d'un programme (voir Bytecode.h) sur une pile de valeurs.
+// Avec gcc/clang, chaque instruction saute directement à la suivante par un goto calculé
+// (l'adresse du traitement de chaque code est dans un tableau) ; ailleurs, par un switch.
+
+#include <vector>
+using namespace std;
+
+#include "Bytecode.h"
+#include "SymboleValue.h"
+
+class MachineVirtuelle {
+public:
+    MachineVirtuelle(const Bytecode & bytecode, vector<Emplacement> & emplacements);
+    // Construit une machine qui exécute bytecode, avec les valeurs des variables dans emplacements
+    void executer(); // Exécute le programme, lève les mêmes exceptions que l'arbre abstrait
+
+private:
+    const Bytecode &      m_bytecode;
+    vector<Emplacement> & m_emplacements;
+    vector<int>           m_pile;
+};
+
+#endif /* MACHINEVIRTUELLE_H */
@@ -0,0 +1,912 @@
+#include "Optimiseur.h"
+#include "SymboleValue.h"
+#include <climits>
+
+const unsigned int Optimiseur::TOURS_MAX_DEROULES = 8;
+const unsigned int Optimiseur::NOEUDS_MAX_DEROULES = 256;
+const unsigned int Optimiseur::NOEUDS_MIN_INVARIANT = 3;
+
+Optimiseur::Optimiseur(Arene & arene, TableSymboles & table, TableExpressions & expressions)
+: m_arene(arene), m_table(table), m_expressions(expressions), m_temporairesInstruction(),
+  m_oublisInstruction() {
+}
+
+bool Optimiseur::estConstante(const Noeud* noeud, int & valeur) {
+  if (noeud->getGenre() == N_CONSTANTE) {
+    valeur = ((const NoeudConstante*) noeud)->getValeur();
+    return true;
+  }
+  if (noeud->getGenre() == N_SYMBOLEVALUE && *((const SymboleValue*) noeud) == "<ENTIER>") {
+    valeur = ((const SymboleValue*) noeud)->getValeur();
+    return true;
+  }
+  return false;
+}
+
+bool Optimiseur::calculer(Jeton operateur, int g, int d, int & valeur) {
+  switch (operateur) {
+    case J_PLUS:           valeur = Addition::calculer(g, d); return true;
+    case J_MOINS:          valeur = Soustraction::calculer(g, d); return true;
+    case J_MULTIPLICATION: valeur = Multiplication::calculer(g, d); return true;
+    case J_DIVISION:
+      if (d == 0) return false; // la division doit lever son exception à l'exécution
+      if (g == INT_MIN && d == -1) return false; // déborde : calculée (ou pas) à l'exécution seulement, comme sans optimiseur
+      valeur = Division::calculer(g, d);
+      return true;
+    case J_EGAL:           valeur = Egal::calculer(g, d); return true;
+    case J_DIFFERENT:      valeur = Different::calculer(g, d); return true;
+    case J_INFERIEUR:      valeur = Inferieur::calculer(g, d); return true;
+    case J_INFERIEUREGAL:  valeur = InferieurEgal::calculer(g, d); return true;
+    case J_SUPERIEUR:      valeur = Superieur::calculer(g, d); return true;
+    case J_SUPERIEUREGAL:  valeur = SuperieurEgal::calculer(g, d); return true;
+    case J_ET:             valeur = Et::calculer(g, d); return true;
+    case J_OU:             valeur = Ou::calculer(g, d); return true;
+    default:               return false;
+  }
+}
+
+bool Optimiseur::egales(const Noeud* a, const Noeud* b) {
+  int va, vb;
+  if (estConstante(a, va)) return estConstante(b, vb) && va == vb;
+  if (a->getGenre() != b->getGenre()) return false;
+  switch (a->getGenre()) {
+    case N_SYMBOLEVALUE:
+      return a == b; // une variable n'est rangée qu'une fois dans la table
+    case N_OPERATEURBINAIRE: {
+      const NoeudOperateurBinaire* oa = (const NoeudOperateurBinaire*) a;
+      const NoeudOperateurBinaire* ob = (const NoeudOperateurBinaire*) b;
+      return oa->getOperateur() == ob->getOperateur() && egales(oa->getOperandeGauche(), ob->getOperandeGauche())
+              && egales(oa->getOperandeDroit(), ob->getOperandeDroit());
+    }
+    case N_OPERATEURUNAIRE: {
+      const NoeudOperateurUnaire* oa = (const NoeudOperateurUnaire*) a;
+      const NoeudOperateurUnaire* ob = (const NoeudOperateurUnaire*) b;
+      return oa->getOperateur() == ob->getOperateur() && egales(oa->getOperande(), ob->getOperande());
+    }
+    default:
+      return false;
+  }
+}
+
+unsigned int Optimiseur::taille(const Noeud* noeud) {
+  if (noeud == nullptr) return 0;
+  unsigned int resultat = 1;
+  switch (noeud->getGenre()) {
+    case N_SEQINST:
+      for (Noeud* instruction : ((const NoeudSeqInst*) noeud)->getInstructions()) resultat += taille(instruction);
+      break;
+    case N_AFFECTATION:
+      return 1 + taille(((const NoeudAffectation*) noeud)->getExpression());
+    case N_OPERATEURBINAIRE:
+      return 1 + taille(((const NoeudOperateurBinaire*) noeud)->getOperandeGauche())
+              + taille(((const NoeudOperateurBinaire*) noeud)->getOperandeDroit());
+    case N_OPERATEURUNAIRE:
+      return 1 + taille(((const NoeudOperateurUnaire*) noeud)->getOperande());
+    case N_INVARIANT:
+      return 1 + taille(((const NoeudInvariant*) noeud)->getExpression());
+    case N_SI:
+      return 1 + taille(((const NoeudInstSi*) noeud)->getCondition()) + taille(((const NoeudInstSi*) noeud)->getSequence());
+    case N_SIRICHE:
+      for (Noeud* condition : ((const NoeudInstSiRiche*) noeud)->getConditions()) resultat += taille(condition);
+      for (Noeud* sequence : ((const NoeudInstSiRiche*) noeud)->getSequences()) resultat += taille(sequence);
+      break;
+    case N_TANTQUE:
+      return 1 + taille(((const NoeudInstTantQue*) noeud)->getCondition())
+              + taille(((const NoeudInstTantQue*) noeud)->getSequence());
+    case N_REPETER:
+      return 1 + taille(((const NoeudInstRepeter*) noeud)->getCondition())
+              + taille(((const NoeudInstRepeter*) noeud)->getSequence());
+    case N_POUR: {
+      const NoeudInstPour* pour = (const NoeudInstPour*) noeud;
+      return 1 + taille(pour->getAffectation1()) + taille(pour->getCondition()) + taille(pour->getSequence())
+              + taille(pour->getAffectation2());
+    }
+    case N_AIGUILLAGE:
+      for (Noeud* sequence : ((const NoeudInstAiguillage*) noeud)->getSequences()) resultat += taille(sequence);
+      return resultat + taille(((const NoeudInstAiguillage*) noeud)->getSinon());
+    case N_LIRE:
+      return 1 + ((const NoeudInstLire*) noeud)->getVariables().size();
+    case N_ECRIRE:
+      for (Noeud* parametre : ((const NoeudInstEcrire*) noeud)->getParametres()) resultat += taille(parametre);
+      break;
+    default: // feuilles
+      break;
+  }
+  return resultat;
+}
+
+void Optimiseur::variablesEcrites(const Noeud* instruction, set<const Noeud*> & variables) {
+  if (instruction == nullptr) return;
+  switch (instruction->getGenre()) {
+    case N_SEQINST:
+      for (Noeud* i : ((const NoeudSeqInst*) instruction)->getInstructions()) variablesEcrites(i, variables);
+      return;
+    case N_AFFECTATION:
+      variables.insert(((const NoeudAffectation*) instruction)->getVariable());
+      return;
+    case N_SI:
+      variablesEcrites(((const NoeudInstSi*) instruction)->getSequence(), variables);
+      return;
+    case N_SIRICHE:
+      for (Noeud* sequence : ((const NoeudInstSiRiche*) instruction)->getSequences()) variablesEcrites(sequence, variables);
+      return;
+    case N_AIGUILLAGE:
+      for (Noeud* sequence : ((const NoeudInstAiguillage*) instruction)->getSequences()) variablesEcrites(sequence, variables);
+      variablesEcrites(((const NoeudInstAiguillage*) instruction)->getSinon(), variables);
+      return;
+    case N_TANTQUE:
+      variablesEcrites(((const NoeudInstTantQue*) instruction)->getSequence(), variables);
+      return;
+    case N_REPETER:
+      variablesEcrites(((const NoeudInstRepeter*) instruction)->getSequence(), variables);
+      return;
+    case N_POUR:
+      variablesEcrites(((const NoeudInstPour*) instruction)->getAffectation1(), variables);
+      variablesEcrites(((const NoeudInstPour*) instruction)->getSequence(), variables);
+      variablesEcrites(((const NoeudInstPour*) instruction)->getAffectation2(), variables);
+      return;
+    case N_LIRE: // lire désigne des variables à modifier
+      for (Noeud* variable : ((const NoeudInstLire*) instruction)->getVariables()) variables.insert(variable);
+      return;
+    default: // ecrire, et les expressions, ne modifient rien
+      return;
+  }
+}
+
+Noeud* Optimiseur::optimiserOperation(NoeudOperateurBinaire* operation) {
+  Noeud* g = optimiser(operation->getOperandeGauche());
+  Noeud* d = optimiser(operation->getOperandeDroit());
+  Jeton operateur = operation->getOperateur();
+  int vg, vd, valeur;
+  bool cg = estConstante(g, vg), cd = estConstante(d, vd);
+  if (cg && cd && calculer(operateur, vg, vd, valeur)) return m_expressions.constante(valeur);
+  // et/ou dont l'opérande gauche suffit : l'opérande droit ne serait pas évalué
+  if (operateur == J_ET && cg && vg == 0) return m_expressions.constante(0);
+  if (operateur == J_OU && cg && vg != 0) return m_expressions.constante(1);
+  // identités : l'opérande restant est toujours évalué, il lève donc les mêmes exceptions
+  if (operateur == J_MULTIPLICATION && cd && vd == 1) return g;
+  if (operateur == J_MULTIPLICATION && cg && vg == 1) return d;
+  if (operateur == J_DIVISION && cd && vd == 1) return g;
+  if (operateur == J_PLUS && cd && vd == 0) return g;
+  if (operateur == J_PLUS && cg && vg == 0) return d;
+  if (operateur == J_MOINS && cd && vd == 0) return g;
+  if (operateur == J_MOINS && egales(g, d)) // e-e : e est évalué une fois, puis multiplié par 0
+    return m_expressions.operation(J_MULTIPLICATION, g, m_expressions.constante(0));
+  if (g == operation->getOperandeGauche() && d == operation->getOperandeDroit()) return operation;
+  return m_expressions.operation(operateur, g, d);
+}
+
+Noeud* Optimiseur::optimiserSiRiche(NoeudInstSiRiche* siRiche) {
+  vector<Noeud*> conditions, sequences;
+  for (unsigned int i = 0; i < siRiche->getConditions().size(); i++) {
+    Noeud* condition = siRiche->getConditions()[i];
+    int valeur;
+    if (condition != nullptr) {
+      condition = optimiser(condition);
+      if (estConstante(condition, valeur)) {
+        if (!valeur) continue;  // branche jamais prise
+        condition = nullptr;    // branche toujours prise (si on arrive jusqu'à elle) : c'est un sinon
+      }
+    }
+    conditions.push_back(condition);
+    sequences.push_back(optimiser(siRiche->getSequences()[i]));
+    if (condition == nullptr) break; // les branches suivantes ne sont jamais prises
+  }
+  if (conditions.empty()) return nullptr;
+  if (conditions[0] == nullptr) return sequences[0];
+  return m_arene.creer<NoeudInstSiRiche>(conditions, sequences);
+}
+
+Noeud* Optimiseur::optimiserAiguillage(NoeudInstAiguillage* aiguillage) {
+  vector<Noeud*> sequences;
+  bool inchange = true;
+  for (unsigned int i = 0; i < aiguillage->getSequences().size(); i++) {
+    Noeud* sequence = optimiser(aiguillage->getSequences()[i]);
+    if (sequence == nullptr) sequence = m_arene.creer<NoeudSeqInst>(); // chaque valeur garde sa séquence
+    sequences.push_back(sequence);
+    inchange = inchange && sequence == aiguillage->getSequences()[i];
+  }
+  Noeud* sinon = aiguillage->getSinon() == nullptr ? nullptr : optimiser(aiguillage->getSinon());
+  if (inchange && sinon == aiguillage->getSinon()) return aiguillage;
+  return m_arene.creer<NoeudInstAiguillage>(aiguillage->getVariable(), aiguillage->getValeurs(), sequences, sinon);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Boucles comptées
+////////////////////////////////////////////////////////////////////////////////
+
+// Nombre de tours d'une boucle dont le compteur va de debut, par pas, tant que compteur comparaison limite :
+// faux si la boucle ne s'arrête pas avant que le compteur sorte des entiers (ou jamais)
+static bool compterTours(Jeton comparaison, long long debut, long long limite, long long pas, long long & tours) {
+  int vrai;
+  Optimiseur::calculer(comparaison, debut, limite, vrai);
+  if (!vrai) tours = 0;
+  else switch (comparaison) {
+    case J_INFERIEUR:
+      if (pas < 0) return false;
+      tours = (limite - debut + pas - 1) / pas;
+      break;
+    case J_INFERIEUREGAL:
+      if (pas < 0) return false;
+      tours = (limite - debut) / pas + 1;
+      break;
+    case J_SUPERIEUR:
+      if (pas > 0) return false;
+      tours = (debut - limite - pas - 1) / -pas;
+      break;
+    case J_SUPERIEUREGAL:
+      if (pas > 0) return false;
+      tours = (debut - limite) / -pas + 1;
+      break;
+    case J_DIFFERENT:
+      if ((limite - debut) % pas != 0 || (limite - debut) / pas < 0) return false;
+      tours = (limite - debut) / pas;
+      break;
+    case J_EGAL: // dès le premier pas, le compteur n'est plus égal
+      tours = 1;
+      break;
+    default: // et, ou
+      return false;
+  }
+  long long fin = debut + tours * pas;
+  return fin >= INT_MIN && fin <= INT_MAX;
+}
+
+// Comparaison symétrique : a comparaison b équivaut à b symetrique(comparaison) a
+static Jeton symetrique(Jeton comparaison) {
+  switch (comparaison) {
+    case J_INFERIEUR:     return J_SUPERIEUR;
+    case J_INFERIEUREGAL: return J_SUPERIEUREGAL;
+    case J_SUPERIEUR:     return J_INFERIEUR;
+    case J_SUPERIEUREGAL: return J_INFERIEUREGAL;
+    default:              return comparaison;
+  }
+}
+
+// Les instructions de la séquence sequence (ou sequence elle-même si ce n'en est pas une)
+static vector<Noeud*> instructionsDe(Noeud* sequence) {
+  if (sequence->getGenre() == N_SEQINST) return ((NoeudSeqInst*) sequence)->getInstructions();
+  return vector<Noeud*>(1, sequence);
+}
+
+Noeud* Optimiseur::affectationConstante(Noeud* variable, int valeur) {
+  return m_arene.creer<NoeudAffectation>(variable, m_expressions.constante(valeur));
+}
+
+Noeud* Optimiseur::optimiserBoucleComptee(Noeud* initialisation, Noeud* condition, const vector<Noeud*> & corps,
+                                          Noeud* increment) {
+  // le compteur et ses bornes
+  if (initialisation->getGenre() != N_AFFECTATION || increment->getGenre() != N_AFFECTATION
+      || condition->getGenre() != N_OPERATEURBINAIRE) return nullptr;
+  Noeud* compteur = ((NoeudAffectation*) initialisation)->getVariable();
+  int debut, limite, valeur;
+  if (!estConstante(((NoeudAffectation*) initialisation)->getExpression(), debut)) return nullptr;
+  const NoeudOperateurBinaire* test = (const NoeudOperateurBinaire*) condition;
+  Jeton comparaison = test->getOperateur();
+  if (test->getOperandeGauche() == compteur && estConstante(test->getOperandeDroit(), limite)) ;
+  else if (test->getOperandeDroit() == compteur && estConstante(test->getOperandeGauche(), limite))
+    comparaison = symetrique(comparaison);
+  else return nullptr;
+  if (((NoeudAffectation*) increment)->getVariable() != compteur
+      || ((NoeudAffectation*) increment)->getExpression()->getGenre() != N_OPERATEURBINAIRE) return nullptr;
+  const NoeudOperateurBinaire* pas = (const NoeudOperateurBinaire*) ((NoeudAffectation*) increment)->getExpression();
+  long long valeurPas;
+  if (pas->getOperateur() == J_PLUS && pas->getOperandeGauche() == compteur && estConstante(pas->getOperandeDroit(), valeur))
+    valeurPas = valeur;
+  else if (pas->getOperateur() == J_PLUS && pas->getOperandeDroit() == compteur && estConstante(pas->getOperandeGauche(), valeur))
+    valeurPas = valeur;
+  else if (pas->getOperateur() == J_MOINS && pas->getOperandeGauche() == compteur && estConstante(pas->getOperandeDroit(), valeur))
+    valeurPas = -(long long) valeur;
+  else return nullptr;
+  set<const Noeud*> ecrites;
+  for (Noeud* instruction : corps) variablesEcrites(instruction, ecrites);
+  long long tours;
+  if (valeurPas == 0 || ecrites.count(compteur) || !compterTours(comparaison, debut, limite, valeurPas, tours))
+    return nullptr;
+  int fin = (int) (debut + tours * valeurPas);
+  NoeudSeqInst* resultat = m_arene.creer<NoeudSeqInst>();
+  if (tours == 0) { // seule l'initialisation est exécutée
+    resultat->ajoute(initialisation);
+    return resultat;
+  }
+
+  // forme close : chaque tour ajoute la même chose aux accumulateurs x = x + t / x = x - t, où t est une
+  // constante, le compteur, ou une variable que le corps ne modifie pas ; x = constante ne dépend pas du tour
+  set<const Noeud*> accumulees, constantes;
+  bool close = true;
+  for (unsigned int i = 0; i < corps.size() && close; i++) {
+    close = corps[i]->getGenre() == N_AFFECTATION;
+    if (!close) break;
+    Noeud* x = ((NoeudAffectation*) corps[i])->getVariable();
+    Noeud* e = ((NoeudAffectation*) corps[i])->getExpression();
+    if (estConstante(e, valeur)) {
+      constantes.insert(x);
+      continue;
+    }
+    close = e->getGenre() == N_OPERATEURBINAIRE;
+    if (!close) break;
+    const NoeudOperateurBinaire* operation = (const NoeudOperateurBinaire*) e;
+    const Noeud* t = operation->getOperandeGauche() == x ? operation->getOperandeDroit()
+            : operation->getOperateur() == J_PLUS && operation->getOperandeDroit() == x ? operation->getOperandeGauche()
+            : nullptr;
+    close = (operation->getOperateur() == J_PLUS || operation->getOperateur() == J_MOINS) && t != nullptr && t != x
+            && (estConstante(t, valeur) || t == compteur || (t->getGenre() == N_SYMBOLEVALUE && !ecrites.count(t)));
+    accumulees.insert(x);
+  }
+  for (const Noeud* x : accumulees) close = close && !constantes.count(x);
+  if (close) {
+    unsigned long long n = tours; // les sommes se calculent modulo 2^32, comme les additions successives
+    for (Noeud* instruction : corps) {
+      Noeud* x = ((NoeudAffectation*) instruction)->getVariable();
+      Noeud* e = ((NoeudAffectation*) instruction)->getExpression();
+      if (estConstante(e, valeur)) {
+        resultat->ajoute(instruction);
+        continue;
+      }
+      const NoeudOperateurBinaire* operation = (const NoeudOperateurBinaire*) e;
+      Noeud* t = operation->getOperandeGauche() == x ? operation->getOperandeDroit() : operation->getOperandeGauche();
+      Noeud* total;
+      if (estConstante(t, valeur)) total = m_expressions.constante((int) (unsigned int) (n * (unsigned int) valeur));
+      else if (t == compteur) // debut + (debut + pas) + ... + (debut + (n - 1) pas)
+        total = m_expressions.constante((int) (unsigned int) (n * (unsigned long long) debut
+                                                              + (unsigned long long) valeurPas * (n * (n - 1) / 2)));
+      else total = m_expressions.operation(J_MULTIPLICATION, t, m_expressions.constante((int) (unsigned int) n));
+      resultat->ajoute(m_arene.creer<NoeudAffectation>(x, m_expressions.operation(operation->getOperateur(), x, total)));
+    }
+    resultat->ajoute(affectationConstante(compteur, fin));
+    return resultat;
+  }
+
+  // déroulement : le compteur reçoit sa valeur avant chaque tour
+  unsigned int noeuds = 0;
+  for (Noeud* instruction : corps) noeuds += taille(instruction);
+  if (tours > TOURS_MAX_DEROULES || tours * (noeuds + 3) > NOEUDS_MAX_DEROULES) return nullptr;
+  for (long long i = 0; i < tours; i++) {
+    resultat->ajoute(affectationConstante(compteur, (int) (debut + i * valeurPas)));
+    for (Noeud* instruction : corps) resultat->ajoute(instruction);
+  }
+  resultat->ajoute(affectationConstante(compteur, fin));
+  return resultat;
+}
+
+Noeud* Optimiseur::optimiserBoucleApres(Noeud* initialisation, Noeud* boucle) {
+  if (boucle->getGenre() == N_TANTQUE) { // tantque (condition) corps ; increment fintantque
+    NoeudInstTantQue* tantQue = (NoeudInstTantQue*) boucle;
+    vector<Noeud*> corps = instructionsDe(tantQue->getSequence());
+    if (corps.empty()) return nullptr;
+    Noeud* increment = corps.back();
+    corps.pop_back();
+    return optimiserBoucleComptee(initialisation, tantQue->getCondition(), corps, increment);
+  }
+  if (boucle->getGenre() == N_POUR && ((NoeudInstPour*) boucle)->getAffectation1() == nullptr
+      && ((NoeudInstPour*) boucle)->getAffectation2() != nullptr) {
+    NoeudInstPour* pour = (NoeudInstPour*) boucle;
+    return optimiserBoucleComptee(initialisation, pour->getCondition(), instructionsDe(pour->getSequence()),
+                                  pour->getAffectation2());
+  }
+  return nullptr;
+}
+
+Noeud* Optimiseur::optimiser(Noeud* noeud) {
+  int valeur;
+  switch (noeud->getGenre()) {
+    case N_SEQINST: {
+      const vector<Noeud*> & instructions = ((NoeudSeqInst*) noeud)->getInstructions();
+      vector<Noeud*> optimisees;
+      bool inchangee = true;
+      for (unsigned int i = 0; i < instructions.size(); i++) {
+        Noeud* instruction = optimiser(instructions[i]);
+        inchangee = inchangee && instruction == instructions[i];
+        if (instruction == nullptr) continue;
+        // une boucle qui suit l'initialisation de son compteur est peut-être une boucle comptée
+        Noeud* boucle = optimisees.empty() ? nullptr : optimiserBoucleApres(optimisees.back(), instruction);
+        if (boucle != nullptr) {
+          optimisees.pop_back();
+          instruction = boucle;
+          inchangee = false;
+        }
+        if (instruction->getGenre() == N_SEQINST) { // séquence produite par l'optimisation : mise à plat
+          const vector<Noeud*> & sousInstructions = ((NoeudSeqInst*) instruction)->getInstructions();
+          optimisees.insert(optimisees.end(), sousInstructions.begin(), sousInstructions.end());
+        } else optimisees.push_back(instruction);
+      }
+      if (inchangee) return noeud;
+      NoeudSeqInst* sequence = m_arene.creer<NoeudSeqInst>();
+      for (unsigned int i = 0; i < optimisees.size(); i++) sequence->ajoute(optimisees[i]);
+      return sequence;
+    }
+    case N_AFFECTATION: {
+      NoeudAffectation* affectation = (NoeudAffectation*) noeud;
+      Noeud* expression = optimiser(affectation->getExpression());
+      if (expression == affectation->getExpression()) return noeud;
+      return m_arene.creer<NoeudAffectation>(affectation->getVariable(), expression);
+    }
+    case N_OPERATEURBINAIRE:
+      return optimiserOperation((NoeudOperateurBinaire*) noeud);
+    case N_OPERATEURUNAIRE: {
+      NoeudOperateurUnaire* operation = (NoeudOperateurUnaire*) noeud;
+      Noeud* operande = optimiser(operation->getOperande());
+      if (estConstante(operande, valeur))
+        return m_expressions.constante(operation->getOperateur() == J_MOINS ? Oppose::calculer(valeur)
+                                                                            : Negation::calculer(valeur));
+      if (operande == operation->getOperande()) return noeud;
+      return m_expressions.operation(operation->getOperateur(), operande);
+    }
+    case N_SI: {
+      NoeudInstSi* si = (NoeudInstSi*) noeud;
+      Noeud* condition = optimiser(si->getCondition());
+      Noeud* sequence = optimiser(si->getSequence());
+      if (estConstante(condition, valeur)) return valeur ? sequence : nullptr;
+      if (condition == si->getCondition() && sequence == si->getSequence()) return noeud;
+      return m_arene.creer<NoeudInstSi>(condition, sequence);
+    }
+    case N_SIRICHE:
+      return optimiserSiRiche((NoeudInstSiRiche*) noeud);
+    case N_AIGUILLAGE:
+      return optimiserAiguillage((NoeudInstAiguillage*) noeud);
+    case N_TANTQUE: {
+      NoeudInstTantQue* tantQue = (NoeudInstTantQue*) noeud;
+      Noeud* condition = optimiser(tantQue->getCondition());
+      if (estConstante(condition, valeur) && !valeur) return nullptr; // jamais exécutée
+      Noeud* sequence = optimiser(tantQue->getSequence());
+      if (condition == tantQue->getCondition() && sequence == tantQue->getSequence()) return noeud;
+      return m_arene.creer<NoeudInstTantQue>(condition, sequence);
+    }
+    case N_REPETER: {
+      NoeudInstRepeter* repeter = (NoeudInstRepeter*) noeud;
+      Noeud* condition = optimiser(repeter->getCondition());
+      if (estConstante(condition, valeur) && valeur) return nullptr; // la condition est testée avant la séquence
+      Noeud* sequence = optimiser(repeter->getSequence());
+      if (condition == repeter->getCondition() && sequence == repeter->getSequence()) return noeud;
+      return m_arene.creer<NoeudInstRepeter>(sequence, condition);
+    }
+    case N_POUR: {
+      NoeudInstPour* pour = (NoeudInstPour*) noeud;
+      Noeud* affectation1 = pour->getAffectation1() == nullptr ? nullptr : optimiser(pour->getAffectation1());
+      Noeud* condition = optimiser(pour->getCondition());
+      if (estConstante(condition, valeur) && !valeur) return affectation1; // seule l'initialisation est exécutée
+      Noeud* affectation2 = pour->getAffectation2() == nullptr ? nullptr : optimiser(pour->getAffectation2());
+      Noeud* sequence = optimiser(pour->getSequence());
+      if (affectation1 != nullptr && affectation2 != nullptr) {
+        Noeud* boucle = optimiserBoucleComptee(affectation1, condition, instructionsDe(sequence), affectation2);
+        if (boucle != nullptr) return boucle;
+      }
+      if (affectation1 == pour->getAffectation1() && condition == pour->getCondition()
+          && affectation2 == pour->getAffectation2() && sequence == pour->getSequence()) return noeud;
+      return m_arene.creer<NoeudInstPour>(condition, sequence, affectation1, affectation2);
+    }
+    case N_ECRIRE: {
+      const vector<Noeud*> & parametres = ((NoeudInstEcrire*) noeud)->getParametres();
+      vector<Noeud*> optimises;
+      bool inchange = true;
+      for (unsigned int i = 0; i < parametres.size(); i++) {
+        optimises.push_back(optimiser(parametres[i]));
+        inchange = inchange && optimises[i] == parametres[i];
+      }
+      if (inchange) return noeud;
+      return m_arene.creer<NoeudInstEcrire>(optimises);
+    }
+    default: // feuilles (variables, entiers, chaînes) et lire : rien à optimiser
+      return noeud;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Invariants de boucle
+////////////////////////////////////////////////////////////////////////////////
+
+bool Optimiseur::estInvariante(const Noeud* expression, const set<const Noeud*> & ecrites) {
+  switch (expression->getGenre()) {
+    case N_SYMBOLEVALUE:
+      return !ecrites.count(expression);
+    case N_CONSTANTE:
+      return true;
+    case N_OPERATEURBINAIRE:
+      return estInvariante(((const NoeudOperateurBinaire*) expression)->getOperandeGauche(), ecrites)
+              && estInvariante(((const NoeudOperateurBinaire*) expression)->getOperandeDroit(), ecrites);
+    case N_OPERATEURUNAIRE:
+      return estInvariante(((const NoeudOperateurUnaire*) expression)->getOperande(), ecrites);
+    case N_INVARIANT: // invariant d'une boucle interne : sa valeur est celle de son expression
+      return estInvariante(((const NoeudInvariant*) expression)->getExpression(), ecrites);
+    default:
+      return false;
+  }
+}
+
+Noeud* Optimiseur::remplacerInvariants(Noeud* noeud, const set<const Noeud*> & ecrites, vector<Noeud*> & invariants) {
+  switch (noeud->getGenre()) {
+    case N_OPERATEURBINAIRE: case N_OPERATEURUNAIRE: case N_INVARIANT:
+      if (taille(noeud) >= NOEUDS_MIN_INVARIANT && estInvariante(noeud, ecrites)) {
+        for (Noeud* invariant : invariants) // la même expression ailleurs dans la boucle : même valeur
+          if (egales(((NoeudInvariant*) invariant)->getExpression(), noeud)) return invariant;
+        invariants.push_back(m_expressions.invariant(m_table.ajouteTemporaire(), noeud));
+        return invariants.back();
+      }
+      break;
+    default:
+      break;
+  }
+  switch (noeud->getGenre()) {
+    case N_OPERATEURBINAIRE: {
+      NoeudOperateurBinaire* operation = (NoeudOperateurBinaire*) noeud;
+      Noeud* g = remplacerInvariants(operation->getOperandeGauche(), ecrites, invariants);
+      Noeud* d = remplacerInvariants(operation->getOperandeDroit(), ecrites, invariants);
+      if (g == operation->getOperandeGauche() && d == operation->getOperandeDroit()) return noeud;
+      return m_expressions.operation(operation->getOperateur(), g, d);
+    }
+    case N_OPERATEURUNAIRE: {
+      NoeudOperateurUnaire* operation = (NoeudOperateurUnaire*) noeud;
+      Noeud* operande = remplacerInvariants(operation->getOperande(), ecrites, invariants);
+      if (operande == operation->getOperande()) return noeud;
+      return m_expressions.operation(operation->getOperateur(), operande);
+    }
+    case N_INVARIANT: {
+      NoeudInvariant* invariant = (NoeudInvariant*) noeud;
+      Noeud* expression = remplacerInvariants(invariant->getExpression(), ecrites, invariants);
+      if (expression == invariant->getExpression()) return noeud;
+      return m_expressions.invariant(invariant->getTemporaire(), expression);
+    }
+    case N_AFFECTATION: {
+      NoeudAffectation* affectation = (NoeudAffectation*) noeud;
+      Noeud* expression = remplacerInvariants(affectation->getExpression(), ecrites, invariants);
+      if (expression == affectation->getExpression()) return noeud;
+      return m_arene.creer<NoeudAffectation>(affectation->getVariable(), expression);
+    }
+    case N_SEQINST: {
+      const vector<Noeud*> & instructions = ((NoeudSeqInst*) noeud)->getInstructions();
+      vector<Noeud*> remplacees;
+      bool inchangee = true;
+      for (unsigned int i = 0; i < instructions.size(); i++) {
+        remplacees.push_back(remplacerInvariants(instructions[i], ecrites, invariants));
+        inchangee = inchangee && remplacees[i] == instructions[i];
+      }
+      if (inchangee) return noeud;
+      NoeudSeqInst* sequence = m_arene.creer<NoeudSeqInst>();
+      for (unsigned int i = 0; i < remplacees.size(); i++) sequence->ajoute(remplacees[i]);
+      return sequence;
+    }
+    case N_SI: {
+      NoeudInstSi* si = (NoeudInstSi*) noeud;
+      Noeud* condition = remplacerInvariants(si->getCondition(), ecrites, invariants);
+      Noeud* sequence = remplacerInvariants(si->getSequence(), ecrites, invariants);
+      if (condition == si->getCondition() && sequence == si->getSequence()) return noeud;
+      return m_arene.creer<NoeudInstSi>(condition, sequence);
+    }
+    case N_SIRICHE: {
+      NoeudInstSiRiche* siRiche = (NoeudInstSiRiche*) noeud;
+      vector<Noeud*> conditions, sequences;
+      bool inchange = true;
+      for (unsigned int i = 0; i < siRiche->getConditions().size(); i++) {
+        Noeud* condition = siRiche->getConditions()[i];
+        conditions.push_back(condition == nullptr ? nullptr : remplacerInvariants(condition, ecrites, invariants));
+        sequences.push_back(remplacerInvariants(siRiche->getSequences()[i], ecrites, invariants));
+        inchange = inchange && conditions[i] == condition && sequences[i] == siRiche->getSequences()[i];
+      }
+      if (inchange) return noeud;
+      return m_arene.creer<NoeudInstSiRiche>(conditions, sequences);
+    }
+    case N_AIGUILLAGE: {
+      NoeudInstAiguillage* aiguillage = (NoeudInstAiguillage*) noeud;
+      vector<Noeud*> sequences;
+      bool inchange = true;
+      for (unsigned int i = 0; i < aiguillage->getSequences().size(); i++) {
+        sequences.push_back(remplacerInvariants(aiguillage->getSequences()[i], ecrites, invariants));
+        inchange = inchange && sequences[i] == aiguillage->getSequences()[i];
+      }
+      Noeud* sinon = aiguillage->getSinon() == nullptr ? nullptr
+              : remplacerInvariants(aiguillage->getSinon(), ecrites, invariants);
+      if (inchange && sinon == aiguillage->getSinon()) return noeud;
+      return m_arene.creer<NoeudInstAiguillage>(aiguillage->getVariable(), aiguillage->getValeurs(), sequences, sinon);
+    }
+    case N_TANTQUE: {
+      NoeudInstTantQue* tantQue = (NoeudInstTantQue*) noeud;
+      Noeud* condition = remplacerInvariants(tantQue->getCondition(), ecrites, invariants);
+      Noeud* sequence = remplacerInvariants(tantQue->getSequence(), ecrites, invariants);
+      if (condition == tantQue->getCondition() && sequence == tantQue->getSequence()) return noeud;
+      return m_arene.creer<NoeudInstTantQue>(condition, sequence);
+    }
+    case N_REPETER: {
+      NoeudInstRepeter* repeter = (NoeudInstRepeter*) noeud;
+      Noeud* condition = remplacerInvariants(repeter->getCondition(), ecrites, invariants);
+      Noeud* sequence = remplacerInvariants(repeter->getSequence(), ecrites, invariants);
+      if (condition == repeter->getCondition() && sequence == repeter->getSequence()) return noeud;
+      return m_arene.creer<NoeudInstRepeter>(sequence, condition);
+    }
+    case N_POUR: {
+      NoeudInstPour* pour = (NoeudInstPour*) noeud;
+      Noeud* affectation1 = pour->getAffectation1() == nullptr ? nullptr
+              : remplacerInvariants(pour->getAffectation1(), ecrites, invariants);
+      Noeud* condition = remplacerInvariants(pour->getCondition(), ecrites, invariants);
+      Noeud* affectation2 = pour->getAffectation2() == nullptr ? nullptr
+              : remplacerInvariants(pour->getAffectation2(), ecrites, invariants);
+      Noeud* sequence = remplacerInvariants(pour->getSequence(), ecrites, invariants);
+      if (affectation1 == pour->getAffectation1() && condition == pour->getCondition()
+          && affectation2 == pour->getAffectation2() && sequence == pour->getSequence()) return noeud;
+      return m_arene.creer<NoeudInstPour>(condition, sequence, affectation1, affectation2);
+    }
+    case N_ECRIRE: {
+      const vector<Noeud*> & parametres = ((NoeudInstEcrire*) noeud)->getParametres();
+      vector<Noeud*> remplaces;
+      bool inchange = true;
+      for (unsigned int i = 0; i < parametres.size(); i++) {
+        remplaces.push_back(remplacerInvariants(parametres[i], ecrites, invariants));
+        inchange = inchange && remplaces[i] == parametres[i];
+      }
+      if (inchange) return noeud;
+      return m_arene.creer<NoeudInstEcrire>(remplaces);
+    }
+    default: // feuilles, lire, oublis des boucles internes
+      return noeud;
+  }
+}
+
+Noeud* Optimiseur::sortirInvariantsBoucle(Noeud* boucle) {
+  // la boucle répète sa séquence, sa condition et, pour un pour, sa seconde affectation (pas la première)
+  set<const Noeud*> ecrites;
+  Noeud* resultat = nullptr;
+  vector<Noeud*> invariants;
+  if (boucle->getGenre() == N_POUR) {
+    NoeudInstPour* pour = (NoeudInstPour*) boucle;
+    variablesEcrites(pour->getSequence(), ecrites);
+    variablesEcrites(pour->getAffectation2(), ecrites);
+    Noeud* condition = remplacerInvariants(pour->getCondition(), ecrites, invariants);
+    Noeud* sequence = remplacerInvariants(pour->getSequence(), ecrites, invariants);
+    Noeud* affectation2 = pour->getAffectation2() == nullptr ? nullptr
+            : remplacerInvariants(pour->getAffectation2(), ecrites, invariants);
+    resultat = m_arene.creer<NoeudInstPour>(condition, sequence, pour->getAffectation1(), affectation2);
+  } else if (boucle->getGenre() == N_TANTQUE) {
+    NoeudInstTantQue* tantQue = (NoeudInstTantQue*) boucle;
+    variablesEcrites(tantQue->getSequence(), ecrites);
+    Noeud* condition = remplacerInvariants(tantQue->getCondition(), ecrites, invariants);
+    resultat = m_arene.creer<NoeudInstTantQue>(condition, remplacerInvariants(tantQue->getSequence(), ecrites, invariants));
+  } else {
+    NoeudInstRepeter* repeter = (NoeudInstRepeter*) boucle;
+    variablesEcrites(repeter->getSequence(), ecrites);
+    Noeud* condition = remplacerInvariants(repeter->getCondition(), ecrites, invariants);
+    resultat = m_arene.creer<NoeudInstRepeter>(remplacerInvariants(repeter->getSequence(), ecrites, invariants), condition);
+  }
+  if (invariants.empty()) return boucle;
+  vector<Noeud*> temporaires;
+  for (Noeud* invariant : invariants) temporaires.push_back(((NoeudInvariant*) invariant)->getTemporaire());
+  NoeudSeqInst* sequence = m_arene.creer<NoeudSeqInst>();
+  sequence->ajoute(m_arene.creer<NoeudInstOublier>(temporaires));
+  sequence->ajoute(resultat);
+  return sequence;
+}
+
+Noeud* Optimiseur::sortirInvariants(Noeud* instruction) {
+  // les boucles internes d'abord : leurs invariants peuvent l'être aussi pour la boucle qui les contient
+  switch (instruction->getGenre()) {
+    case N_SEQINST: {
+      const vector<Noeud*> & instructions = ((NoeudSeqInst*) instruction)->getInstructions();
+      vector<Noeud*> remplacees;
+      bool inchangee = true;
+      for (unsigned int i = 0; i < instructions.size(); i++) {
+        Noeud* remplacee = sortirInvariants(instructions[i]);
+        inchangee = inchangee && remplacee == instructions[i];
+        if (remplacee != instructions[i] && remplacee->getGenre() == N_SEQINST) { // oubli puis boucle : mise à plat
+          const vector<Noeud*> & sousInstructions = ((NoeudSeqInst*) remplacee)->getInstructions();
+          remplacees.insert(remplacees.end(), sousInstructions.begin(), sousInstructions.end());
+        } else remplacees.push_back(remplacee);
+      }
+      if (inchangee) return instruction;
+      NoeudSeqInst* sequence = m_arene.creer<NoeudSeqInst>();
+      for (unsigned int i = 0; i < remplacees.size(); i++) sequence->ajoute(remplacees[i]);
+      return sequence;
+    }
+    case N_SI: {
+      NoeudInstSi* si = (NoeudInstSi*) instruction;
+      Noeud* sequence = sortirInvariants(si->getSequence());
+      if (sequence == si->getSequence()) return instruction;
+      return m_arene.creer<NoeudInstSi>(si->getCondition(), sequence);
+    }
+    case N_SIRICHE: {
+      NoeudInstSiRiche* siRiche = (NoeudInstSiRiche*) instruction;
+      vector<Noeud*> sequences;
+      bool inchange = true;
+      for (unsigned int i = 0; i < siRiche->getSequences().size(); i++) {
+        sequences.push_back(sortirInvariants(siRiche->getSequences()[i]));
+        inchange = inchange && sequences[i] == siRiche->getSequences()[i];
+      }
+      if (inchange) return instruction;
+      return m_arene.creer<NoeudInstSiRiche>(siRiche->getConditions(), sequences);
+    }
+    case N_AIGUILLAGE: {
+      NoeudInstAiguillage* aiguillage = (NoeudInstAiguillage*) instruction;
+      vector<Noeud*> sequences;
+      bool inchange = true;
+      for (unsigned int i = 0; i < aiguillage->getSequences().size(); i++) {
+        sequences.push_back(sortirInvariants(aiguillage->getSequences()[i]));
+        inchange = inchange && sequences[i] == aiguillage->getSequences()[i];
+      }
+      Noeud* sinon = aiguillage->getSinon() == nullptr ? nullptr : sortirInvariants(aiguillage->getSinon());
+      if (inchange && sinon == aiguillage->getSinon()) return instruction;
+      return m_arene.creer<NoeudInstAiguillage>(aiguillage->getVariable(), aiguillage->getValeurs(), sequences, sinon);
+    }
+    case N_TANTQUE: {
+      NoeudInstTantQue* tantQue = (NoeudInstTantQue*) instruction;
+      Noeud* sequence = sortirInvariants(tantQue->getSequence());
+      return sortirInvariantsBoucle(sequence == tantQue->getSequence() ? instruction
+                                    : m_arene.creer<NoeudInstTantQue>(tantQue->getCondition(), sequence));
+    }
+    case N_REPETER: {
+      NoeudInstRepeter* repeter = (NoeudInstRepeter*) instruction;
+      Noeud* sequence = sortirInvariants(repeter->getSequence());
+      return sortirInvariantsBoucle(sequence == repeter->getSequence() ? instruction
+                                    : m_arene.creer<NoeudInstRepeter>(sequence, repeter->getCondition()));
+    }
+    case N_POUR: {
+      NoeudInstPour* pour = (NoeudInstPour*) instruction;
+      Noeud* sequence = sortirInvariants(pour->getSequence());
+      return sortirInvariantsBoucle(sequence == pour->getSequence() ? instruction
+              : m_arene.creer<NoeudInstPour>(pour->getCondition(), sequence, pour->getAffectation1(), pour->getAffectation2()));
+    }
+    default:
+      return instruction;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Sous-expressions répétées dans une instruction
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int Optimiseur::SousExpressions::rang(const Noeud* noeud) const {
+  return index.chercher(TableExpressions::hacher(noeud->getGenre(), 0, noeud, nullptr),
+                        [&](unsigned int r) { return noeuds[r] == noeud; });
+}
+
+void Optimiseur::compterRepetees(const Noeud* expression, SousExpressions & vues) {
+  if (expression->getGenre() != N_OPERATEURBINAIRE && expression->getGenre() != N_OPERATEURUNAIRE)
+    return; // feuilles, chaînes, et invariants d'une boucle (déjà calculés une seule fois)
+  unsigned int rang = vues.rang(expression);
+  if (rang != IndexChaines::AUCUN) { // déjà vue : ses sous-expressions ont été comptées avec elle
+    if (!vues.repetees[rang] && taille(expression) >= NOEUDS_MIN_INVARIANT) {
+      vues.repetees[rang] = true;
+      vues.nombreRepetees++;
+    }
+    return;
+  }
+  vues.index.inserer(TableExpressions::hacher(expression->getGenre(), 0, expression, nullptr), vues.noeuds.size());
+  vues.noeuds.push_back(expression);
+  vues.repetees.push_back(false);
+  vues.invariants.push_back(nullptr);
+  if (expression->getGenre() == N_OPERATEURUNAIRE)
+    compterRepetees(((const NoeudOperateurUnaire*) expression)->getOperande(), vues);
+  else {
+    compterRepetees(((const NoeudOperateurBinaire*) expression)->getOperandeGauche(), vues);
+    compterRepetees(((const NoeudOperateurBinaire*) expression)->getOperandeDroit(), vues);
+  }
+}
+
+Noeud* Optimiseur::remplacerRepetees(Noeud* expression, SousExpressions & vues, vector<Noeud*> & temporaires) {
+  if (expression->getGenre() != N_OPERATEURBINAIRE && expression->getGenre() != N_OPERATEURUNAIRE) return expression;
+  unsigned int rang = vues.rang(expression);
+  if (vues.invariants[rang] != nullptr) return vues.invariants[rang];
+  Noeud* resultat = expression;
+  if (expression->getGenre() == N_OPERATEURBINAIRE) {
+    NoeudOperateurBinaire* operation = (NoeudOperateurBinaire*) expression;
+    Noeud* g = remplacerRepetees(operation->getOperandeGauche(), vues, temporaires);
+    Noeud* d = remplacerRepetees(operation->getOperandeDroit(), vues, temporaires);
+    if (g != operation->getOperandeGauche() || d != operation->getOperandeDroit())
+      resultat = m_expressions.operation(operation->getOperateur(), g, d);
+  } else {
+    NoeudOperateurUnaire* operation = (NoeudOperateurUnaire*) expression;
+    Noeud* operande = remplacerRepetees(operation->getOperande(), vues, temporaires);
+    if (operande != operation->getOperande()) resultat = m_expressions.operation(operation->getOperateur(), operande);
+  }
+  if (!vues.repetees[rang]) return resultat;
+  // calculée là où elle l'est d'abord : et/ou peuvent ne pas évaluer sa première occurrence. Ses temporaires ne
+  //  servent que pendant l'instruction : les instructions suivantes reprennent les mêmes
+  if (temporaires.size() == m_temporairesInstruction.size()) m_temporairesInstruction.push_back(m_table.ajouteTemporaire());
+  temporaires.push_back(m_temporairesInstruction[temporaires.size()]);
+  vues.invariants[rang] = m_expressions.invariant(temporaires.back(), resultat);
+  return vues.invariants[rang];
+}
+
+bool Optimiseur::numeroter(vector<Noeud*> & expressions, vector<Noeud*> & temporaires) {
+  SousExpressions vues;
+  vues.nombreRepetees = 0;
+  for (Noeud* expression : expressions)
+    if (expression != nullptr) compterRepetees(expression, vues);
+  if (vues.nombreRepetees == 0) return false;
+  for (unsigned int i = 0; i < expressions.size(); i++)
+    if (expressions[i] != nullptr) expressions[i] = remplacerRepetees(expressions[i], vues, temporaires);
+  return true;
+}
+
+Noeud* Optimiseur::numeroterValeurs(Noeud* instruction) {
+  vector<Noeud*> expressions, temporaires;
+  Noeud* resultat = instruction;
+  switch (instruction->getGenre()) {
+    case N_SEQINST: {
+      const vector<Noeud*> & instructions = ((NoeudSeqInst*) instruction)->getInstructions();
+      vector<Noeud*> remplacees;
+      bool inchangee = true;
+      for (unsigned int i = 0; i < instructions.size(); i++) {
+        Noeud* remplacee = numeroterValeurs(instructions[i]);
+        inchangee = inchangee && remplacee == instructions[i];
+        if (remplacee != instructions[i] && remplacee->getGenre() == N_SEQINST) { // oubli puis instruction : mise à plat
+          const vector<Noeud*> & sousInstructions = ((NoeudSeqInst*) remplacee)->getInstructions();
+          remplacees.insert(remplacees.end(), sousInstructions.begin(), sousInstructions.end());
+        } else remplacees.push_back(remplacee);
+      }
+      if (inchangee) return instruction;
+      NoeudSeqInst* sequence = m_arene.creer<NoeudSeqInst>();
+      for (unsigned int i = 0; i < remplacees.size(); i++) sequence->ajoute(remplacees[i]);
+      return sequence;
+    }
+    case N_AFFECTATION: {
+      NoeudAffectation* affectation = (NoeudAffectation*) instruction;
+      expressions.push_back(affectation->getExpression());
+      if (numeroter(expressions, temporaires))
+        resultat = m_arene.creer<NoeudAffectation>(affectation->getVariable(), expressions[0]);
+      break;
+    }
+    case N_ECRIRE: { // les chaînes ne sont pas des expressions : compterRepetees les ignore
+      expressions = ((NoeudInstEcrire*) instruction)->getParametres();
+      if (numeroter(expressions, temporaires)) resultat = m_arene.creer<NoeudInstEcrire>(expressions);
+      break;
+    }
+    case N_SI: {
+      NoeudInstSi* si = (NoeudInstSi*) instruction;
+      expressions.push_back(si->getCondition());
+      Noeud* sequence = numeroterValeurs(si->getSequence());
+      if (numeroter(expressions, temporaires) || sequence != si->getSequence())
+        resultat = m_arene.creer<NoeudInstSi>(expressions[0], sequence);
+      break;
+    }
+    case N_SIRICHE: { // les conditions sont évaluées l'une après l'autre, avant toute séquence
+      NoeudInstSiRiche* siRiche = (NoeudInstSiRiche*) instruction;
+      expressions = siRiche->getConditions();
+      vector<Noeud*> sequences;
+      bool inchange = !numeroter(expressions, temporaires);
+      for (unsigned int i = 0; i < siRiche->getSequences().size(); i++) {
+        sequences.push_back(numeroterValeurs(siRiche->getSequences()[i]));
+        inchange = inchange && sequences[i] == siRiche->getSequences()[i];
+      }
+      if (!inchange) resultat = m_arene.creer<NoeudInstSiRiche>(expressions, sequences);
+      break;
+    }
+    case N_AIGUILLAGE: {
+      NoeudInstAiguillage* aiguillage = (NoeudInstAiguillage*) instruction;
+      vector<Noeud*> sequences;
+      bool inchange = true;
+      for (unsigned int i = 0; i < aiguillage->getSequences().size(); i++) {
+        sequences.push_back(numeroterValeurs(aiguillage->getSequences()[i]));
+        inchange = inchange && sequences[i] == aiguillage->getSequences()[i];
+      }
+      Noeud* sinon = aiguillage->getSinon() == nullptr ? nullptr : numeroterValeurs(aiguillage->getSinon());
+      if (inchange && sinon == aiguillage->getSinon()) return instruction;
+      return m_arene.creer<NoeudInstAiguillage>(aiguillage->getVariable(), aiguillage->getValeurs(), sequences, sinon);
+    }
+    case N_TANTQUE: {
+      NoeudInstTantQue* tantQue = (NoeudInstTantQue*) instruction;
+      Noeud* sequence = numeroterValeurs(tantQue->getSequence());
+      if (sequence == tantQue->getSequence()) return instruction;
+      return m_arene.creer<NoeudInstTantQue>(tantQue->getCondition(), sequence);
+    }
+    case N_REPETER: {
+      NoeudInstRepeter* repeter = (NoeudInstRepeter*) instruction;
+      Noeud* sequence = numeroterValeurs(repeter->getSequence());
+      if (sequence == repeter->getSequence()) return instruction;
+      return m_arene.creer<NoeudInstRepeter>(sequence, repeter->getCondition());
+    }
+    case N_POUR: {
+      NoeudInstPour* pour = (NoeudInstPour*) instruction;
+      Noeud* sequence = numeroterValeurs(pour->getSequence());
+      if (sequence == pour->getSequence()) return instruction;
+      return m_arene.creer<NoeudInstPour>(pour->getCondition(), sequence, pour->getAffectation1(), pour->getAffectation2());
+    }
+    default: // lire, oublis
+      return instruction;
+  }
+  if (temporaires.empty()) return resultat;
+  // temporaires est toujours le début de m_temporairesInstruction : un seul oubli pour chaque nombre de temporaires
+  while (m_oublisInstruction.size() < temporaires.size()) m_oublisInstruction.push_back(nullptr);
+  if (m_oublisInstruction[temporaires.size() - 1] == nullptr)
+    m_oublisInstruction[temporaires.size() - 1] = m_arene.creer<NoeudInstOublier>(temporaires);
+  NoeudSeqInst* sequence = m_arene.creer<NoeudSeqInst>();
+  sequence->ajoute(m_oublisInstruction[temporaires.size() - 1]);
+  sequence->ajoute(resultat);
+  return sequence;
+}
@@ -0,0 +1,111 @@
+#ifndef OPTIMISEUR_H
+#define OPTIMISEUR_H
+
+// Optimiseur : passe qui réécrit l'arbre abstrait construit par l'analyse en un arbre équivalent
+// plus rapide à exécuter :
+//  - les sous-expressions constantes sont calculées une fois pour toutes (NoeudConstante) ;
+//  - les identités sûres sont simplifiées : x*1, 1*x, x/1, x+0, 0+x, x-0 donnent x, et e-e donne e*0
+//    (e est toujours évalué, pour qu'une variable indéfinie lève encore son exception) ;
+//  - 0 et e donne 0, c ou e donne 1 pour une constante c non nulle (e ne serait pas évalué) ;
+//  - les si, sinonsi, tantque, pour et repeter dont la condition est constante sont élagués ;
+//  - les boucles comptées (voir optimiserBoucleComptee) sont remplacées par la forme close de leur effet,
+//    ou déroulées si elles font peu de tours ;
+//  - dans chaque boucle (sortirInvariants), les sous-expressions dont les variables ne sont pas modifiées
+//    par la boucle ne sont calculées qu'une fois par exécution de la boucle (NoeudInvariant) ;
+//  - dans chaque instruction (numeroterValeurs), une sous-expression répétée n'est calculée qu'une fois.
+// Une division par une constante nulle n'est jamais calculée d'avance : elle lève toujours
+// DivParZeroException à l'exécution.
+// L'optimiseur ne modifie aucun noeud : il construit (dans l'arène) les noeuds qui changent et
+// réutilise tels quels les sous-arbres inchangés. Ses opérations et ses constantes passent par la table des
+// expressions de l'analyse : deux expressions de même forme restent le même noeud.
+
+#include <set>
+using namespace std;
+
+#include "ArbreAbstrait.h"
+#include "Arene.h"
+#include "TableSymboles.h"
+#include "TableExpressions.h"
+#include "IndexChaines.h"
+
+class Optimiseur {
+public:
+    Optimiseur(Arene & arene, TableSymboles & table, TableExpressions & expressions);
+    // Construit un optimiseur qui alloue ses noeuds dans arene (ses opérations et constantes dans expressions)
+    //  et ajoute ses temporaires à table
+    Noeud* optimiser(Noeud* noeud);
+    // Renvoie l'arbre optimisé équivalent à noeud (nullptr si c'est une instruction qui ne fait rien)
+    Noeud* sortirInvariants(Noeud* instruction);
+    // Renvoie l'instruction équivalente à instruction (non nulle) où, dans chaque boucle, les sous-expressions
+    //  invariantes (sans variable modifiée par la boucle) sont remplacées par des NoeudInvariant, oubliés juste
+    //  avant la boucle. Une expression invariante est calculée là où elle l'était, la première fois seulement :
+    //  elle lève donc ses exceptions (division par 0, variable indéfinie) exactement quand l'original les lève
+    Noeud* numeroterValeurs(Noeud* instruction);
+    // Renvoie l'instruction équivalente à instruction (non nulle) où, dans chaque affectation, chaque ecrire et les
+    //  conditions de chaque si, une sous-expression qui apparaît plusieurs fois (le même noeud, grâce à la table
+    //  des expressions) est remplacée partout par un même NoeudInvariant, oublié juste avant l'instruction : elle
+    //  n'est calculée qu'une fois par exécution de l'instruction, qui ne modifie aucune variable avant d'avoir
+    //  évalué toutes ses expressions. Les conditions et le second pas d'une boucle, réévalués après sa séquence,
+    //  ne sont pas concernés
+
+    static bool estConstante(const Noeud* noeud, int & valeur);
+    // Vrai si noeud est un entier du programme ou un NoeudConstante ; valeur reçoit alors sa valeur
+    static bool calculer(Jeton operateur, int g, int d, int & valeur);
+    // Calcule g operateur d dans valeur ; faux (sans rien calculer) pour une division par 0 ou INT_MIN / -1
+    static void variablesEcrites(const Noeud* instruction, set<const Noeud*> & variables);
+    // Ajoute à variables les variables (SymboleValue) que instruction peut modifier
+
+private:
+    Noeud* optimiserOperation(NoeudOperateurBinaire* operation);
+    Noeud* optimiserSiRiche(NoeudInstSiRiche* siRiche);
+    Noeud* optimiserAiguillage(NoeudInstAiguillage* aiguillage);
+    Noeud* optimiserBoucleComptee(Noeud* initialisation, Noeud* condition, const vector<Noeud*> & corps, Noeud* increment);
+    // Boucle comptée : initialisation est v = debut, condition compare v à une constante, increment est
+    //  v = v + pas ou v = v - pas (pas constant non nul), et les instructions de corps ne modifient pas v.
+    //  Son nombre de tours est alors connu : renvoie les instructions qui font le même effet que
+    //  initialisation ; tant que condition : corps ; increment. Renvoie nullptr si ce n'est pas une
+    //  boucle comptée, ou si le compteur déborderait, ou si elle n'est ni sous forme close ni assez courte
+    //  pour être déroulée
+    Noeud* optimiserBoucleApres(Noeud* initialisation, Noeud* boucle);
+    // Idem pour un tantque, ou un pour sans initialisation, qui suit l'instruction initialisation
+    Noeud* affectationConstante(Noeud* variable, int valeur); // Nouveau noeud variable = valeur
+    Noeud* sortirInvariantsBoucle(Noeud* boucle); // sortirInvariants pour la boucle boucle, sans ses boucles internes
+    Noeud* remplacerInvariants(Noeud* noeud, const set<const Noeud*> & ecrites, vector<Noeud*> & invariants);
+    // Renvoie noeud où chaque plus grande sous-expression invariante (dont aucune variable n'est dans ecrites)
+    //  est remplacée par un NoeudInvariant : celui de invariants qui a la même expression, ou un nouveau, ajouté
+    struct SousExpressions { // Les opérations d'une instruction, pour numeroterValeurs
+        IndexChaines         index;          // Le rang dans noeuds de chacune
+        vector<const Noeud*> noeuds;         // Dans l'ordre où elles sont vues
+        vector<bool>         repetees;       // Vrai pour celles qui sont répétées
+        vector<Noeud*>       invariants;     // Le NoeudInvariant de chacune (nullptr tant qu'il n'est pas construit)
+        unsigned int         nombreRepetees;
+        unsigned int rang(const Noeud* noeud) const; // Rang de noeud dans noeuds, IndexChaines::AUCUN s'il n'y est pas
+    };
+    bool numeroter(vector<Noeud*> & expressions, vector<Noeud*> & temporaires);
+    // Remplace dans expressions (celles d'une même instruction) les sous-expressions répétées par des NoeudInvariant,
+    //  dont les temporaires sont ajoutées à temporaires ; renvoie vrai si une expression a changé
+    static void compterRepetees(const Noeud* expression, SousExpressions & vues);
+    // Ajoute à vues les opérations de expression ; celles qui y étaient déjà, et ont au moins NOEUDS_MIN_INVARIANT
+    //  noeuds, sont répétées (ses sous-expressions ne sont comptées qu'avec sa première occurrence)
+    Noeud* remplacerRepetees(Noeud* expression, SousExpressions & vues, vector<Noeud*> & temporaires);
+    // Renvoie expression où chaque opération répétée de vues est remplacée par son NoeudInvariant (construit au
+    //  premier remplacement, sa temporaire, prise dans m_temporairesInstruction, étant ajoutée à temporaires)
+    static bool estInvariante(const Noeud* expression, const set<const Noeud*> & ecrites);
+    // Vrai si expression ne lit aucune variable de ecrites
+    static bool egales(const Noeud* a, const Noeud* b); // Vrai si a et b sont la même expression
+    static unsigned int taille(const Noeud* noeud);     // Nombre de noeuds de l'arbre noeud
+
+    static const unsigned int TOURS_MAX_DEROULES;  // Une boucle comptée n'est déroulée que si elle fait au plus
+    static const unsigned int NOEUDS_MAX_DEROULES; //  autant de tours, et si le corps déroulé a au plus autant de noeuds
+
+    static const unsigned int NOEUDS_MIN_INVARIANT; // Une expression invariante ou répétée n'est gardée que si elle a
+                                                    //  au moins autant de noeuds (une variable seule se lit aussi vite)
+
+    Arene &            m_arene;
+    TableSymboles &    m_table;
+    TableExpressions & m_expressions;
+    vector<Noeud*>     m_temporairesInstruction; // Les temporaires de numeroterValeurs, reprises par chaque instruction
+    vector<Noeud*>     m_oublisInstruction;      // Le NoeudInstOublier des n premières de ces temporaires est le (n-1)ème
+};
+
+#endif /* OPTIMISEUR_H */
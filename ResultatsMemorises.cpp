@@ -0,0 +1,128 @@
+#include "ResultatsMemorises.h"
+#include "CacheProgrammes.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+const char ResultatsMemorises::SIGNATURE[8] = { 'R', 'E', 'S', 'U', 'L', 'T', 'A', 'T' };
+const unsigned int ResultatsMemorises::VERSION = 5; // à augmenter dès que ce qu'écrit un programme peut changer
+
+////////////////////////////////////////////////////////////////////////////////
+// CaptureSortie
+////////////////////////////////////////////////////////////////////////////////
+
+CaptureSortie::CaptureSortie(ostream & flux, size_t limite)
+: m_flux(flux), m_destination(flux.rdbuf()), m_texte(), m_limite(limite), m_complet(true) {
+  setp(m_tampon, m_tampon + sizeof(m_tampon));
+  m_flux.rdbuf(this);
+}
+
+CaptureSortie::~CaptureSortie() {
+  sync();
+  m_flux.rdbuf(m_destination);
+}
+
+bool CaptureSortie::vider() {
+  size_t taille = pptr() - pbase();
+  if (taille == 0) return true;
+  if (m_complet && m_texte.size() + taille <= m_limite) m_texte.append(pbase(), taille);
+  else if (m_complet) { // trop long pour être mémorisé : inutile de garder le début
+    m_complet = false;
+    string().swap(m_texte);
+  }
+  bool ecrit = m_destination->sputn(pbase(), taille) == (streamsize) taille;
+  setp(m_tampon, m_tampon + sizeof(m_tampon));
+  return ecrit;
+}
+
+int CaptureSortie::overflow(int c) {
+  if (!vider()) return traits_type::eof();
+  if (c != traits_type::eof()) {
+    *pptr() = c;
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+int CaptureSortie::sync() {
+  if (!vider()) return -1;
+  return m_destination->pubsync();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ResultatsMemorises
+////////////////////////////////////////////////////////////////////////////////
+
+ResultatsMemorises::ResultatsMemorises(const string & repertoire, bool optimise, bool flux,
+                                       unsigned int profondeurAnalyse, unsigned long long tailleMax)
+: m_repertoire(repertoire), m_options((optimise ? OPTIMISE : 0) | (flux ? FLUX : 0)),
+  m_profondeurAnalyse(profondeurAnalyse), m_tailleMax(tailleMax) {
+  mkdir(m_repertoire.c_str(), 0777); // s'il existe déjà, rien à faire ; sinon les ouvertures échoueront
+}
+
+string ResultatsMemorises::nomFichier(unsigned long long hachageSource) const {
+  char nom[48];
+  snprintf(nom, sizeof(nom), "/%016llx-%u-%u.res", hachageSource, m_options, m_profondeurAnalyse);
+  return m_repertoire + nom;
+}
+
+bool ResultatsMemorises::rejouer(const TamponSource & source, ostream & sortie) const {
+  unsigned long long hachage = CacheProgrammes::hacher(source.getDebut(), source.getTaille());
+  int descripteur = open(nomFichier(hachage).c_str(), O_RDONLY);
+  if (descripteur < 0) return false; // pas encore mémorisé
+  struct stat infos;
+  void* adresse = MAP_FAILED;
+  if (fstat(descripteur, &infos) == 0 && S_ISREG(infos.st_mode) && (size_t) infos.st_size >= sizeof(EnteteResultat))
+    adresse = mmap(nullptr, infos.st_size, PROT_READ, MAP_PRIVATE, descripteur, 0);
+  if (adresse == MAP_FAILED) {
+    close(descripteur);
+    return false;
+  }
+  const EnteteResultat & entete = *(const EnteteResultat*) adresse;
+  const char* texte = (const char*) adresse + sizeof(EnteteResultat);
+  bool valide = memcmp(entete.signature, SIGNATURE, sizeof(SIGNATURE)) == 0
+          && entete.version == VERSION
+          && entete.options == m_options
+          && entete.profondeurAnalyse == m_profondeurAnalyse
+          && entete.tailleSource == source.getTaille()
+          && entete.hachageSource == hachage
+          && entete.tailleTexte == (unsigned long long) infos.st_size - sizeof(EnteteResultat)
+          && entete.somme == CacheProgrammes::hacher(texte, entete.tailleTexte);
+  if (valide) {
+    sortie.write(texte, entete.tailleTexte);
+    sortie.flush();
+    futimens(descripteur, nullptr); // utilisé maintenant : c'est le dernier à supprimer
+  }
+  munmap(adresse, infos.st_size);
+  close(descripteur);
+  return valide;
+}
+
+void ResultatsMemorises::enregistrer(const TamponSource & source, const string & texte) const {
+  if (sizeof(EnteteResultat) + texte.size() > m_tailleMax) return; // il prendrait toute la place
+  EnteteResultat entete;
+  memset(&entete, 0, sizeof(entete));
+  memcpy(entete.signature, SIGNATURE, sizeof(SIGNATURE));
+  entete.version = VERSION;
+  entete.options = m_options;
+  entete.profondeurAnalyse = m_profondeurAnalyse;
+  entete.hachageSource = CacheProgrammes::hacher(source.getDebut(), source.getTaille());
+  entete.tailleSource = source.getTaille();
+  entete.tailleTexte = texte.size();
+  entete.somme = CacheProgrammes::hacher(texte.data(), texte.size());
+
+  string nom = nomFichier(entete.hachageSource);
+  char suffixe[24];
+  snprintf(suffixe, sizeof(suffixe), ".%d.tmp", (int) getpid()); // deux exécutions simultanées n'écrivent pas le même
+  string temporaire = nom + suffixe;
+  ofstream sortie(temporaire.c_str(), ios::binary | ios::trunc);
+  sortie.write((const char*) &entete, sizeof(entete));
+  sortie.write(texte.data(), texte.size());
+  sortie.close();
+  if (sortie.fail() || rename(temporaire.c_str(), nom.c_str()) != 0) remove(temporaire.c_str());
+  CacheProgrammes::limiter(m_repertoire, ".res", m_tailleMax);
+}
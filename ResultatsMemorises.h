@@ -0,0 +1,82 @@
+#ifndef RESULTATSMEMORISES_H
+#define RESULTATSMEMORISES_H
+
+// Résultats mémorisés : un programme sans lire ne dépend que de son texte et des options qui changent ce
+// qu'écrit son exécution (les ecrire, puis la table des symboles ou le message de l'exception) : pour les mêmes,
+// c'est toujours le même texte. On le garde dans un fichier d'un répertoire, nommé d'après un hachage du texte
+// source et ces options ; une exécution suivante du même texte avec les mêmes options se contente de le réécrire. La taille totale des fichiers est bornée : quand elle
+// dépasse la limite, les résultats les moins récemment utilisés (date de modification la plus ancienne,
+// remise à jour à chaque utilisation) sont supprimés.
+//
+// Format du fichier : un en-tête (voir EnteteResultat) puis le texte écrit.
+
+#include <streambuf>
+#include <ostream>
+#include <string>
+using namespace std;
+
+#include "TamponSource.h"
+
+class CaptureSortie : public streambuf { // Garde une copie de ce qui est écrit sur un flux
+public:
+    CaptureSortie(ostream & flux, size_t limite); // Capture ce qui est écrit sur flux, jusqu'à limite octets
+    ~CaptureSortie();                             // Rend à flux sa destination
+    CaptureSortie(const CaptureSortie &) = delete;
+    CaptureSortie & operator=(const CaptureSortie &) = delete;
+
+    inline const string & getTexte() const { return m_texte; } // Le texte capturé
+    inline bool estComplet() const { return m_complet; }       // Faux si la limite a été dépassée
+
+protected:
+    int overflow(int c) override; // Le tampon est plein : vide-le, puis ajoute c
+    int sync() override;          // Vide le tampon, puis la destination
+
+private:
+    bool vider(); // Envoie le contenu du tampon à la destination et le copie dans m_texte
+
+    ostream &   m_flux;
+    streambuf*  m_destination; // Où écrivait flux avant la capture
+    string      m_texte;
+    size_t      m_limite;
+    bool        m_complet;
+    char        m_tampon[4096];
+};
+
+class ResultatsMemorises {
+public:
+    ResultatsMemorises(const string & repertoire, bool optimise, bool flux, unsigned int profondeurAnalyse,
+                       unsigned long long tailleMax);
+    // Résultats gardés dans repertoire (créé s'il n'existe pas), d'au plus tailleMax octets en tout, pour des
+    //  programmes optimisés ou non, exécutés en mode flux ou non (il n'écrit pas la même chose, voir
+    //  Interpreteur::commencerFlux), et analysés avec la limite d'imbrication profondeurAnalyse (avec une
+    //  limite plus petite, le même texte peut lever ProfondeurException)
+
+    bool rejouer(const TamponSource & source, ostream & sortie) const;
+    // Ecrit sur sortie le résultat mémorisé pour le texte source ; renvoie faux s'il n'y en a pas de valide
+    void enregistrer(const TamponSource & source, const string & texte) const;
+    // Mémorise texte comme le résultat du texte source, puis supprime les résultats les plus anciens si besoin
+
+private:
+    struct EnteteResultat {
+        char               signature[8];  // SIGNATURE
+        unsigned int       version;       // VERSION
+        unsigned int       options;       // OPTIMISE si le programme a été optimisé, | FLUX s'il a été exécuté en mode flux
+        unsigned int       profondeurAnalyse; // Interpreteur::getProfondeurMax() de l'analyse
+        unsigned long long hachageSource; // hachage (CacheProgrammes::hacher) du texte source
+        unsigned long long tailleSource;
+        unsigned long long tailleTexte;   // Nombre d'octets qui suivent l'en-tête
+        unsigned long long somme;         // hachage des octets qui suivent l'en-tête
+    };
+    static const char         SIGNATURE[8];
+    static const unsigned int VERSION;
+    enum { OPTIMISE = 1, FLUX = 2 }; // Les options d'une exécution
+
+    string nomFichier(unsigned long long hachageSource) const; // Fichier du résultat du texte de hachage hachageSource
+
+    string             m_repertoire;
+    unsigned int       m_options;
+    unsigned int       m_profondeurAnalyse;
+    unsigned long long m_tailleMax;
+};
+
+#endif /* RESULTATSMEMORISES_H */
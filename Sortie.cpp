@@ -0,0 +1,102 @@
+#include "Sortie.h"
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unistd.h>
+using namespace std;
+
+const size_t Sortie::TAILLE_TAMPON;
+const long long Sortie::DELAI_MAX = 50000000; // 50 ms
+#ifndef SORTIE_TO_CHARS
+const char Sortie::CHIFFRES[201] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+  "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+#endif
+
+char      Sortie::s_tampons[2][TAILLE_TAMPON];
+char*     Sortie::s_debut = s_tampons[0];
+char*     Sortie::s_position = s_tampons[0];
+char*     Sortie::s_fin = s_tampons[0] + TAILLE_TAMPON;
+long long Sortie::s_echeance = 0;
+bool      Sortie::s_parLigne = isatty(STDOUT_FILENO);
+
+// Le fil d'écriture et ce qu'il partage avec le programme
+static thread             filEcriture;
+static mutex              verrou;
+static condition_variable travail;         // Un tampon est à envoyer, ou le fil doit s'arrêter
+static condition_variable libre;           // Le fil a envoyé son tampon
+static const char*        aEnvoyer = nullptr; // Le tampon que le fil envoie (nullptr s'il attend)
+static size_t             longueurAEnvoyer = 0;
+static bool               arret = false;
+
+static void ecrivain() {
+  unique_lock<mutex> v(verrou);
+  for (;;) {
+    travail.wait(v, [] { return aEnvoyer != nullptr || arret; });
+    if (aEnvoyer == nullptr) return; // arrêt : tout a été envoyé
+    v.unlock();
+    cout.write(aEnvoyer, longueurAEnvoyer);
+    cout.flush();
+    v.lock();
+    aEnvoyer = nullptr;
+    libre.notify_one();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Sortie::envoyer() {
+  if (s_position != s_debut) {
+    if (!filEcriture.joinable()) {
+      cout.write(s_debut, s_position - s_debut);
+      cout.flush();
+    } else { // le fil prend ce tampon quand il a fini l'autre, que le programme va remplir
+      unique_lock<mutex> v(verrou);
+      libre.wait(v, [] { return aEnvoyer == nullptr; });
+      aEnvoyer = s_debut;
+      longueurAEnvoyer = s_position - s_debut;
+      travail.notify_one();
+      s_debut = (s_debut == s_tampons[0]) ? s_tampons[1] : s_tampons[0];
+      s_fin = s_debut + TAILLE_TAMPON;
+    }
+    s_position = s_debut;
+  }
+  s_echeance = maintenant() + DELAI_MAX;
+}
+
+void Sortie::ecrireLongue(const string & chaine) {
+  envoyer();
+  if (chaine.size() < TAILLE_TAMPON) { // elle tient dans le tampon vide
+    ecrire(chaine);
+    return;
+  }
+  vider(); // plus grande que le tampon : directement, après tout ce qui précède
+  cout << chaine << '\n';
+  cout.flush();
+}
+
+void Sortie::vider() {
+  envoyer();
+  if (filEcriture.joinable()) {
+    unique_lock<mutex> v(verrou);
+    libre.wait(v, [] { return aEnvoyer == nullptr; });
+  }
+}
+
+void Sortie::setFilEcriture(bool actif) {
+  if (actif == filEcriture.joinable()) return;
+  if (actif) {
+    arret = false;
+    filEcriture = thread(ecrivain);
+    return;
+  }
+  vider();
+  {
+    lock_guard<mutex> v(verrou);
+    arret = true;
+  }
+  travail.notify_one();
+  filEcriture.join();
+}
@@ -0,0 +1,111 @@
+#ifndef SORTIE_H
+#define SORTIE_H
+
+// Sortie : ce qu'écrivent les programmes (ecrire, lire) est accumulé dans un grand tampon, envoyé à cout d'un
+// bloc, plutôt que ligne par ligne (endl vide cout à chaque ligne : un appel système par valeur écrite).
+// Le tampon est envoyé :
+//  - quand il est plein ;
+//  - quand il n'a pas été envoyé depuis DELAI_MAX, au moment où une ligne s'y ajoute : un programme qui écrit peu
+//    voit chacune de ses lignes aussitôt, un programme qui écrit beaucoup envoie au plus une fois par DELAI_MAX ;
+//  - à chaque ligne si la sortie standard est un terminal ;
+//  - par vider(), avant que quelqu'un d'autre écrive sur cout : à la fin de l'exécution, ou avant d'afficher
+//    l'exception qui l'arrête.
+// Avec un fil d'écriture (voir setFilEcriture), deux tampons alternent : le fil envoie l'un à cout pendant que le
+// programme remplit l'autre. Tout passe par cout : une capture de cout (voir CaptureSortie) voit tout.
+
+#include <string>
+#include <string.h>
+#include <time.h>
+using namespace std;
+
+// std::to_chars (C++17) quand il est disponible, sinon une conversion deux chiffres à la fois
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#define SORTIE_TO_CHARS
+#endif
+#endif
+
+class Sortie {
+public:
+    static inline void ecrire(int valeur) {
+        if (s_fin - s_position < LIGNE_ENTIER_MAX) envoyer();
+        s_position = formater(valeur, s_position);
+        *s_position++ = '\n';
+        finLigne();
+    } // Ecrit valeur sur une ligne
+
+    static inline void ecrire(const string & chaine) {
+        if ((size_t) (s_fin - s_position) <= chaine.size()) {
+            ecrireLongue(chaine);
+            return;
+        }
+        memcpy(s_position, chaine.data(), chaine.size());
+        s_position += chaine.size();
+        *s_position++ = '\n';
+        finLigne();
+    } // Ecrit chaine sur une ligne
+
+    static void vider();
+    // Envoie à cout tout ce qui a été écrit (et attend que le fil d'écriture l'ait fait) : cout peut ensuite
+    //  servir directement
+
+    static void setFilEcriture(bool actif);
+    // Démarre (ou arrête, après avoir tout envoyé) le fil d'écriture
+
+private:
+    static inline char* formater(int valeur, char* p) {
+#ifdef SORTIE_TO_CHARS
+        return to_chars(p, p + LIGNE_ENTIER_MAX, valeur).ptr;
+#else
+        unsigned int u = (unsigned int) valeur;
+        if (valeur < 0) {
+            *p++ = '-';
+            u = 0u - u;
+        }
+        unsigned int n = 1; // nombre de chiffres
+        for (unsigned int puissance = 10; n < 10 && u >= puissance; puissance *= 10) n++;
+        char* fin = p + n;
+        for (; u >= 100; u /= 100) {
+            fin -= 2;
+            memcpy(fin, CHIFFRES + 2 * (u % 100), 2);
+        }
+        if (u >= 10) memcpy(fin - 2, CHIFFRES + 2 * u, 2);
+        else *(fin - 1) = '0' + u;
+        return p + n;
+#endif
+    } // Ecrit les chiffres de valeur à partir de p, renvoie la fin
+
+    static inline long long maintenant() {
+        struct timespec t;
+#ifdef CLOCK_MONOTONIC_COARSE
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &t); // quelques millisecondes de précision suffisent, et c'est rapide
+#else
+        clock_gettime(CLOCK_MONOTONIC, &t);
+#endif
+        return t.tv_sec * 1000000000LL + t.tv_nsec;
+    } // En nanosecondes
+
+    static inline void finLigne() {
+        if (s_parLigne || maintenant() >= s_echeance) envoyer();
+    }
+
+    static void envoyer();                           // Envoie le tampon (au fil d'écriture s'il y en a un)
+    static void ecrireLongue(const string & chaine); // ecrire quand chaine ne tient pas dans la place qui reste
+
+    static const int LIGNE_ENTIER_MAX = 12;  // Un entier écrit sur une ligne : signe, 10 chiffres, fin de ligne
+    static const size_t TAILLE_TAMPON = 1 << 16;
+    static const long long DELAI_MAX;        // En nanosecondes
+#ifndef SORTIE_TO_CHARS
+    static const char CHIFFRES[201];         // "00" "01" ... "99"
+#endif
+
+    static char      s_tampons[2][TAILLE_TAMPON]; // Le second ne sert qu'avec le fil d'écriture
+    static char*     s_debut;     // Le tampon que remplit le programme
+    static char*     s_position;  //  sa première place libre
+    static char*     s_fin;       //  et sa fin
+    static long long s_echeance;  // Le tampon est envoyé à la fin de la première ligne écrite après cet instant
+    static bool      s_parLigne;  // Vrai si la sortie standard est un terminal
+};
+
+#endif /* SORTIE_H */
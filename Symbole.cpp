@@ -1,63 +1,100 @@
 #include <ctype.h>
 #include <stdlib.h>
+#include <string.h>
 #include <iostream>
-#include <fstream>
 using namespace std;
 
 #include "Symbole.h"
 
-const char * Symbole::FICHIER_MOTS_CLES = "motsCles.txt";
+namespace {
+  // Texte de chaque jeton, dans l'ordre du type énuméré Jeton
+  constexpr const char * TEXTES[NB_JETONS] = {
+    "procedure", "principale", "finproc", "pour", "finpour", "si", "sinon", "sinonsi", "finsi",
+    "tantque", "fintantque", "repeter", "jusqua", "lire", "ecrire",
+    ";", ",", "=", "(", ")",
+    "+", "++", "-", "--", "*", "/",
+    "==", "!=", "<", "<=", ">", ">=",
+    "et", "ou", "non",
+    "<VARIABLE>", "<ENTIER>", "<CHAINE>", "<INDEFINI>", "<FINDEFICHIER>"
+  };
 
-Symbole::Symbole(const string & s) : m_chaine(s) {
+  // Les mots clés sont rangés, à la compilation, dans une table de hachage parfaite :
+  // le premier caractère, le dernier et la longueur suffisent à les distinguer tous.
+  constexpr unsigned int TAILLE_HACHAGE = 128;
+
+  constexpr unsigned int hacher(const char * mot, unsigned int longueur) {
+    return ((unsigned char) mot[0] + (unsigned char) mot[longueur - 1] + 17 * longueur) & (TAILLE_HACHAGE - 1);
+  }
+
+  constexpr unsigned int longueur(const char * mot) {
+    unsigned int n = 0;
+    while (mot[n] != '\0') n++;
+    return n;
+  }
+
+  struct TableMotsCles {
+    unsigned char jetons[TAILLE_HACHAGE];     // Jeton rangé dans chaque case, J_INDEFINI si la case est vide
+    unsigned char longueurs[TAILLE_HACHAGE];  // Longueur du mot clé rangé dans chaque case
+    bool parfaite;                            // Faux si deux mots clés tombent dans la même case
+  };
+
+  constexpr TableMotsCles construireTable() {
+    TableMotsCles table{};
+    for (unsigned int i = 0; i < TAILLE_HACHAGE; i++) table.jetons[i] = J_INDEFINI;
+    table.parfaite = true;
+    for (unsigned int j = 0; j < J_VARIABLE; j++) {
+      unsigned int n = longueur(TEXTES[j]);
+      unsigned int h = hacher(TEXTES[j], n);
+      if (table.jetons[h] != J_INDEFINI) table.parfaite = false;
+      table.jetons[h] = j;
+      table.longueurs[h] = n;
+    }
+    return table;
+  }
+
+  constexpr TableMotsCles MOTS_CLES = construireTable();
+  static_assert(MOTS_CLES.parfaite, "la fonction de hachage des mots clés doit rester sans collision");
+}
+
+Symbole::Symbole(const string & s) : m_chaine(s), m_jeton(classer(s.data(), s.size())) {
+}
+
+Jeton Symbole::classer(const char * debut, unsigned int longueur) {
   // attention : l'ordre des tests ci-dessous n'est pas innocent !
-  if (s == "") this->m_categorie = FINDEFICHIER;
-  else if (isdigit(s[0])) this->m_categorie = ENTIER;
-  else if (s.size() >= 2 && s[0] == '"' && s[s.size() - 1] == '"') this->m_categorie = CHAINE;
-  else if (isMotCle(s)) this->m_categorie = MOTCLE;
-  else if (isalpha(s[0])) this->m_categorie = VARIABLE;
-  else this->m_categorie = INDEFINI;
+  if (longueur == 0) return J_FINDEFICHIER;
+  else if (isdigit((unsigned char) debut[0])) return J_ENTIER;
+  else if (longueur >= 2 && debut[0] == '"' && debut[longueur - 1] == '"') return J_CHAINE;
+  Jeton motCle = chercherMotCle(debut, longueur);
+  if (motCle != J_INDEFINI) return motCle;
+  else if (isalpha((unsigned char) debut[0])) return J_VARIABLE;
+  else return J_INDEFINI;
 }
 
 bool Symbole::operator==(const string & ch) const {
   return this->m_chaine == ch ||
-          (this->m_categorie == VARIABLE && (ch == "<VARIABLE>" || ch == "<variable>")) ||
-          (this->m_categorie == ENTIER && (ch == "<ENTIER>" || ch == "<entier>")) ||
-          (this->m_categorie == CHAINE && (ch == "<CHAINE>" || ch == "<chaine>")) ||
-          (this->m_categorie == INDEFINI && (ch == "<INDEFINI>" || ch == "<indefini>")) ||
-          (this->m_categorie == FINDEFICHIER && (ch == "<FINDEFICHIER>" || ch == "<findefichier>"));
+          (this->m_jeton >= J_VARIABLE && ch.size() > 2 && ch[0] == '<' &&
+           strcasecmp(ch.c_str(), TEXTES[this->m_jeton]) == 0);
 }
 
-bool Symbole::isMotCle(const string & s) const {
-  static vector<string> motsCles;
-  // si on n'a pas encore chargé les mots clés dans le vecteur, on le fait !
-  if (!motsCles.size()) {
-    ifstream fichier(FICHIER_MOTS_CLES);
-    while (!fichier.eof()) {
-      string mot;
-      getline(fichier, mot);
-      if (mot != "") { // insertion triée de mot dans le vecteur des mots clés
-        vector<string>::iterator it = motsCles.begin();
-        while (it < motsCles.end() && *it < mot) it++;
-        if (it == motsCles.end() || *it != mot) // si pas trouvé...
-          motsCles.insert(it, mot);
-      }
-    }
-    fichier.close();
-  }
-  // on recherche  s dans le vecteur des mots clés triés
-  unsigned int i;
-  for (i = 0; i < motsCles.size() && motsCles[i] < s; i++);
-  return (i < motsCles.size() && motsCles[i] == s);
+Jeton Symbole::chercherMotCle(const char * debut, unsigned int longueur) {
+  unsigned int h = hacher(debut, longueur);
+  if (MOTS_CLES.longueurs[h] == longueur && memcmp(TEXTES[MOTS_CLES.jetons[h]], debut, longueur) == 0)
+    return (Jeton) MOTS_CLES.jetons[h];
+  return J_INDEFINI;
+}
+
+const char * Symbole::getTexte(Jeton jeton) {
+  return TEXTES[jeton];
 }
 
 ostream & operator<<(ostream & cout, const Symbole & symbole) {
   cout << "Symbole de type ";
-  if (symbole.m_categorie == Symbole::MOTCLE) cout << "<MOTCLE>      ";
-  else if (symbole.m_categorie == Symbole::VARIABLE) cout << "<VARIABLE>    ";
-  else if (symbole.m_categorie == Symbole::ENTIER) cout << "<ENTIER>      ";
-  else if (symbole.m_categorie == Symbole::CHAINE) cout << "<CHAINE>      ";
-  else if (symbole.m_categorie == Symbole::INDEFINI) cout << "<INDEFINI>    ";
-  else if (symbole.m_categorie == Symbole::FINDEFICHIER) cout << "<FINDEFICHIER>";
+  if (symbole.m_jeton < J_VARIABLE) cout << "<MOTCLE>      ";
+  else if (symbole.m_jeton == J_VARIABLE) cout << "<VARIABLE>    ";
+  else if (symbole.m_jeton == J_ENTIER) cout << "<ENTIER>      ";
+  else if (symbole.m_jeton == J_CHAINE) cout << "<CHAINE>      ";
+  else if (symbole.m_jeton == J_INDEFINI) cout << "<INDEFINI>    ";
+  else if (symbole.m_jeton == J_FINDEFICHIER) cout << "<FINDEFICHIER>";
   cout << " : \"" << symbole.m_chaine << "\"";
   return cout;
 }
@@ -6,21 +6,38 @@
 #include <string>
 using namespace std;
 
+// Code entier d'un symbole : un code par mot clé du langage (dans l'ordre de l'ancien fichier motsCles.txt),
+// puis un code par catégorie de symbole qui n'est pas un mot clé
+enum Jeton : unsigned char {
+	J_PROCEDURE, J_PRINCIPALE, J_FINPROC, J_POUR, J_FINPOUR, J_SI, J_SINON, J_SINONSI, J_FINSI,
+	J_TANTQUE, J_FINTANTQUE, J_REPETER, J_JUSQUA, J_LIRE, J_ECRIRE,
+	J_POINTVIRGULE, J_VIRGULE, J_AFFECTATION, J_PARENTHESEOUVRANTE, J_PARENTHESEFERMANTE,
+	J_PLUS, J_PLUSPLUS, J_MOINS, J_MOINSMOINS, J_MULTIPLICATION, J_DIVISION,
+	J_EGAL, J_DIFFERENT, J_INFERIEUR, J_INFERIEUREGAL, J_SUPERIEUR, J_SUPERIEUREGAL,
+	J_ET, J_OU, J_NON,
+	J_VARIABLE, J_ENTIER, J_CHAINE, J_INDEFINI, J_FINDEFICHIER,
+	NB_JETONS
+};
+
 // Symbole représente un élément du langage (mot-clé, entier, identificateur de variable, ...)
 class Symbole {
 public:
 	Symbole(const string & s = "");  // Construit le symbole à partir de la chaine (string) ch lue par le lecteur de symbole dans un fichier
 	bool operator == (const string & ch) const ; // Pour tester l'égalité entre le symbole et une chaîne
 	inline bool operator != (const string  & ch) const { return ! (*this == ch); } // Pour tester la différence...
+	inline bool operator == (Jeton jeton) const { return m_jeton == jeton; } // Pour tester le code du symbole
+	inline bool operator != (Jeton jeton) const { return m_jeton != jeton; } //  sans comparer de chaînes
 	inline const string & getChaine() const { return m_chaine;} // Accesseur
+	inline Jeton getJeton() const { return m_jeton;}             // Accesseur
 	friend ostream & operator <<(ostream & cout, const Symbole & symbole); // Fonction amie pour pouvoir afficher un symbole sur cout 
 
+	static Jeton classer(const char * debut, unsigned int longueur); // Code du symbole formé des longueur caractères de debut
+	static const char * getTexte(Jeton jeton); // Texte d'un mot clé, ou nom de la catégorie ("<VARIABLE>", ...)
+
 private:
-    	enum m_categorie { MOTCLE, VARIABLE, ENTIER, CHAINE, INDEFINI, FINDEFICHIER };
 	string           m_chaine;             // Chaîne du symbole
-	m_categorie      m_categorie;          // Categorie du symbole (voir type énuméré ci-dessus)
-	bool             isMotCle(const string & s) const;  // Renvoie vrai si s est un mot clé du langage
-        static const char * FICHIER_MOTS_CLES; // Le fichier des mots clés du langage
+	Jeton            m_jeton;              // Code du mot clé, ou catégorie du symbole (voir type énuméré ci-dessus)
+	static Jeton     chercherMotCle(const char * debut, unsigned int longueur);  // Code du mot clé, J_INDEFINI si ce n'en est pas un
 };
 
 #endif /* SYMBOLE_H */
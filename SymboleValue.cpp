@@ -2,24 +2,24 @@
 #include "Exceptions.h"
 #include <stdlib.h>
 
-SymboleValue::SymboleValue(const Symbole & s) :
-Symbole(s.getChaine()) {
+SymboleValue::SymboleValue(const Symbole & s, vector<Emplacement> & emplacements) :
+Symbole(s.getChaine()), m_emplacements(emplacements), m_numero(emplacements.size()) {
   if (s == "<ENTIER>") {
-    m_valeur = atoi(s.getChaine().c_str()); // c_str convertit une string en char*
-    m_defini = true;
+    emplacements.push_back(Emplacement{atoi(s.getChaine().c_str()), true}); // c_str convertit une string en char*
   } else {
-    m_defini = false;
+    emplacements.push_back(Emplacement{0, false});
   }
 }
 
 int SymboleValue::executer() {
-  if (!m_defini) throw IndefiniException(); // on lève une exception si valeur non définie
-  return m_valeur;
+  const Emplacement & e = m_emplacements[m_numero];
+  if (!e.defini) throw IndefiniException(); // on lève une exception si valeur non définie
+  return e.valeur;
 }
 
 ostream & operator<<(ostream & cout, const SymboleValue & symbole) {
   cout << (Symbole) symbole << "\t\t - Valeur=";
-  if (symbole.m_defini) cout << symbole.m_valeur << " ";
+  if (symbole.estDefini()) cout << symbole.getValeur() << " ";
   else cout << "indefinie ";
   return cout;
 }
@@ -5,23 +5,35 @@
 #include <iostream>
 using namespace std;
 
+#include <vector>
 #include "Symbole.h"
 #include "ArbreAbstrait.h"
 
+struct Emplacement {  // La valeur d'un symbole valué, rangée avec celles des autres symboles
+	  int  valeur;	// valeur du symbole si elle est définie, zéro sinon
+	  bool defini;	// indique si la valeur du symbole est définie
+};
+
 class SymboleValue : public Symbole,  // Un symbole valué est un symbole qui a une valeur (définie ou pas)
                      public Noeud  {  //  et c'est aussi une feuille de l'arbre abstrait
 public:
-	  SymboleValue(const Symbole & s); // Construit un symbole valué à partir d'un symbole existant s
+	  SymboleValue(const Symbole & s, vector<Emplacement> & emplacements);
+	  // Construit un symbole valué à partir d'un symbole existant s ; sa valeur est rangée
+	  // dans un nouvel emplacement, ajouté à la fin de emplacements
 	  ~SymboleValue( ) {}
 	  int  executer();         // exécute le SymboleValue (revoie sa valeur !)
-	  inline void setValeur(int valeur)    { this->m_valeur=valeur; m_defini=true;  } // accesseur
-	  inline bool estDefini()              { return m_defini;                       } // accesseur
+	  GenreNoeud getGenre() const { return N_SYMBOLEVALUE; }
+	  inline void setValeur(int valeur)    { m_emplacements[m_numero] = Emplacement{valeur, true}; } // accesseur
+	  inline int  getValeur() const      { return m_emplacements[m_numero].valeur;              } // accesseur
+	  inline bool estDefini() const      { return m_emplacements[m_numero].defini;              } // accesseur
+	  inline void oublier()              { m_emplacements[m_numero].defini = false;             } // rend la valeur indéfinie
+	  inline unsigned int getNumero() const { return m_numero;                                  } // accesseur
 
 	  friend ostream & operator << (ostream & cout, const SymboleValue & symbole); // affiche un symbole value sur cout
 
 private:
-	  bool m_defini;	// indique si la valeur du symbole est définie
-	  int  m_valeur;	// valeur du symbole si elle est définie, zéro sinon
+	  vector<Emplacement> & m_emplacements; // Les emplacements de tous les symboles valués de la table
+	  unsigned int          m_numero;       // indice de l'emplacement de ce symbole dans m_emplacements
 
 };
 
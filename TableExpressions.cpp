@@ -0,0 +1,79 @@
+#include "TableExpressions.h"
+
+TableExpressions::TableExpressions(Arene & arene) : m_arene(arene), m_expressions(), m_index() {
+}
+
+void TableExpressions::vider() {
+  if (m_expressions.empty()) return;
+  m_expressions.clear();
+  m_index = IndexChaines();
+}
+
+unsigned int TableExpressions::hacher(GenreNoeud genre, int valeur, const Noeud* gauche, const Noeud* droit) {
+  // les opérandes sont déjà partagés : leurs adresses suffisent à les distinguer. Un mot à la fois (multiplication
+  //  par l'inverse du nombre d'or, puis les bits hauts replacés dans les bas, qui choisissent l'entrée de l'index)
+  const unsigned long long K = 0x9E3779B97F4A7C15ULL;
+  unsigned long long h = ((unsigned long long) genre << 32 | (unsigned int) valeur) * K;
+  h = (h ^ (unsigned long long) gauche) * K;
+  h = (h ^ (unsigned long long) droit) * K;
+  return (unsigned int) (h ^ h >> 32);
+}
+
+Noeud* TableExpressions::operation(Jeton operateur, Noeud* operandeGauche, Noeud* operandeDroit) {
+  unsigned int hachage = hacher(N_OPERATEURBINAIRE, operateur, operandeGauche, operandeDroit);
+  unsigned int rang = m_index.chercher(hachage, [&](unsigned int r) {
+    if (m_expressions[r]->getGenre() != N_OPERATEURBINAIRE) return false;
+    const NoeudOperateurBinaire* e = (const NoeudOperateurBinaire*) m_expressions[r];
+    return e->getOperateur() == operateur && e->getOperandeGauche() == operandeGauche
+            && e->getOperandeDroit() == operandeDroit;
+  });
+  if (rang == IndexChaines::AUCUN) { // pas encore construite
+    rang = m_expressions.size();
+    m_expressions.push_back(NoeudOperateurBinaire::creer(m_arene, operateur, operandeGauche, operandeDroit));
+    m_index.inserer(hachage, rang);
+  }
+  return m_expressions[rang];
+}
+
+Noeud* TableExpressions::operation(Jeton operateur, Noeud* operande) {
+  unsigned int hachage = hacher(N_OPERATEURUNAIRE, operateur, operande, nullptr);
+  unsigned int rang = m_index.chercher(hachage, [&](unsigned int r) {
+    if (m_expressions[r]->getGenre() != N_OPERATEURUNAIRE) return false;
+    const NoeudOperateurUnaire* e = (const NoeudOperateurUnaire*) m_expressions[r];
+    return e->getOperateur() == operateur && e->getOperande() == operande;
+  });
+  if (rang == IndexChaines::AUCUN) {
+    rang = m_expressions.size();
+    m_expressions.push_back(NoeudOperateurUnaire::creer(m_arene, operateur, operande));
+    m_index.inserer(hachage, rang);
+  }
+  return m_expressions[rang];
+}
+
+Noeud* TableExpressions::constante(int valeur) {
+  unsigned int hachage = hacher(N_CONSTANTE, valeur, nullptr, nullptr);
+  unsigned int rang = m_index.chercher(hachage, [&](unsigned int r) {
+    return m_expressions[r]->getGenre() == N_CONSTANTE && ((const NoeudConstante*) m_expressions[r])->getValeur() == valeur;
+  });
+  if (rang == IndexChaines::AUCUN) {
+    rang = m_expressions.size();
+    m_expressions.push_back(m_arene.creer<NoeudConstante>(valeur));
+    m_index.inserer(hachage, rang);
+  }
+  return m_expressions[rang];
+}
+
+Noeud* TableExpressions::invariant(Noeud* temporaire, Noeud* expression) {
+  unsigned int hachage = hacher(N_INVARIANT, 0, temporaire, expression);
+  unsigned int rang = m_index.chercher(hachage, [&](unsigned int r) {
+    if (m_expressions[r]->getGenre() != N_INVARIANT) return false;
+    const NoeudInvariant* e = (const NoeudInvariant*) m_expressions[r];
+    return e->getTemporaire() == temporaire && e->getExpression() == expression;
+  });
+  if (rang == IndexChaines::AUCUN) {
+    rang = m_expressions.size();
+    m_expressions.push_back(m_arene.creer<NoeudInvariant>(temporaire, expression));
+    m_index.inserer(hachage, rang);
+  }
+  return m_expressions[rang];
+}
@@ -0,0 +1,47 @@
+#ifndef TABLEEXPRESSIONS_H
+#define TABLEEXPRESSIONS_H
+
+// Table des expressions : comme la table des symboles pour les variables, elle ne construit qu'une fois
+// chaque opération (et chaque constante ou invariant de l'optimiseur) : deux sous-expressions de même forme
+// sur les mêmes opérandes sont le même noeud. Une expression n'a pas d'effet de bord et ses noeuds ne sont
+// jamais modifiés : les partager ne change pas ce qu'exécute l'arbre, qui devient un graphe sans cycle.
+// L'arbre d'un programme qui répète les mêmes sous-expressions prend ainsi moins de place, et deux
+// expressions identiques se reconnaissent en comparant des pointeurs (voir Optimiseur::numeroterValeurs).
+
+#include <vector>
+using namespace std;
+
+#include "ArbreAbstrait.h"
+#include "Arene.h"
+#include "IndexChaines.h"
+
+class TableExpressions {
+public:
+    TableExpressions(Arene & arene); // Construit une table vide, dont les noeuds seront alloués dans arene
+    TableExpressions(const TableExpressions &) = delete;
+    TableExpressions & operator=(const TableExpressions &) = delete;
+
+    Noeud* operation(Jeton operateur, Noeud* operandeGauche, Noeud* operandeDroit);
+    // Renvoie l'opération binaire operandeGauche operateur operandeDroit : celle déjà construite s'il y en a une,
+    //  sinon une nouvelle (voir NoeudOperateurBinaire::creer)
+    Noeud* operation(Jeton operateur, Noeud* operande); // Idem pour une opération unaire (- ou non)
+    Noeud* constante(int valeur);                       // Idem pour un NoeudConstante
+    Noeud* invariant(Noeud* temporaire, Noeud* expression); // Idem pour un NoeudInvariant
+
+    void vider(); // Oublie toutes les expressions construites (leurs noeuds vont être détruits, voir Arene::revenir)
+
+    inline unsigned int getTaille() const {
+        return m_expressions.size();
+    } // Nombre d'expressions différentes construites
+
+    static unsigned int hacher(GenreNoeud genre, int valeur, const Noeud* gauche, const Noeud* droit);
+    // Hachage d'une expression : son genre, son opérateur (ou sa valeur) et ses opérandes (ou sa temporaire et son
+    //  expression) ; sert aussi à ranger les noeuds de la table eux-mêmes, par leur adresse (gauche)
+
+private:
+    Arene &        m_arene;
+    vector<Noeud*> m_expressions; // Les expressions construites, dans l'ordre de construction
+    IndexChaines   m_index;       // Le rang dans m_expressions de chaque expression
+};
+
+#endif /* TABLEEXPRESSIONS_H */
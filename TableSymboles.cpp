@@ -1,6 +1,7 @@
 #include "TableSymboles.h"
+#include <algorithm>
 
-TableSymboles::TableSymboles() : m_table() {
+TableSymboles::TableSymboles(Arene & arene) : m_arene(arene), m_table(), m_emplacements(), m_temporaires(), m_index(), m_parNumero() {
 }
 
 SymboleValue * TableSymboles::chercheAjoute(const Symbole & s)
@@ -9,12 +10,32 @@ SymboleValue * TableSymboles::chercheAjoute(const Symbole & s)
 // Sinon, on insère un nouveau symbole valué correspondant à s
 // et on renvoie un pointeur sur le nouveau symbole valué inséré.
 {
-  vector<SymboleValue*>::iterator i;
-  i = m_table.begin();
-  while (i < m_table.end() && (**i).getChaine() < s.getChaine()) i++;
-  if (i == m_table.end() || (**i).getChaine() != s.getChaine()) // si pas trouvé...
-    i = m_table.insert(i, new SymboleValue(s));
-  return *i;
+  const string & chaine = s.getChaine();
+  unsigned int hachage = IndexChaines::hacher(chaine.data(), chaine.size());
+  unsigned int rang = m_index.chercher(hachage, [&](unsigned int r) {
+    return m_table[r]->getChaine() == chaine;
+  });
+  if (rang == IndexChaines::AUCUN) { // si pas trouvé...
+    rang = m_table.size();
+    m_table.push_back(m_arene.creer<SymboleValue>(s, m_emplacements));
+    m_index.inserer(hachage, rang);
+  }
+  return m_table[rang];
+}
+
+SymboleValue * TableSymboles::chercheAjoute(unsigned int numero, const ReservoirChaines & reservoir) {
+  if (numero >= m_parNumero.size()) m_parNumero.resize(reservoir.getTaille(), nullptr);
+  if (m_parNumero[numero] == nullptr) // première recherche de ce numéro : on passe par la chaîne
+    m_parNumero[numero] = chercheAjoute(Symbole(reservoir.getChaine(numero)));
+  return m_parNumero[numero];
+}
+
+SymboleValue * TableSymboles::ajouteTemporaire() {
+  // son nom ne peut pas être celui d'une variable du programme ; les symboles ajoutés ensuite auraient un
+  //  emplacement après le sien : toutes les temporaires doivent être ajoutées après l'analyse
+  SymboleValue* temporaire = m_arene.creer<SymboleValue>(Symbole("#" + to_string(m_temporaires.size())), m_emplacements);
+  m_temporaires.push_back(temporaire);
+  return temporaire;
 }
 
 ostream & operator<<(ostream & cout, const TableSymboles & ts)
@@ -22,8 +43,12 @@ ostream & operator<<(ostream & cout, const TableSymboles & ts)
 {
   cout << endl << "Contenu de la Table des Symboles Values :" << endl
           << "---------------------------------------" << endl << endl;
-  for (unsigned int i = 0; i < ts.getTaille(); i++)
-    cout << "  " << ts[i] << endl;
+  vector<const SymboleValue*> triee(ts.m_table.begin(), ts.m_table.end());
+  sort(triee.begin(), triee.end(), [](const SymboleValue* a, const SymboleValue* b) {
+    return a->getChaine() < b->getChaine();
+  });
+  for (unsigned int i = 0; i < triee.size(); i++)
+    cout << "  " << *triee[i] << endl;
   cout << endl;
   return cout;
 }
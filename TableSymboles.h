@@ -2,18 +2,31 @@
 #define TABLESYMBOLES_H
 
 #include "SymboleValue.h"
+#include "FluxJetons.h"
+#include "IndexChaines.h"
+#include "Arene.h"
 #include <vector>
 #include <iostream>
 using namespace std;
 
 class TableSymboles {
 public:
-    TableSymboles(); // Construit une table vide de pointeurs sur des symboles valués
+    TableSymboles(Arene & arene); // Construit une table vide de pointeurs sur des symboles valués,
+                                  //  qui seront alloués dans arene
+    TableSymboles(const TableSymboles &) = delete; // les symboles valués désignent les emplacements de leur table
+    TableSymboles & operator=(const TableSymboles &) = delete;
     SymboleValue* chercheAjoute(const Symbole & symbole);
     // si symbole est identique à un symbole valué déjà présent dans la table,
     // on renvoie un pointeur sur ce symbole valué
     // Sinon on insère un nouveau symbole valué correspondant à symbole
     // et on renvoie un pointeur sur le nouveau symbole valué inséré
+    SymboleValue* chercheAjoute(unsigned int numero, const ReservoirChaines & reservoir);
+    // Idem pour le symbole dont l'orthographe est la chaîne numero de reservoir :
+    // la recherche se fait directement par le numéro, sans comparer de chaînes
+    // (une table ne doit être utilisée qu'avec un seul réservoir)
+    SymboleValue* ajouteTemporaire();
+    // Ajoute une variable temporaire de l'optimiseur (voir NoeudInvariant), indéfinie : elle a un emplacement
+    // (après ceux des symboles) mais n'est pas dans la table, ni affichée avec elle
 
     inline unsigned int getTaille() const {
         return m_table.size();
@@ -21,11 +34,31 @@ public:
 
     inline const SymboleValue & operator[](unsigned int i) const {
         return *m_table[i];
-    } // accès au ième SymboleValue de la table
-    friend ostream & operator<<(ostream & cout, const TableSymboles & ts); // affiche ts sur cout
+    } // accès au ième SymboleValue de la table (dans l'ordre d'insertion : son emplacement est le ième)
+
+    inline unsigned int getNombreTemporaires() const {
+        return m_temporaires.size();
+    } // Nombre de temporaires ajoutées par ajouteTemporaire
+
+    inline const SymboleValue & getTemporaire(unsigned int i) const {
+        return *m_temporaires[i];
+    } // accès à la ième temporaire (son emplacement est le (getTaille() + i)ème)
+
+    inline vector<Emplacement> & getEmplacements() {
+        return m_emplacements;
+    } // Les valeurs de tous les symboles valués, contiguës, dans l'ordre d'insertion, puis celles des temporaires
+    inline const vector<Emplacement> & getEmplacements() const {
+        return m_emplacements;
+    }
+
+    friend ostream & operator<<(ostream & cout, const TableSymboles & ts); // affiche ts sur cout, triée sur la chaine
 
 private:
-    vector<SymboleValue*> m_table; // La table des symboles valués, triée sur la chaine
-    // (on aurait dû plus judicieusement utiliser map au lieu de vector)
+    Arene &               m_arene;        // L'arène où sont alloués les symboles valués
+    vector<SymboleValue*> m_table;        // La table des symboles valués, dans l'ordre d'insertion
+    vector<Emplacement>   m_emplacements; // L'emplacement de la valeur de chaque symbole valué (même ordre)
+    vector<SymboleValue*> m_temporaires;  // Les temporaires, dans l'ordre d'ajout
+    IndexChaines          m_index;        // Le rang dans m_table de chaque chaine
+    vector<SymboleValue*> m_parNumero; // Symbole valué de chaque numéro de chaîne du réservoir, nullptr si pas encore cherché
 };
 #endif /* TABLESYMBOLES_H */
@@ -0,0 +1,105 @@
+#include "TamponSource.h"
+#include "Exceptions.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdint.h>
+using namespace std;
+
+const size_t TamponSource::TAILLE_BLOC = 1 << 16;
+
+////////////////////////////////////////////////////////////////////////////////
+
+TamponSource::TamponSource(const string & nomFichier) :
+m_debut(nullptr), m_fin(nullptr), m_projection(nullptr), m_tailleProjection(0), m_contenu(), m_oublie(nullptr) {
+  int descripteur = open(nomFichier.c_str(), O_RDONLY);
+  if (descripteur < 0) // si le fichier ne peut-être lu...
+    throw FichierException();
+  try {
+    charger(descripteur);
+  } catch (FichierException &) {
+    close(descripteur);
+    throw;
+  }
+  close(descripteur);
+}
+
+TamponSource::TamponSource(int descripteur) :
+m_debut(nullptr), m_fin(nullptr), m_projection(nullptr), m_tailleProjection(0), m_contenu(), m_oublie(nullptr) {
+  charger(descripteur);
+}
+
+void TamponSource::charger(int descripteur) {
+  struct stat infos;
+  if (fstat(descripteur, &infos) == 0 && S_ISREG(infos.st_mode) && infos.st_size > 0) {
+    // fichier régulier : on le projette en entier, le système se charge de la lecture
+    void* adresse = mmap(nullptr, infos.st_size, PROT_READ, MAP_PRIVATE, descripteur, 0);
+    if (adresse != MAP_FAILED) {
+      m_projection = adresse;
+      m_tailleProjection = infos.st_size;
+      madvise(adresse, infos.st_size, MADV_SEQUENTIAL); // le lecteur parcourt le texte du début à la fin
+    }
+  }
+  if (m_projection == nullptr) lireParBlocs(descripteur); // tube, fichier vide, projection refusée...
+  if (m_projection != nullptr) {
+    m_debut = (const char*) m_projection;
+    m_fin = m_debut + m_tailleProjection;
+  } else {
+    m_debut = m_contenu.data();
+    m_fin = m_debut + m_contenu.size();
+  }
+  m_oublie = m_debut;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TamponSource::TamponSource(istream & flux) :
+m_debut(nullptr), m_fin(nullptr), m_projection(nullptr), m_tailleProjection(0), m_contenu(), m_oublie(nullptr) {
+  if (flux.fail()) // si le flux ne peut-être lu...
+    throw FichierException();
+  size_t taille = 0;
+  do {
+    m_contenu.resize(taille + TAILLE_BLOC);
+    flux.read(m_contenu.data() + taille, TAILLE_BLOC);
+    taille += flux.gcount();
+  } while (flux);
+  m_contenu.resize(taille);
+  m_debut = m_contenu.data();
+  m_fin = m_debut + taille;
+  m_oublie = m_debut;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TamponSource::~TamponSource() {
+  if (m_projection != nullptr) munmap(m_projection, m_tailleProjection);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TamponSource::oublierAvant(const char* position) {
+  if (m_projection == nullptr) return; // le texte lu par blocs reste en entier dans m_contenu
+  // seulement des pages entières : celle de position est encore lue
+  static const uintptr_t TAILLE_PAGE = sysconf(_SC_PAGESIZE);
+  const char* fin = (const char*) ((uintptr_t) position & ~(TAILLE_PAGE - 1));
+  if (fin <= m_oublie) return;
+  madvise((void*) m_oublie, fin - m_oublie, MADV_DONTNEED);
+  m_oublie = fin;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TamponSource::lireParBlocs(int descripteur) {
+  size_t taille = 0;
+  for (;;) {
+    m_contenu.resize(taille + TAILLE_BLOC);
+    ssize_t lus = read(descripteur, m_contenu.data() + taille, TAILLE_BLOC);
+    if (lus < 0 && errno == EINTR) continue;
+    if (lus < 0) throw FichierException();
+    if (lus == 0) break; // fin du fichier
+    taille += lus;
+  }
+  m_contenu.resize(taille);
+}
@@ -0,0 +1,52 @@
+#ifndef TAMPONSOURCE_H
+#define TAMPONSOURCE_H
+
+#include <istream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Tampon contenant tout le texte d'un fichier source.
+// Un fichier régulier est projeté en mémoire (mmap) ; sinon (tube, terminal, ...)
+// ou si la projection échoue, il est lu par gros blocs dans un vecteur.
+
+class TamponSource {
+public:
+    TamponSource(const string & nomFichier); // Projette (ou lit) le fichier nomFichier
+    TamponSource(istream & flux);            // Lit le flux par blocs jusqu'à sa fin
+    TamponSource(int descripteur);           // Idem pour le fichier déjà ouvert descripteur (qui reste ouvert)
+    ~TamponSource();                         // Libère la projection éventuelle
+
+    TamponSource(const TamponSource &) = delete;             // Un tampon ne se copie pas
+    TamponSource & operator=(const TamponSource &) = delete; //  (il possède la projection)
+
+    inline const char* getDebut() const {
+        return m_debut;
+    } // Adresse du premier caractère du texte
+
+    inline const char* getFin() const {
+        return m_fin;
+    } // Adresse qui suit le dernier caractère du texte
+
+    inline size_t getTaille() const {
+        return m_fin - m_debut;
+    } // Nombre de caractères du texte
+
+    void oublierAvant(const char* position);
+    // Le texte avant position ne sera plus lu : la mémoire de sa projection peut être rendue au système
+    // (il serait relu dans le fichier s'il l'était quand même)
+
+private:
+    const char*  m_debut;            // Début du texte (dans la projection ou dans m_contenu)
+    const char*  m_fin;              // Fin du texte
+    void*        m_projection;       // Adresse de la projection, nullptr si le texte est dans m_contenu
+    size_t       m_tailleProjection; // Taille de la projection
+    vector<char> m_contenu;          // Texte lu par blocs lorsqu'il n'a pas pu être projeté
+    const char*  m_oublie;           // Fin de la partie de la projection déjà rendue par oublierAvant
+
+    void charger(int descripteur);      // Projette (ou lit) le fichier ouvert descripteur
+    void lireParBlocs(int descripteur); // Lit tout ce que fournit descripteur dans m_contenu
+    static const size_t TAILLE_BLOC;    // Taille des blocs de lecture
+};
+
+#endif /* TAMPONSOURCE_H */
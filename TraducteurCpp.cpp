@@ -0,0 +1,398 @@
+#include "TraducteurCpp.h"
+#include "SymboleValue.h"
+#include "Exceptions.h"
+#include "Optimiseur.h"
+#include "Entree.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+
+TraducteurCpp::TraducteurCpp(const TableSymboles & table)
+: m_table(table), m_code(), m_indentation(0), m_temporaires(0), m_lire(false) {
+}
+
+string TraducteurCpp::litteral(const string & chaine) {
+  string resultat = "\"";
+  for (unsigned int i = 0; i < chaine.size(); i++) {
+    unsigned char c = chaine[i];
+    if (c == '"' || c == '\\') {
+      resultat += '\\';
+      resultat += c;
+    } else if (c < ' ' || c >= 127) { // en octal, sur 3 chiffres pour ne pas se mélanger aux suivants
+      char octal[5];
+      snprintf(octal, sizeof(octal), "\\%03o", c);
+      resultat += octal;
+    } else resultat += c;
+  }
+  return resultat + "\"";
+}
+
+static string entier(int valeur) {
+  if (valeur == INT_MIN) return "(-2147483647 - 1)";
+  ostringstream sortie;
+  if (valeur < 0) sortie << "(" << valeur << ")";
+  else sortie << valeur;
+  return sortie.str();
+}
+
+string TraducteurCpp::nom(const Noeud* noeud) const {
+  unsigned int numero = ((const SymboleValue*) noeud)->getNumero();
+  if (numero < m_table.getTaille()) return m_table[numero].getChaine();
+  ostringstream temporaire; // temporaire de l'optimiseur : hors de la table, son nom n'est pas un identificateur
+  temporaire << "invariant" << numero - m_table.getTaille();
+  return temporaire.str();
+}
+
+string TraducteurCpp::variable(const Noeud* noeud) const {
+  return "v_" + nom(noeud);
+}
+
+string TraducteurCpp::definie(const Noeud* noeud) const {
+  return "d_" + nom(noeud);
+}
+
+void TraducteurCpp::ligne(const string & texte) {
+  m_code << string(2 * m_indentation, ' ') << texte << "\n";
+}
+
+string TraducteurCpp::temporaire() {
+  ostringstream nom;
+  nom << "t" << m_temporaires++;
+  return nom.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Programme
+////////////////////////////////////////////////////////////////////////////////
+
+void TraducteurCpp::traduire(const Noeud* racine, ostream & sortie) {
+  Definies definies(m_table.getTaille() + m_table.getNombreTemporaires(), false);
+  m_code.str("");
+  m_indentation = 2;
+  m_temporaires = 0;
+  m_lire = false;
+  instruction(racine, definies);
+
+  // les lignes de la table, dans l'ordre où operator<< les affiche
+  vector<unsigned int> ordre;
+  for (unsigned int i = 0; i < m_table.getTaille(); i++) ordre.push_back(i);
+  sort(ordre.begin(), ordre.end(), [&](unsigned int a, unsigned int b) {
+    return m_table[a].getChaine() < m_table[b].getChaine();
+  });
+  Arene arene;
+  TableSymboles vide(arene);
+  ostringstream entete; // le texte d'une table vide : l'en-tête, puis la ligne vide de fin
+  entete << endl << "================ Table des symboles apres exécution : " << vide;
+  string texteEntete = entete.str();
+  texteEntete.erase(texteEntete.size() - 1);
+
+  sortie << "// Programme produit par l'interpréteur (--emit-cpp) : ne pas modifier" << "\n"
+          << "#include <iostream>" << "\n"
+          << "#include <cstdio>" << "\n"
+          << "#include <cstring>" << "\n"
+          << "#include <vector>" << "\n"
+          << "#include <unistd.h>" << "\n"
+          << "using namespace std;" << "\n\n"
+          << "struct Erreur { const char* message; };" << "\n"
+          << "static void indefini() { throw Erreur{" << litteral(IndefiniException().what()) << "}; }" << "\n"
+          << "static void divParZero() { throw Erreur{" << litteral(DivParZeroException().what()) << "}; }" << "\n\n";
+  if (m_lire) // comme Entree::lire, sur l'entrée standard lue par blocs
+    sortie << "static vector<char> entree(1 << 16);" << "\n"
+            << "static size_t entreeDebut = 0, entreeFin = 0;" << "\n"
+            << "static bool entreeFinie = false;" << "\n"
+            << "static unsigned long long entreeDecalage = 0, entreeLigne = 1, entreeDebutLigne = 0;" << "\n"
+            << "static bool blanc(char c) { return c == ' ' || (unsigned char) (c - '\\t') <= '\\r' - '\\t'; }" << "\n"
+            << "static void recharger() {" << "\n"
+            << "  cout.flush();" << "\n"
+            << "  entreeDecalage += entreeDebut;" << "\n"
+            << "  memmove(entree.data(), entree.data() + entreeDebut, entreeFin - entreeDebut);" << "\n"
+            << "  entreeFin -= entreeDebut;" << "\n"
+            << "  entreeDebut = 0;" << "\n"
+            << "  if (entreeFin == entree.size()) entree.resize(2 * entree.size());" << "\n"
+            << "  ssize_t lus = read(0, entree.data() + entreeFin, entree.size() - entreeFin);" << "\n"
+            << "  if (lus <= 0) entreeFinie = true;" << "\n"
+            << "  else entreeFin += lus;" << "\n"
+            << "}" << "\n"
+            << "static void erreurEntree(const char* probleme, size_t position) {" << "\n"
+            << "  static char message[128];" << "\n"
+            << "  snprintf(message, sizeof(message), " << litteral(EntreeException::FORMAT)
+            << ", probleme, entreeLigne, entreeDecalage + position - entreeDebutLigne + 1);" << "\n"
+            << "  throw Erreur{message};" << "\n"
+            << "}" << "\n"
+            << "static int lire() {" << "\n"
+            << "  for (;;) {" << "\n"
+            << "    size_t i = entreeDebut;" << "\n"
+            << "    for (; i < entreeFin && blanc(entree[i]); i++)" << "\n"
+            << "      if (entree[i] == '\\n') { entreeLigne++; entreeDebutLigne = entreeDecalage + i + 1; }" << "\n"
+            << "    entreeDebut = i;" << "\n"
+            << "    if (i == entreeFin) {" << "\n"
+            << "      if (entreeFinie) erreurEntree(" << litteral(Entree::FIN_DONNEES) << ", i);" << "\n"
+            << "      recharger();" << "\n"
+            << "      continue;" << "\n"
+            << "    }" << "\n"
+            << "    bool negatif = entree[i] == '-';" << "\n"
+            << "    size_t j = i + (entree[i] == '-' || entree[i] == '+'), chiffres = j;" << "\n"
+            << "    unsigned long long n = 0;" << "\n"
+            << "    for (; j < entreeFin && (unsigned char) (entree[j] - '0') < 10; j++)" << "\n"
+            << "      if (n <= 2147483648ULL) n = 10 * n + (entree[j] - '0');" << "\n"
+            << "    if (j == entreeFin && !entreeFinie) {" << "\n"
+            << "      recharger();" << "\n"
+            << "      continue;" << "\n"
+            << "    }" << "\n"
+            << "    if (j == chiffres || (j < entreeFin && !blanc(entree[j]))) erreurEntree("
+            << litteral(Entree::ENTIER_ATTENDU) << ", i);" << "\n"
+            << "    if (n > (negatif ? 2147483648ULL : 2147483647ULL)) erreurEntree("
+            << litteral(Entree::ENTIER_TROP_GRAND) << ", i);" << "\n"
+            << "    entreeDebut = j;" << "\n"
+            << "    return negatif ? (int) (0u - (unsigned int) n) : (int) n;" << "\n"
+            << "  }" << "\n"
+            << "}" << "\n\n";
+  sortie << "int main() {" << "\n";
+  for (unsigned int i = 0; i < m_table.getTaille(); i++)
+    if (m_table[i] == "<VARIABLE>")
+      sortie << "  int v_" << m_table[i].getChaine() << " = 0; bool d_" << m_table[i].getChaine() << " = false;" << "\n";
+  for (unsigned int i = 0; i < m_table.getNombreTemporaires(); i++)
+    sortie << "  int " << variable(&m_table.getTemporaire(i)) << " = 0; bool " << definie(&m_table.getTemporaire(i))
+            << " = false;" << "\n";
+  sortie << "  try {" << "\n" << m_code.str()
+          << "  } catch (Erreur & e) {" << "\n"
+          << "    cout << e.message << endl;" << "\n"
+          << "    return 0;" << "\n"
+          << "  }" << "\n"
+          << "  cout << " << litteral(texteEntete) << ";" << "\n";
+  for (unsigned int i = 0; i < ordre.size(); i++) {
+    const SymboleValue & symbole = m_table[ordre[i]];
+    ostringstream debut;
+    debut << "  " << (Symbole) symbole << "\t\t - Valeur=";
+    if (symbole == "<VARIABLE>")
+      sortie << "  cout << " << litteral(debut.str()) << "; if (d_" << symbole.getChaine() << ") cout << v_"
+              << symbole.getChaine() << " << \" \"; else cout << \"indefinie \"; cout << endl;" << "\n";
+    else {
+      ostringstream texte;
+      texte << debut.str() << symbole.getValeur() << " ";
+      sortie << "  cout << " << litteral(texte.str()) << " << endl;" << "\n";
+    }
+  }
+  sortie << "  cout << endl;" << "\n"
+          << "  return 0;" << "\n"
+          << "}" << "\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Expressions
+////////////////////////////////////////////////////////////////////////////////
+
+string TraducteurCpp::expression(const Noeud* noeud, const Definies & definies) {
+  int valeur;
+  if (Optimiseur::estConstante(noeud, valeur)) return entier(valeur);
+  switch (noeud->getGenre()) {
+    case N_SYMBOLEVALUE:
+      if (!definies[((const SymboleValue*) noeud)->getNumero()]) ligne("if (!" + definie(noeud) + ") indefini();");
+      return variable(noeud);
+    case N_VARIABLESURE: // certainement définie : pas de test
+      return variable(((const NoeudVariableSure*) noeud)->getVariable());
+    case N_OPERATEURBINAIRE: case N_DIVISIONSURE: {
+      const NoeudOperateurBinaire* operation = (const NoeudOperateurBinaire*) noeud;
+      string g = expression(operation->getOperandeGauche(), definies);
+      if (operation->getOperateur() == J_ET || operation->getOperateur() == J_OU) { // l'opérande droit seulement si besoin
+        bool et = operation->getOperateur() == J_ET;
+        string resultat = temporaire();
+        ligne("int " + resultat + " = " + (et ? "0" : "1") + ";");
+        ligne("if (" + (et ? g : "!" + g) + ") {");
+        m_indentation++;
+        string d = expression(operation->getOperandeDroit(), definies);
+        ligne(resultat + " = " + d + " != 0;");
+        m_indentation--;
+        ligne("}");
+        return resultat;
+      }
+      string d = expression(operation->getOperandeDroit(), definies);
+      string calcul;
+      switch (operation->getOperateur()) { // + - * en non signé : le débordement "boucle", comme sur la machine
+        case J_PLUS:           calcul = "(int) ((unsigned int) " + g + " + (unsigned int) " + d + ")"; break;
+        case J_MOINS:          calcul = "(int) ((unsigned int) " + g + " - (unsigned int) " + d + ")"; break;
+        case J_MULTIPLICATION: calcul = "(int) ((unsigned int) " + g + " * (unsigned int) " + d + ")"; break;
+        case J_DIVISION:
+          if (noeud->getGenre() != N_DIVISIONSURE
+              && (!Optimiseur::estConstante(operation->getOperandeDroit(), valeur) || valeur == 0))
+            ligne("if (" + d + " == 0) divParZero();");
+          calcul = g + " / " + d;
+          break;
+        case J_EGAL:           calcul = g + " == " + d; break;
+        case J_DIFFERENT:      calcul = g + " != " + d; break;
+        case J_INFERIEUR:      calcul = g + " < " + d; break;
+        case J_INFERIEUREGAL:  calcul = g + " <= " + d; break;
+        case J_SUPERIEUR:      calcul = g + " > " + d; break;
+        case J_SUPERIEUREGAL:  calcul = g + " >= " + d; break;
+        default:               throw OperationInterditeException();
+      }
+      string resultat = temporaire();
+      ligne("const int " + resultat + " = " + calcul + ";");
+      return resultat;
+    }
+    case N_OPERATEURUNAIRE: {
+      const NoeudOperateurUnaire* operation = (const NoeudOperateurUnaire*) noeud;
+      string o = expression(operation->getOperande(), definies);
+      string resultat = temporaire();
+      if (operation->getOperateur() == J_MOINS) ligne("const int " + resultat + " = (int) (0u - (unsigned int) " + o + ");");
+      else ligne("const int " + resultat + " = !" + o + ";");
+      return resultat;
+    }
+    case N_INVARIANT: { // calculé seulement si la temporaire a été oubliée depuis le dernier calcul
+      const NoeudInvariant* invariant = (const NoeudInvariant*) noeud;
+      ligne("if (!" + definie(invariant->getTemporaire()) + ") {");
+      m_indentation++;
+      string valeur = expression(invariant->getExpression(), definies);
+      ligne(variable(invariant->getTemporaire()) + " = " + valeur + "; " + definie(invariant->getTemporaire()) + " = true;");
+      m_indentation--;
+      ligne("}");
+      return variable(invariant->getTemporaire());
+    }
+    default:
+      throw OperationInterditeException(); // pas une expression
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Instructions
+////////////////////////////////////////////////////////////////////////////////
+
+void TraducteurCpp::instruction(const Noeud* noeud, Definies & definies) {
+  switch (noeud->getGenre()) {
+    case N_SEQINST: {
+      const vector<Noeud*> & instructions = ((const NoeudSeqInst*) noeud)->getInstructions();
+      for (unsigned int i = 0; i < instructions.size(); i++) instruction(instructions[i], definies);
+      return;
+    }
+    case N_AFFECTATION: {
+      const NoeudAffectation* affectation = (const NoeudAffectation*) noeud;
+      string valeur = expression(affectation->getExpression(), definies);
+      ligne(variable(affectation->getVariable()) + " = " + valeur + "; " + definie(affectation->getVariable()) + " = true;");
+      definies[((const SymboleValue*) affectation->getVariable())->getNumero()] = true;
+      return;
+    }
+    case N_SI: { // après un si sans sinon, seules les variables définies avant le sont certainement
+      const NoeudInstSi* si = (const NoeudInstSi*) noeud;
+      ligne("if (" + expression(si->getCondition(), definies) + ") {");
+      Definies alors = definies;
+      m_indentation++;
+      instruction(si->getSequence(), alors);
+      m_indentation--;
+      ligne("}");
+      return;
+    }
+    case N_SIRICHE: { // avec un sinon : sont définies après les variables définies par toutes les branches
+      const NoeudInstSiRiche* siRiche = (const NoeudInstSiRiche*) noeud;
+      const vector<Noeud*> & conditions = siRiche->getConditions();
+      Definies apres(definies.size(), true);
+      bool sinon = false;
+      unsigned int accolades = 0;
+      for (unsigned int i = 0; i < conditions.size(); i++) {
+        Definies branche = definies;
+        if (conditions[i] == nullptr) {
+          sinon = true;
+          instruction(siRiche->getSequences()[i], branche);
+        } else {
+          ligne("if (" + expression(conditions[i], definies) + ") {");
+          m_indentation++;
+          instruction(siRiche->getSequences()[i], branche);
+          m_indentation--;
+          if (i + 1 < conditions.size()) {
+            ligne("} else {");
+            m_indentation++;
+            accolades++;
+          } else ligne("}");
+        }
+        for (unsigned int j = 0; j < apres.size(); j++) apres[j] = apres[j] && branche[j];
+      }
+      while (accolades-- > 0) {
+        m_indentation--;
+        ligne("}");
+      }
+      if (sinon) definies = apres;
+      return;
+    }
+    case N_AIGUILLAGE: { // un switch, dont le compilateur C++ fait lui-même une table de sauts ;
+                         //  sont définies après les variables définies par toutes les branches, default compris
+      const NoeudInstAiguillage* aiguillage = (const NoeudInstAiguillage*) noeud;
+      const vector<int> & valeurs = aiguillage->getValeurs();
+      ligne("switch (" + expression(aiguillage->getVariable(), definies) + ") {");
+      Definies apres(definies.size(), true);
+      for (unsigned int i = 0; i <= valeurs.size(); i++) {
+        if (i < valeurs.size() && aiguillage->choisir(valeurs[i]) != i) continue; // valeur en double : jamais choisie
+        Definies branche = definies;
+        ligne(i < valeurs.size() ? "case " + entier(valeurs[i]) + ": {" : string("default: {"));
+        m_indentation++;
+        if (i < valeurs.size()) instruction(aiguillage->getSequences()[i], branche);
+        else if (aiguillage->getSinon() != nullptr) instruction(aiguillage->getSinon(), branche);
+        ligne("break;");
+        m_indentation--;
+        ligne("}");
+        for (unsigned int j = 0; j < apres.size(); j++) apres[j] = apres[j] && branche[j];
+      }
+      ligne("}");
+      definies = apres;
+      return;
+    }
+    case N_TANTQUE: { // la séquence n'est peut-être jamais exécutée
+      const NoeudInstTantQue* tantQue = (const NoeudInstTantQue*) noeud;
+      ligne("for (;;) {");
+      m_indentation++;
+      ligne("if (!" + expression(tantQue->getCondition(), definies) + ") break;");
+      Definies corps = definies;
+      instruction(tantQue->getSequence(), corps);
+      m_indentation--;
+      ligne("}");
+      return;
+    }
+    case N_REPETER: { // comme NoeudInstRepeter : la condition est testée avant la séquence
+      const NoeudInstRepeter* repeter = (const NoeudInstRepeter*) noeud;
+      ligne("for (;;) {");
+      m_indentation++;
+      ligne("if (" + expression(repeter->getCondition(), definies) + ") break;");
+      Definies corps = definies;
+      instruction(repeter->getSequence(), corps);
+      m_indentation--;
+      ligne("}");
+      return;
+    }
+    case N_POUR: {
+      const NoeudInstPour* pour = (const NoeudInstPour*) noeud;
+      if (pour->getAffectation1() != nullptr) instruction(pour->getAffectation1(), definies);
+      ligne("for (;;) {");
+      m_indentation++;
+      ligne("if (!" + expression(pour->getCondition(), definies) + ") break;");
+      Definies corps = definies;
+      instruction(pour->getSequence(), corps);
+      if (pour->getAffectation2() != nullptr) instruction(pour->getAffectation2(), corps);
+      m_indentation--;
+      ligne("}");
+      return;
+    }
+    case N_LIRE: { // comme NoeudInstLire : lit la valeur de chaque variable (voir Entree)
+      const vector<Noeud*> & variables = ((const NoeudInstLire*) noeud)->getVariables();
+      for (unsigned int i = 0; i < variables.size(); i++) {
+        ligne(variable(variables[i]) + " = lire(); " + definie(variables[i]) + " = true;");
+        definies[((const SymboleValue*) variables[i])->getNumero()] = true;
+      }
+      m_lire = true;
+      return;
+    }
+    case N_OUBLIER: {
+      const vector<Noeud*> & temporaires = ((const NoeudInstOublier*) noeud)->getTemporaires();
+      for (unsigned int i = 0; i < temporaires.size(); i++) ligne(definie(temporaires[i]) + " = false;");
+      return;
+    }
+    case N_ECRIRE: {
+      const vector<Noeud*> & parametres = ((const NoeudInstEcrire*) noeud)->getParametres();
+      for (unsigned int i = 0; i < parametres.size(); i++) {
+        if (parametres[i]->getGenre() == N_CHAINE)
+          ligne("cout << " + litteral(((const NoeudChaine*) parametres[i])->getChaine()) + " << '\\n';");
+        else ligne("cout << " + expression(parametres[i], definies) + " << '\\n';");
+      }
+      return;
+    }
+    default:
+      throw OperationInterditeException(); // pas une instruction
+  }
+}
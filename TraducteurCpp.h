@@ -0,0 +1,50 @@
+#ifndef TRADUCTEURCPP_H
+#define TRADUCTEURCPP_H
+
+// Traducteur C++ : écrit un programme C++ autonome (une seule unité de traduction, sans dépendance)
+// qui fait la même chose que l'arbre abstrait d'un programme, pour le compiler une fois pour toutes.
+// Chaque instruction devient la structure de contrôle C++ correspondante et chaque variable de la
+// table des symboles une variable locale. Le programme produit écrit ce qu'écrirait l'exécution de
+// l'arbre, suivi de la table des symboles après exécution (ou du message de l'exception levée).
+// Une analyse des variables certainement définies en chaque point du programme supprime les tests
+// "variable indéfinie" inutiles ; le test de division par 0 est supprimé quand le diviseur est une
+// constante non nulle (et aucun test n'est écrit pour les NoeudVariableSure et NoeudDivisionSure). Les opérandes sont évalués de gauche à droite, comme par l'arbre (l'opérande droit
+// de et/ou seulement si le gauche ne suffit pas). lire lit l'entrée standard comme Entree, par blocs.
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "ArbreAbstrait.h"
+#include "TableSymboles.h"
+
+class TraducteurCpp {
+public:
+    TraducteurCpp(const TableSymboles & table); // Construit un traducteur pour les programmes dont la table est table
+    void traduire(const Noeud* racine, ostream & sortie); // Ecrit sur sortie le programme C++ de l'arbre racine
+
+    static string litteral(const string & chaine); // Littéral C++ (entre guillemets) dont la valeur est chaine
+
+private:
+    typedef vector<bool> Definies; // Pour chaque emplacement : vrai si la variable est certainement définie
+
+    void instruction(const Noeud* noeud, Definies & definies);
+    // Traduit l'instruction noeud ; definies (avant noeud) est mis à jour pour après noeud
+    string expression(const Noeud* noeud, const Definies & definies);
+    // Traduit le calcul de l'expression noeud, renvoie l'expression C++ de son résultat
+    string nom(const Noeud* noeud) const;      // Nom d'une variable (SymboleValue) ou d'une temporaire de l'optimiseur
+    string variable(const Noeud* noeud) const; // Nom C++ de la valeur d'une variable (SymboleValue)
+    string definie(const Noeud* noeud) const;  // Nom C++ de l'indicateur "définie" d'une variable
+    void ligne(const string & texte);          // Ecrit une ligne de code, indentée
+    string temporaire();                       // Nom d'une nouvelle variable temporaire
+
+    const TableSymboles & m_table;
+    ostringstream        m_code;
+    unsigned int         m_indentation;
+    unsigned int         m_temporaires;
+    bool                 m_lire;        // Vrai si le programme a un lire : le programme produit a besoin de lire()
+};
+
+#endif /* TRADUCTEURCPP_H */
@@ -1,29 +1,266 @@
 #include <iostream>
+#include <string.h>
 using namespace std;
 #include "Interpreteur.h"
+#include "ArbreAplati.h"
+#include "MachineVirtuelle.h"
+#include "CodeNatif.h"
+#include "TraducteurCpp.h"
+#include "CacheProgrammes.h"
+#include "ResultatsMemorises.h"
+#include "Sortie.h"
+#include "Entree.h"
+#include <stdlib.h>
+#include <fstream>
+#include <algorithm>
+#include <pthread.h>
 #include "Exceptions.h"
+#include "ComparateurLecteurs.h"
+#include <unistd.h>
 
-int main(int argc, char* argv[]) {
+// Exécute bytecode par le code natif si jit, sinon par la machine virtuelle
+static void executer(const Bytecode & bytecode, vector<Emplacement> & emplacements, bool jit) {
+  if (jit) CodeNatif(bytecode).executer(emplacements);
+  else MachineVirtuelle(bytecode, emplacements).executer();
+}
+
+struct Options {
   string nomFich;
-  if (argc != 2) {
-    cout << "Usage : " << argv[0] << " nom_fichier_source" << endl << endl;
-    cout << "Entrez le nom du fichier que voulez-vous interpréter : ";
-    getline(cin, nomFich);
-  } else
-    nomFich = argv[1];
-  ifstream fichier(nomFich.c_str());
+  bool aplati = false;    // --aplati : exécuter l'arbre aplati plutôt que l'arbre de pointeurs
+  bool vm = false;        // --vm : traduire l'arbre en bytecode et l'exécuter par la machine virtuelle
+  bool jit = false;       // --jit : traduire le bytecode en code machine et l'exécuter (x86-64 seulement)
+  bool sansNatif = false; //   --jit demandé, mais pas de code natif sur cette machine : vm à la place
+  string fichierCpp;      // --emit-cpp fichier.cpp : écrire le programme traduit en C++ au lieu de l'exécuter
+  bool optimiser = true;  // --sans-optimisation : exécuter l'arbre tel que l'analyse l'a construit
+  string repertoireCache; // --cache repertoire : garder le bytecode des programmes pour ne plus les analyser
+  unsigned long long tailleMaxCache = 64ULL << 20; // --cache-max mio : taille totale de ces programmes
+  string repertoireResultats; // --memoriser repertoire : garder ce qu'écrivent les programmes sans lire
+  unsigned long long tailleMaxResultats = 64ULL << 20; // --memoriser-max mio : taille totale de ces résultats
+  unsigned int profondeurMax = Interpreteur::PROFONDEUR_MAX; // --profondeur-max n : niveaux d'imbrication acceptés
+  bool flux = false;      // --flux : exécuter chaque instruction dès qu'elle est analysée, sans garder l'arbre
+                          //   (sans effet avec --emit-cpp ; --cache n'est pas utilisé)
+  bool ecritureParallele = false; // --ecriture-parallele : envoyer ce qu'écrit le programme par un autre fil (voir Sortie)
+  string fichierEntree;   // --entree fichier : les données de lire, au lieu de l'entrée standard (voir Entree)
+  bool comparerLecteurs = false;   // --comparer-lecteurs n : comparer les façons de découper le fichier en symboles
+  unsigned int textesAleatoires = 0; //   puis n textes aléatoires (voir ComparateurLecteurs), sans rien exécuter
+};
+
+// Exécute l'arbre arbre, dont les symboles sont ceux de table, par l'exécuteur choisi dans options
+static void executer(Noeud* arbre, TableSymboles & table, const Options & options) {
+  if (options.vm || options.jit) executer(Bytecode(arbre), table.getEmplacements(), options.jit);
+  else if (options.aplati) ArbreAplati(arbre, table.getEmplacements()).executer();
+  else arbre->executer();
+}
+
+// Pile du fil qui analyse et exécute le programme : les passes qui parcourent l'arbre abstrait (analyse de flot,
+// optimiseur, exécuteurs, traduction) sont récursives, et l'un de leurs appels prend au plus OCTETS_PAR_NIVEAU
+// octets (mesuré : environ 1,3 kio par bloc imbriqué, moins par opérateur). L'analyse limite la profondeur de l'arbre
+static const size_t OCTETS_PAR_NIVEAU = 4096;
+static const size_t TAILLE_PILE_MIN = 8 << 20;
+
+// Analyse et exécute le programme du fichier options.nomFich ; renvoie vrai si tout ce qui a été écrit
+// ne dépend que du texte du programme (l'analyse a réussi et le programme n'a pas de lire)
+static bool lancer(const Options & options) {
+  bool deterministe = false;
   try {
-    Interpreteur interpreteur(fichier);
+    if (!options.repertoireCache.empty() && options.fichierCpp.empty()) {
+      // Programme déjà dans le cache : on exécute son bytecode sans analyser le source (quel que soit l'exécuteur demandé)
+      ProgrammeCompile programme;
+      CacheProgrammes cache(options.repertoireCache, options.optimiser, options.profondeurMax, options.tailleMaxCache);
+      if (cache.charger(TamponSource(options.nomFich), programme)) {
+        deterministe = !programme.getBytecode().contient(Bytecode::LIRE);
+        cout << endl << "================ Syntaxe Correcte" << endl;
+        cout << endl << "================ Table des symboles avant exécution : " << programme.getTable();
+        cout << endl << "================ Execution de l'arbre" << endl;
+        if (options.sansNatif) cout << "Pas de code natif sur cette machine : exécution par la machine virtuelle" << endl;
+        executer(programme.getBytecode(), programme.getTable().getEmplacements(), options.jit);
+        Sortie::vider(); // ce qu'a écrit le programme, avant la table
+        cout << endl << "================ Table des symboles apres exécution : " << programme.getTable();
+        return deterministe;
+      }
+    }
+    Interpreteur interpreteur(options.nomFich);
+    interpreteur.setProfondeurMax(options.profondeurMax);
     interpreteur.analyse();
+    if (options.optimiser) interpreteur.optimiser();
     // Si pas d'exception levée, l'analyse syntaxique a réussi
     cout << endl << "================ Syntaxe Correcte" << endl;
     // On affiche le contenu de la table des symboles avant d'exécuter le programme
     cout << endl << "================ Table des symboles avant exécution : " << interpreteur.getTable();
+    if (!options.fichierCpp.empty()) {
+      ofstream sortie(options.fichierCpp.c_str());
+      if (!sortie) throw FichierException();
+      TraducteurCpp(interpreteur.getTable()).traduire(interpreteur.getArbre(), sortie);
+      cout << endl << "================ Programme C++ écrit dans " << options.fichierCpp << endl;
+      return false;
+    }
+    deterministe = interpreteur.estDeterministe();
     cout << endl << "================ Execution de l'arbre" << endl;
     // On exécute le programme si l'arbre n'est pas vide
-    if (interpreteur.getArbre()!=nullptr) interpreteur.getArbre()->executer();
+    if (interpreteur.getArbre()!=nullptr) {
+      // Un programme dont des instructions incorrectes ont été sautées, ou des lectures indéfinies signalées,
+      //  n'est pas gardé : l'analyse doit les signaler à chaque exécution
+      if (!options.repertoireCache.empty() && interpreteur.getNombreErreurs() == 0
+          && interpreteur.getNombreAvertissements() == 0)
+        CacheProgrammes(options.repertoireCache, options.optimiser, options.profondeurMax, options.tailleMaxCache)
+            .enregistrer(interpreteur.getSource(), interpreteur.getTable(), Bytecode(interpreteur.getArbre()));
+      if (options.sansNatif) cout << "Pas de code natif sur cette machine : exécution par la machine virtuelle" << endl;
+      executer(interpreteur.getArbre(), interpreteur.getTable(), options);
+    }
     // Et on vérifie qu'il a fonctionné en regardant comment il a modifié la table des symboles
+    Sortie::vider();
     cout << endl << "================ Table des symboles apres exécution : " << interpreteur.getTable();
+  } catch (InterpreteurException & e) {
+    Sortie::vider(); // ce qu'a écrit le programme avant l'exception
+    cout << e.what() << endl;
+  }
+  return deterministe;
+}
+
+// Comme lancer, en mode flux (voir Interpreteur::commencerFlux) : la syntaxe n'est connue correcte qu'à la fin,
+// et la table des symboles n'est affichée qu'après l'exécution
+static bool lancerParFlux(const Options & options) {
+  try {
+    Interpreteur interpreteur(options.nomFich, true);
+    interpreteur.setProfondeurMax(options.profondeurMax);
+    cout << endl << "================ Execution au fil de l'analyse" << endl;
+    if (options.sansNatif) cout << "Pas de code natif sur cette machine : exécution par la machine virtuelle" << endl;
+    interpreteur.commencerFlux();
+    while (Noeud* instruction = interpreteur.instructionSuivante()) {
+      if (options.optimiser) instruction = interpreteur.optimiser(instruction);
+      if (instruction == nullptr) continue;
+      // une instruction sans boucle n'est exécutée qu'une fois : la traduire pour un autre exécuteur coûterait plus
+      //  que de l'exécuter directement
+      GenreNoeud genre = instruction->getGenre();
+      if (genre == N_TANTQUE || genre == N_REPETER || genre == N_POUR) executer(instruction, interpreteur.getTable(), options);
+      else instruction->executer();
+    }
+    Sortie::vider();
+    cout << endl << "================ Syntaxe Correcte" << endl;
+    cout << endl << "================ Table des symboles apres exécution : " << interpreteur.getTable();
+    return interpreteur.estDeterministe();
+  } catch (InterpreteurException & e) {
+    Sortie::vider();
+    cout << e.what() << endl;
+  }
+  return false;
+}
+
+// Exécute lancer(options) (lancerParFlux en mode flux) sur un fil dont la pile suffit à un arbre de options.profondeurMax niveaux
+// (sur le fil principal si ce fil ne peut pas être créé)
+static bool lancerSurPile(const Options & options) {
+  struct Appel {
+    const Options* options;
+    bool           resultat;
+    static void* executer(void* appel) {
+      const Options & options = *((Appel*) appel)->options;
+      ((Appel*) appel)->resultat = options.flux && options.fichierCpp.empty() ? lancerParFlux(options) : lancer(options);
+      return nullptr;
+    }
+  } appel = { &options, false };
+  Sortie::setFilEcriture(options.ecritureParallele);
+  pthread_attr_t attributs;
+  pthread_attr_init(&attributs);
+  pthread_t fil;
+  if (pthread_attr_setstacksize(&attributs, max(TAILLE_PILE_MIN, options.profondeurMax * OCTETS_PAR_NIVEAU)) == 0
+      && pthread_create(&fil, &attributs, &Appel::executer, &appel) == 0)
+    pthread_join(fil, nullptr);
+  else Appel::executer(&appel);
+  pthread_attr_destroy(&attributs);
+  Sortie::setFilEcriture(false);
+  return appel.resultat;
+}
+
+// Compare les façons de découper en symboles (voir ComparateurLecteurs) le fichier options.nomFich, puis
+// options.textesAleatoires textes aléatoires : un sur quatre est assez gros pour être découpé par plusieurs fils
+static bool comparerLecteurs(const Options & options) {
+  bool identiques = true;
+  try {
+    identiques = ComparateurLecteurs::comparer(options.nomFich, cout);
+  } catch (FichierException & e) {
+    cout << options.nomFich << " : " << e.what() << endl;
+    return false;
+  }
+  char nomTexte[] = "/tmp/lecteursXXXXXX";
+  int descripteur = options.textesAleatoires > 0 ? mkstemp(nomTexte) : -1;
+  if (options.textesAleatoires > 0 && descripteur < 0) {
+    cout << FichierException().what() << endl;
+    return false;
+  }
+  for (unsigned int graine = 1; graine <= options.textesAleatoires; graine++) {
+    ofstream(nomTexte, ios::binary | ios::trunc)
+        << ComparateurLecteurs::texteAleatoire(graine, graine % 4 == 0 ? 3 << 20 : graine * 37 % 4096);
+    if (!ComparateurLecteurs::comparer(nomTexte, cout)) {
+      cout << "  (texte aléatoire " << graine << ")" << endl;
+      identiques = false;
+    }
+  }
+  if (descripteur >= 0) {
+    close(descripteur);
+    unlink(nomTexte);
+  }
+  cout << options.nomFich << (options.textesAleatoires > 0 ? " et textes aléatoires" : "")
+       << (identiques ? " : symboles identiques" : " : symboles différents") << endl;
+  return identiques;
+}
+
+int main(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--aplati") == 0) options.aplati = true;
+    else if (strcmp(argv[i], "--vm") == 0) options.vm = true;
+    else if (strcmp(argv[i], "--jit") == 0) options.jit = true;
+    else if (strcmp(argv[i], "--emit-cpp") == 0 && i + 1 < argc) options.fichierCpp = argv[++i];
+    else if (strcmp(argv[i], "--sans-optimisation") == 0) options.optimiser = false;
+    else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) options.repertoireCache = argv[++i];
+    else if (strcmp(argv[i], "--cache-max") == 0 && i + 1 < argc) options.tailleMaxCache = atoll(argv[++i]) << 20;
+    else if (strcmp(argv[i], "--memoriser") == 0 && i + 1 < argc) options.repertoireResultats = argv[++i];
+    else if (strcmp(argv[i], "--memoriser-max") == 0 && i + 1 < argc) options.tailleMaxResultats = atoll(argv[++i]) << 20;
+    else if (strcmp(argv[i], "--profondeur-max") == 0 && i + 1 < argc) options.profondeurMax = max(1, atoi(argv[++i]));
+    else if (strcmp(argv[i], "--flux") == 0) options.flux = true;
+    else if (strcmp(argv[i], "--ecriture-parallele") == 0) options.ecritureParallele = true;
+    else if (strcmp(argv[i], "--entree") == 0 && i + 1 < argc) options.fichierEntree = argv[++i];
+    else if (strcmp(argv[i], "--comparer-lecteurs") == 0 && i + 1 < argc) {
+      options.comparerLecteurs = true;
+      options.textesAleatoires = atoi(argv[++i]);
+    }
+    else options.nomFich = argv[i];
+  }
+  if (options.nomFich.empty()) {
+    cout << "Usage : " << argv[0] << " [--aplati | --vm | --jit] [--emit-cpp fichier.cpp] [--sans-optimisation]"
+            " [--cache repertoire [--cache-max mio]] [--memoriser repertoire [--memoriser-max mio]] [--profondeur-max n] [--flux]"
+            " [--ecriture-parallele] [--entree fichier]"
+            " [--comparer-lecteurs n] nom_fichier_source" << endl << endl;
+    cout << "Entrez le nom du fichier que voulez-vous interpréter : ";
+    getline(cin, options.nomFich);
+  }
+  if (options.comparerLecteurs) return comparerLecteurs(options) ? 0 : 1;
+  if (!options.fichierEntree.empty()) {
+    try {
+      Entree::ouvrir(options.fichierEntree);
+    } catch (FichierException & e) {
+      cout << e.what() << endl;
+      return 0;
+    }
+  }
+  if (options.jit && !CodeNatif::estDisponible()) {
+    options.sansNatif = true;
+    options.jit = false;
+    options.vm = true;
+  }
+  if (options.repertoireResultats.empty() || !options.fichierCpp.empty()) {
+    lancerSurPile(options);
+    return 0;
+  }
+  try { // on rejoue le résultat mémorisé, ou on exécute le programme en gardant ce qu'il écrit
+    ResultatsMemorises resultats(options.repertoireResultats, options.optimiser, options.flux, options.profondeurMax,
+                                 options.tailleMaxResultats);
+    TamponSource source(options.nomFich);
+    if (resultats.rejouer(source, cout)) return 0;
+    CaptureSortie capture(cout, options.tailleMaxResultats);
+    bool deterministe = lancerSurPile(options);
+    cout.flush(); // tout le texte est passé par la capture
+    if (deterministe && capture.estComplet()) resultats.enregistrer(source, capture.getTexte());
   } catch (InterpreteurException & e) {
     cout << e.what() << endl;
   }